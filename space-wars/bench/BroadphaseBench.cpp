@@ -0,0 +1,123 @@
+// Broadphase benchmark: brute-force projectile/spacecraft tests vs. the uniform grid
+// Usage: SpaceWarsBench [iterations]
+
+#include "Constants.h"
+#include "SpatialGrid.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Scenario {
+    std::vector<sf::Vector2f> projectiles;
+    std::vector<sf::Vector2f> spacecraft;
+};
+
+//----------------------------------------------------------------------------------------
+Scenario makeScenario(std::size_t projectileCount, std::size_t spacecraftCount, std::mt19937& rng) 
+{
+    std::uniform_real_distribution<float> x(0.0f, static_cast<float>(Constants::WINDOW_WIDTH));
+    std::uniform_real_distribution<float> y(0.0f, static_cast<float>(Constants::WINDOW_HEIGHT));
+    
+    Scenario scenario;
+    for (std::size_t i = 0; i < projectileCount; ++i) {
+        scenario.projectiles.emplace_back(x(rng), y(rng));
+    }
+    for (std::size_t i = 0; i < spacecraftCount; ++i) {
+        scenario.spacecraft.emplace_back(x(rng), y(rng));
+    }
+    return scenario;
+}
+
+//----------------------------------------------------------------------------------------
+std::size_t bruteForce(const Scenario& scenario, float hitDistanceSquared) 
+{
+    std::size_t hits = 0;
+    for (const sf::Vector2f& p : scenario.projectiles) {
+        for (const sf::Vector2f& s : scenario.spacecraft) {
+            float dx = p.x - s.x;
+            float dy = p.y - s.y;
+            hits += (dx * dx + dy * dy < hitDistanceSquared) ? 1 : 0;
+        }
+    }
+    return hits;
+}
+
+//----------------------------------------------------------------------------------------
+std::size_t gridQuery(const Scenario& scenario, SpatialGrid& grid, float hitDistance) 
+{
+    // Rebuild the grid every tick, as the simulation does
+    grid.begin();
+    for (std::size_t i = 0; i < scenario.projectiles.size(); ++i) {
+        grid.insert(scenario.projectiles[i], static_cast<std::uint32_t>(i), SpatialGrid::EntityType::Projectile, 1);
+    }
+    grid.finish();
+    
+    float hitDistanceSquared = hitDistance * hitDistance;
+    std::size_t hits = 0;
+    for (const sf::Vector2f& s : scenario.spacecraft) {
+        grid.forEachCandidate(s, hitDistance, [&](const SpatialGrid::Entry& entry) {
+            float dx = entry.x - s.x;
+            float dy = entry.y - s.y;
+            hits += (dx * dx + dy * dy < hitDistanceSquared) ? 1 : 0;
+        });
+    }
+    return hits;
+}
+
+//----------------------------------------------------------------------------------------
+template <typename Function>
+double microsecondsPerTick(int iterations, Function&& function, std::size_t& result) 
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        result = function();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+int main(int argc, char* argv[]) 
+{
+    int iterations = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 200;
+    
+    std::mt19937 rng(12345);
+    SpatialGrid grid(static_cast<float>(Constants::WINDOW_WIDTH), static_cast<float>(Constants::WINDOW_HEIGHT));
+    constexpr float hitDistance = Constants::SPACECRAFT_SIZE + Constants::PROJECTILE_SIZE;
+    
+    std::cout << "Broadphase benchmark (" << iterations << " ticks per case, microseconds per tick)\n";
+    std::cout << std::setw(12) << "projectiles" << std::setw(12) << "spacecraft"
+              << std::setw(14) << "brute force" << std::setw(12) << "grid"
+              << std::setw(8) << "hits" << "\n";
+    
+    for (std::size_t projectileCount : {1000u, 10000u, 50000u, 100000u}) {
+        for (std::size_t spacecraftCount : {2u, 64u}) {
+            Scenario scenario = makeScenario(projectileCount, spacecraftCount, rng);
+            
+            std::size_t bruteHits = 0;
+            std::size_t gridHits = 0;
+            double bruteTime = microsecondsPerTick(iterations, [&] {
+                return bruteForce(scenario, hitDistance * hitDistance);
+            }, bruteHits);
+            double gridTime = microsecondsPerTick(iterations, [&] {
+                return gridQuery(scenario, grid, hitDistance);
+            }, gridHits);
+            
+            std::cout << std::setw(12) << projectileCount << std::setw(12) << spacecraftCount
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(14) << bruteTime << std::setw(12) << gridTime
+                      << std::setw(8) << gridHits
+                      << (bruteHits == gridHits ? "" : "  MISMATCH") << "\n";
+        }
+    }
+    
+    return 0;
+}
@@ -0,0 +1,117 @@
+// SIMD kernel benchmark: projectile integration and overlap tests per instruction set
+// Usage: SpaceWarsKernelBench [iterations]
+
+#include "Constants.h"
+#include "SimdKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct ProjectileArrays {
+    std::vector<float> x, y, vx, vy;
+    std::vector<std::uint8_t> active;
+};
+
+//----------------------------------------------------------------------------------------
+ProjectileArrays makeProjectiles(std::size_t count) 
+{
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> px(0.0f, static_cast<float>(Constants::WINDOW_WIDTH));
+    std::uniform_real_distribution<float> py(0.0f, static_cast<float>(Constants::WINDOW_HEIGHT));
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    
+    ProjectileArrays arrays;
+    for (std::size_t i = 0; i < count; ++i) {
+        float a = angle(rng);
+        arrays.x.push_back(px(rng));
+        arrays.y.push_back(py(rng));
+        arrays.vx.push_back(std::cos(a) * Constants::PROJECTILE_SPEED);
+        arrays.vy.push_back(std::sin(a) * Constants::PROJECTILE_SPEED);
+        arrays.active.push_back(1);
+    }
+    return arrays;
+}
+
+//----------------------------------------------------------------------------------------
+template <typename Function>
+double microsecondsPerCall(int iterations, Function&& function) 
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        function();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / iterations;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+int main(int argc, char* argv[]) 
+{
+    int iterations = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 1000;
+    const float dt = 1.0f / 60.0f;
+    const float width = static_cast<float>(Constants::WINDOW_WIDTH);
+    const float height = static_cast<float>(Constants::WINDOW_HEIGHT);
+    
+    const SimdKernels::InstructionSet sets[] = {
+        SimdKernels::InstructionSet::Scalar,
+        SimdKernels::InstructionSet::SSE2,
+        SimdKernels::InstructionSet::AVX2
+    };
+    const SimdKernels::InstructionSet best = SimdKernels::getInstructionSet();
+    
+    std::cout << "Kernel benchmark (" << iterations << " calls per case, microseconds per call)\n";
+    std::cout << "Runtime selection: " << SimdKernels::getInstructionSetName() << "\n";
+    std::cout << std::setw(12) << "projectiles" << std::setw(10) << "isa"
+              << std::setw(12) << "integrate" << std::setw(12) << "overlap" << "\n";
+    
+    for (std::size_t count : {1000u, 10000u, 100000u}) {
+        const ProjectileArrays initial = makeProjectiles(count);
+        std::vector<float> targetX(count, width / 2.0f);
+        std::vector<float> targetY(count, height / 2.0f);
+        std::vector<std::uint8_t> hits(count);
+        ProjectileArrays reference;
+        
+        for (SimdKernels::InstructionSet set : sets) {
+            if (!SimdKernels::setInstructionSet(set)) {
+                continue;  // Not supported by this CPU
+            }
+            
+            // Correctness: one step must match the scalar result exactly
+            ProjectileArrays once = initial;
+            SimdKernels::integrateProjectiles(once.x.data(), once.y.data(), once.vx.data(), once.vy.data(),
+                                              once.active.data(), count, dt, width, height);
+            if (set == SimdKernels::InstructionSet::Scalar) {
+                reference = once;
+            }
+            bool matches = once.x == reference.x && once.y == reference.y && once.active == reference.active;
+            
+            ProjectileArrays arrays = initial;
+            double integrateTime = microsecondsPerCall(iterations, [&] {
+                SimdKernels::integrateProjectiles(arrays.x.data(), arrays.y.data(), arrays.vx.data(), arrays.vy.data(),
+                                                  arrays.active.data(), count, dt, width, height);
+            });
+            double overlapTime = microsecondsPerCall(iterations, [&] {
+                SimdKernels::overlapMask(initial.x.data(), initial.y.data(), targetX.data(), targetY.data(),
+                                         400.0f, hits.data(), count);
+            });
+            
+            std::cout << std::setw(12) << count << std::setw(10) << SimdKernels::getInstructionSetName()
+                      << std::fixed << std::setprecision(2)
+                      << std::setw(12) << integrateTime << std::setw(12) << overlapTime
+                      << (matches ? "" : "  MISMATCH") << "\n";
+        }
+    }
+    
+    SimdKernels::setInstructionSet(best);
+    return 0;
+}
@@ -0,0 +1,269 @@
+// Netcode benchmark: how closely a peer's replica follows what the sender simulates
+// Projectiles: one simulation fires, its ProjectileSpawn events reach a second simulation a
+// few ticks late, through the wire encoding; the replica recreates each projectile moved
+// forward by its age. Reported are the event size and the largest distance between a
+// projectile and its replica, and how many were missing once their event was due: at the
+// screen edge (the replica, a fraction of a pixel ahead, has just left) or anywhere else.
+// Remote spacecraft: a scripted spacecraft's states are sent at 30 and 20 Hz over a link
+// with 30-60 ms latency and some loss, into an InterpolationBuffer with the default delay
+// and extrapolation limit. Reported are the distance between the shown spacecraft and the
+// true one as it was that delay and the average latency ago, the largest move between two
+// ticks, and that move when each state is snapped to on arrival and moved on locally.
+// Usage: SpaceWarsNetcodeBench [ticks]
+
+#include "Constants.h"
+#include "GameEvent.h"
+#include "InterpolationBuffer.h"
+#include "Simulation.h"
+#include "Spacecraft.h"
+#include "WireFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct InFlight {
+    int deliverAt;
+    std::vector<std::uint8_t> message;
+};
+
+struct StateInFlight {
+    double arrivesAt;
+    double sentAt;
+    Spacecraft spacecraft;
+};
+
+//----------------------------------------------------------------------------------------
+PlayerInput scriptedInput(int tick) 
+{
+    // Flies loops across the screen and fires every few ticks, like a player would
+    PlayerInput input;
+    input.thrust = (tick % 200) < 50;
+    input.left = (tick % 90) < 20;
+    input.fire = tick % 7 == 0;
+    return input;
+}
+
+//----------------------------------------------------------------------------------------
+bool nearScreenEdge(sf::Vector2f position) 
+{
+    const float margin = 1.0f;
+    return position.x < margin || position.y < margin ||
+           position.x > static_cast<float>(Constants::WINDOW_WIDTH) - margin ||
+           position.y > static_cast<float>(Constants::WINDOW_HEIGHT) - margin;
+}
+
+//----------------------------------------------------------------------------------------
+void benchProjectiles(int ticks) 
+{
+    const float dt = 1.0f / 60.0f;
+    
+    std::cout << "Projectile replication (" << ticks << " ticks, one shooter)\n";
+    std::cout << std::setw(8) << "delay" << std::setw(8) << "shots" << std::setw(14) << "bytes/shot"
+              << std::setw(12) << "max px" << std::setw(10) << "at edge" << std::setw(10) << "missing" << "\n";
+    
+    for (int delay : {1, 3, 6}) {
+        Simulation sender(3);
+        Simulation replica(3);
+        sender.setPlayerControlled(2, false);
+        replica.setPlayerControlled(1, false);
+        replica.setPlayerControlled(2, false);
+        
+        std::vector<InFlight> inFlight;
+        std::vector<std::uint8_t> buffer;
+        std::uint64_t shots = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t atEdge = 0;
+        std::uint64_t missing = 0;
+        double maxDistance = 0.0;
+        
+        for (int tick = 0; tick < ticks; ++tick) {
+            sender.step({scriptedInput(tick), PlayerInput()}, dt);
+            replica.step({PlayerInput(), PlayerInput()}, dt);
+            
+            for (const SpawnEvent& spawn : sender.getSpawnEvents()) {
+                GameEvent event;
+                event.type = GameEvent::Type::ProjectileSpawn;
+                event.shooterId = static_cast<std::uint8_t>(spawn.ownerPlayerId);
+                event.projectileId = spawn.projectileId;
+                event.timeMs = static_cast<std::uint32_t>(std::llround(spawn.time * 1000.0));
+                event.position = spawn.origin;
+                event.orientation = spawn.orientation;
+                WireFormat::encodeGameEvent(event, static_cast<std::uint32_t>(tick), buffer);
+                inFlight.push_back({tick + delay, buffer});
+                shots++;
+                bytes += buffer.size();
+            }
+            
+            // Both simulations run in step, so the replica knows the sender's time exactly:
+            // what remains is the wire rounding of the spawn
+            auto arrived = std::stable_partition(inFlight.begin(), inFlight.end(),
+                                                 [tick](const InFlight& message) { return message.deliverAt <= tick; });
+            for (auto it = inFlight.begin(); it != arrived; ++it) {
+                GameEvent event;
+                if (!WireFormat::decodeGameEvent(it->message.data(), it->message.size(), event)) {
+                    continue;
+                }
+                SpawnEvent spawn{event.projectileId, event.shooterId, event.position, event.orientation,
+                                 event.timeMs / 1000.0};
+                replica.spawnProjectile(spawn, static_cast<float>(replica.getGameState().getTime() - spawn.time));
+            }
+            inFlight.erase(inFlight.begin(), arrived);
+            
+            // Every projectile whose event has arrived must have a replica where it is
+            const ProjectilePool& original = sender.getGameState().getProjectiles();
+            const ProjectilePool& replicated = replica.getGameState().getProjectiles();
+            for (std::size_t i = 0; i < original.size(); ++i) {
+                std::size_t index = replicated.find(original.getId(i));
+                if (index != ProjectilePool::NOT_FOUND) {
+                    sf::Vector2f offset = original.getPosition(i) - replicated.getPosition(index);
+                    maxDistance = std::max(maxDistance, static_cast<double>(std::hypot(offset.x, offset.y)));
+                    continue;
+                }
+                bool pending = std::any_of(inFlight.begin(), inFlight.end(), [&](const InFlight& message) {
+                    GameEvent event;
+                    return WireFormat::decodeGameEvent(message.message.data(), message.message.size(), event) &&
+                           event.projectileId == original.getId(i);
+                });
+                if (pending) {
+                    continue;
+                }
+                if (nearScreenEdge(original.getPosition(i))) {
+                    atEdge++;
+                } else {
+                    missing++;
+                }
+            }
+        }
+        
+        std::cout << std::setw(8) << delay << std::setw(8) << shots << std::fixed << std::setprecision(2)
+                  << std::setw(14) << (shots ? static_cast<double>(bytes) / shots : 0.0)
+                  << std::setw(12) << maxDistance << std::setw(10) << atEdge << std::setw(10) << missing << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------------------
+float wrappedDistance(sf::Vector2f a, sf::Vector2f b) 
+{
+    // The spacecraft wraps around the screen: the short way across an edge counts
+    const float width = static_cast<float>(Constants::WINDOW_WIDTH);
+    const float height = static_cast<float>(Constants::WINDOW_HEIGHT);
+    float dx = std::abs(a.x - b.x);
+    float dy = std::abs(a.y - b.y);
+    dx = std::min(dx, width - dx);
+    dy = std::min(dy, height - dy);
+    return std::hypot(dx, dy);
+}
+
+//----------------------------------------------------------------------------------------
+void benchInterpolation(int ticks) 
+{
+    const float dt = 1.0f / 60.0f;
+    const double minLatency = 0.03;
+    const double maxLatency = 0.06;
+    const int warmup = 120;  // Ticks before the buffer has settled on the sender's clock
+    
+    // The buffer's clock estimate includes the average latency, so it shows the spacecraft
+    // that much more in the past than the delay alone
+    const double behind = InterpolationBuffer::DEFAULT_DELAY + (minLatency + maxLatency) / 2.0;
+    const int behindTicks = static_cast<int>(std::lround(behind / dt));
+    
+    std::cout << "Remote spacecraft (" << ticks << " ticks, " << std::lround(minLatency * 1000.0) << "-"
+              << std::lround(maxLatency * 1000.0) << " ms latency)\n";
+    std::cout << std::setw(8) << "send Hz" << std::setw(8) << "loss" << std::setw(12) << "mean px"
+              << std::setw(10) << "max px" << std::setw(12) << "max step" << std::setw(14) << "snap step"
+              << std::setw(14) << "extrapolated" << "\n";
+    
+    for (int sendRate : {30, 20}) {
+        for (double loss : {0.0, 0.2}) {
+            std::mt19937 random(3);
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            
+            Spacecraft truth(sf::Vector2f(200.0f, 300.0f), 0.0f, 2);
+            std::vector<sf::Vector2f> path;
+            path.reserve(static_cast<std::size_t>(ticks));
+            std::vector<StateInFlight> inFlight;
+            InterpolationBuffer buffer;
+            Spacecraft shown;
+            Spacecraft snapped;
+            sf::Vector2f lastShown;
+            sf::Vector2f lastSnapped;
+            
+            const int sendInterval = 60 / sendRate;
+            double totalError = 0.0;
+            float maxError = 0.0f;
+            float maxStep = 0.0f;
+            float maxSnapStep = 0.0f;
+            int measured = 0;
+            int extrapolated = 0;
+            
+            for (int tick = 0; tick < ticks; ++tick) {
+                double now = tick * static_cast<double>(dt);
+                
+                // Thrusts in bursts while turning one way and then the other
+                if ((tick / 40) % 3 != 0) {
+                    truth.applyThrust(dt);
+                }
+                if ((tick / 25) % 2 != 0) {
+                    truth.rotateRight(dt);
+                } else {
+                    truth.rotateLeft(dt);
+                }
+                truth.update(dt);
+                path.push_back(truth.getPosition());
+                
+                if (tick % sendInterval == 0 && uniform(random) >= loss) {
+                    inFlight.push_back({now + minLatency + (maxLatency - minLatency) * uniform(random), now, truth});
+                }
+                auto arrived = std::stable_partition(inFlight.begin(), inFlight.end(),
+                                                     [now](const StateInFlight& state) { return state.arrivesAt <= now; });
+                for (auto it = inFlight.begin(); it != arrived; ++it) {
+                    buffer.push(it->sentAt, now, it->spacecraft);
+                    snapped = it->spacecraft;
+                }
+                inFlight.erase(inFlight.begin(), arrived);
+                snapped.update(dt);
+                
+                if (!buffer.sample(now, shown)) {
+                    continue;
+                }
+                if (tick > warmup) {
+                    float error = wrappedDistance(shown.getPosition(), path[static_cast<std::size_t>(tick - behindTicks)]);
+                    totalError += error;
+                    maxError = std::max(maxError, error);
+                    maxStep = std::max(maxStep, wrappedDistance(shown.getPosition(), lastShown));
+                    maxSnapStep = std::max(maxSnapStep, wrappedDistance(snapped.getPosition(), lastSnapped));
+                    measured++;
+                    if (buffer.isExtrapolating(now)) {
+                        extrapolated++;
+                    }
+                }
+                lastShown = shown.getPosition();
+                lastSnapped = snapped.getPosition();
+            }
+            
+            std::cout << std::setw(8) << sendRate << std::fixed << std::setprecision(2) << std::setw(8) << loss
+                      << std::setw(12) << (measured ? totalError / measured : 0.0) << std::setw(10) << maxError
+                      << std::setw(12) << maxStep << std::setw(14) << maxSnapStep << std::setw(14) << extrapolated
+                      << "\n";
+        }
+    }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+int main(int argc, char* argv[]) 
+{
+    int ticks = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 3600;
+    benchProjectiles(ticks);
+    std::cout << "\n";
+    benchInterpolation(ticks);
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Rollback benchmark: cost of re-simulating mispredicted ticks, and peers staying in sync
+// Two sessions play against each other with inputs delivered a few ticks late, so every
+// change of input is mispredicted and rolled back. Afterwards both must hold the same state.
+// Usage: SpaceWarsRollbackBench [ticks]
+
+#include "RollbackSession.h"
+#include "Simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct Peer {
+    Simulation simulation;
+    RollbackSession session;
+    
+    Peer() : session(simulation) {}
+};
+
+struct InFlight {
+    int deliverAt;
+    int toPlayer;
+    WireFormat::InputFrames frames;
+};
+
+//----------------------------------------------------------------------------------------
+PlayerInput scriptedInput(int playerId, std::uint32_t tick) 
+{
+    // Holds each combination for a few ticks, like a player would, and fires now and then
+    std::uint32_t phase = (tick + static_cast<std::uint32_t>(playerId) * 7) / 6;
+    std::uint32_t hash = phase * 2654435761u + static_cast<std::uint32_t>(playerId);
+    PlayerInput input = PlayerInput::fromBits(static_cast<std::uint8_t>((hash >> 16) & 0x07));
+    input.fire = (tick + static_cast<std::uint32_t>(playerId) * 5) % 20 == 0;
+    return input;
+}
+
+//----------------------------------------------------------------------------------------
+bool sameState(const GameState& a, const GameState& b) 
+{
+    for (int playerId = 1; playerId <= 2; ++playerId) {
+        const Spacecraft& sa = a.getSpacecraft(playerId);
+        const Spacecraft& sb = b.getSpacecraft(playerId);
+        if (sa.getPosition() != sb.getPosition() || sa.getVelocity() != sb.getVelocity() ||
+            sa.getOrientation() != sb.getOrientation() || sa.isAlive() != sb.isAlive() ||
+            a.getScore(playerId) != b.getScore(playerId)) {
+            return false;
+        }
+    }
+    return a.getProjectiles().size() == b.getProjectiles().size() && a.getTime() == b.getTime();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+int main(int argc, char* argv[]) 
+{
+    int ticks = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 3600;
+    const float dt = 1.0f / 60.0f;
+    const int window = RollbackSession::DEFAULT_ROLLBACK;
+    
+    std::cout << "Rollback benchmark (" << ticks << " ticks per peer, window " << window << " ticks)\n";
+    std::cout << std::setw(8) << "delay" << std::setw(11) << "rollbacks" << std::setw(8) << "depth"
+              << std::setw(12) << "us/tick" << std::setw(14) << "us/rollback" << std::setw(10) << "max us"
+              << std::setw(8) << "sync" << "\n";
+    
+    for (int delay : {1, 3, 6}) {
+        Peer peers[2];
+        for (int playerId = 1; playerId <= 2; ++playerId) {
+            peers[playerId - 1].simulation.setPlayerControlled(1, true);
+            peers[playerId - 1].simulation.setPlayerControlled(2, true);
+            peers[playerId - 1].session.setProjectileCapacity(1024);
+            peers[playerId - 1].simulation.getGameState().setProjectileCapacity(1024);
+            peers[playerId - 1].session.reset(playerId, dt, window);
+        }
+        
+        std::vector<InFlight> inFlight;
+        double totalTime = 0.0;
+        double rollbackTime = 0.0;
+        double maxTime = 0.0;
+        std::uint64_t advances = 0;
+        
+        // Play, then a few idle ticks delivered at once so both settle on the same inputs
+        int idleTicks = delay + 2;
+        for (int step = 0; step < ticks + idleTicks; ++step) {
+            bool idle = step >= ticks;
+            for (int playerId = 1; playerId <= 2; ++playerId) {
+                RollbackSession& session = peers[playerId - 1].session;
+                if (!session.canAdvance()) {
+                    continue;
+                }
+                PlayerInput input = idle ? PlayerInput() : scriptedInput(playerId, session.getCurrentTick() + 1);
+                
+                std::uint64_t rollbacksBefore = session.getRollbackCount();
+                auto start = std::chrono::steady_clock::now();
+                session.advance(input);
+                double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+                totalTime += elapsed;
+                maxTime = std::max(maxTime, elapsed);
+                advances++;
+                if (session.getRollbackCount() != rollbacksBefore) {
+                    rollbackTime += elapsed;
+                }
+                
+                InFlight message{idle ? step : step + delay, (playerId == 1) ? 2 : 1, {}};
+                session.fillInputMessage(message.frames);
+                inFlight.push_back(message);
+            }
+            
+            // Deliver what has arrived by now
+            auto arrived = std::stable_partition(inFlight.begin(), inFlight.end(),
+                                                 [step](const InFlight& message) { return message.deliverAt <= step; });
+            for (auto it = inFlight.begin(); it != arrived; ++it) {
+                peers[it->toPlayer - 1].session.addRemoteInputs(it->frames);
+            }
+            inFlight.erase(inFlight.begin(), arrived);
+        }
+        
+        std::uint64_t rollbacks = 0;
+        std::uint64_t resimulated = 0;
+        for (const Peer& peer : peers) {
+            rollbacks += peer.session.getRollbackCount();
+            resimulated += peer.session.getResimulatedTicks();
+        }
+        bool inSync = peers[0].session.getCurrentTick() == peers[1].session.getCurrentTick() &&
+                      sameState(peers[0].simulation.getGameState(), peers[1].simulation.getGameState());
+        
+        std::cout << std::setw(8) << delay << std::setw(11) << rollbacks << std::fixed << std::setprecision(2)
+                  << std::setw(8) << (rollbacks ? static_cast<double>(resimulated) / rollbacks : 0.0)
+                  << std::setw(12) << totalTime / std::max<std::uint64_t>(advances, 1)
+                  << std::setw(14) << (rollbacks ? rollbackTime / rollbacks : 0.0)
+                  << std::setw(10) << maxTime << std::setw(8) << (inSync ? "yes" : "NO") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Server benchmark: many matches ticked on the MatchHost worker pool, without sockets
+// Every match has two players whose inputs are queued at the tick rate, as the server's I/O
+// thread would; the main thread schedules ticks and drains the matches' outboxes. At the
+// end the host's tick statistics show the cost per tick and any missed deadlines.
+// Usage: SpaceWarsServerBench [matches] [threads] [seconds] [tick_rate]
+
+#include "MatchHost.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+//----------------------------------------------------------------------------------------
+std::uint8_t scriptedInput(std::size_t match, int playerId, std::uint32_t tick) 
+{
+    // Holds each combination for a few ticks, like a player would, and fires now and then
+    std::uint32_t phase = (tick + static_cast<std::uint32_t>(match * 3 + static_cast<std::size_t>(playerId) * 7)) / 6;
+    std::uint32_t hash = phase * 2654435761u + static_cast<std::uint32_t>(playerId);
+    PlayerInput input = PlayerInput::fromBits(static_cast<std::uint8_t>((hash >> 16) & 0x07));
+    input.fire = (tick + static_cast<std::uint32_t>(playerId) * 5) % 20 == 0;
+    return input.toBits();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+int main(int argc, char* argv[]) 
+{
+    using Clock = MatchHost::Clock;
+    
+    std::size_t matchCount = (argc > 1) ? static_cast<std::size_t>(std::max(1, std::atoi(argv[1]))) : 512;
+    unsigned int defaultThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    std::size_t workerCount = (argc > 2) ? static_cast<std::size_t>(std::max(1, std::atoi(argv[2]))) : defaultThreads;
+    int seconds = (argc > 3) ? std::max(1, std::atoi(argv[3])) : 5;
+    int tickRate = (argc > 4) ? std::clamp(std::atoi(argv[4]), 10, 240) : 60;
+    
+    std::cout << "Server benchmark (" << matchCount << " matches, " << workerCount << " workers, " << tickRate
+              << " ticks per second, " << seconds << " s)" << std::endl;
+    
+    MatchHost host(matchCount, workerCount, tickRate, 1024);
+    Clock::time_point start = Clock::now();
+    for (std::size_t i = 0; i < matchCount; ++i) {
+        host.getMatch(i).setPlayer(1, static_cast<std::uint32_t>(i * 2 + 1));
+        host.getMatch(i).setPlayer(2, static_cast<std::uint32_t>(i * 2 + 2));
+        host.wake(i, start);
+    }
+    
+    // Inputs are queued a tick at a time as the clock passes each tick; a full inbox only
+    // delays them, like a client repeating unacknowledged inputs
+    std::vector<std::uint32_t> nextInputTick(matchCount, 1);
+    Clock::duration tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate));
+    Clock::time_point end = start + std::chrono::seconds(seconds);
+    std::uint64_t messages = 0;
+    WireFormat::InputFrames frames;
+    
+    for (Clock::time_point now = start; now < end; now = Clock::now()) {
+        std::uint32_t currentTick = static_cast<std::uint32_t>((now - start) / tickDuration) + 1;
+        for (std::size_t i = 0; i < matchCount; ++i) {
+            HostedMatch& match = host.getMatch(i);
+            while (nextInputTick[i] <= currentTick) {
+                bool queued = true;
+                for (int playerId = 1; playerId <= 2; ++playerId) {
+                    frames.firstTick = nextInputTick[i];
+                    frames.count = 1;
+                    frames.inputs[0] = scriptedInput(i, playerId, nextInputTick[i]);
+                    queued = match.addInputs(playerId, match.getPlayer(playerId), frames) && queued;
+                }
+                if (!queued) {
+                    break;
+                }
+                nextInputTick[i]++;
+            }
+            while (match.frontMessage()) {
+                match.popMessage();
+                messages++;
+            }
+        }
+        
+        Clock::time_point nextTick = host.runDueTicks(now);
+        std::this_thread::sleep_until(std::min(nextTick, Clock::now() + std::chrono::milliseconds(1)));
+    }
+    
+    host.reportStats(std::cout);
+    std::cout << messages << " messages produced" << std::endl;
+    return 0;
+}
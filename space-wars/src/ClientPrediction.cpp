@@ -0,0 +1,73 @@
+#include "ClientPrediction.h"
+#include "Simulation.h"
+#include "Spacecraft.h"
+#include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------------------
+ClientPrediction::ClientPrediction() 
+{
+    reset();
+}
+
+//----------------------------------------------------------------------------------------
+void ClientPrediction::reset() 
+{
+    m_history = {};
+    m_latestSequence = 0;
+    m_acknowledged = 0;
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t ClientPrediction::record(const PlayerInput& input, float deltaTime) 
+{
+    m_latestSequence++;
+    Entry& entry = m_history[m_latestSequence % HISTORY_SIZE];
+    entry.sequence = m_latestSequence;
+    entry.input = input;
+    entry.deltaTime = deltaTime;
+    return m_latestSequence;
+}
+
+//----------------------------------------------------------------------------------------
+void ClientPrediction::fillInputMessage(WireFormat::InputFrames& frames) const 
+{
+    std::uint32_t first = m_acknowledged + 1;
+    if (m_latestSequence >= WireFormat::InputFrames::MAX_FRAMES) {
+        first = std::max<std::uint32_t>(first, m_latestSequence - WireFormat::InputFrames::MAX_FRAMES + 1);
+    }
+    
+    frames.firstTick = first;
+    frames.ack = 0;
+    frames.count = 0;
+    for (std::uint32_t sequence = first; sequence <= m_latestSequence; ++sequence) {
+        frames.inputs[frames.count++] = m_history[sequence % HISTORY_SIZE].input.toBits();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+float ClientPrediction::reconcile(Spacecraft& spacecraft, const Spacecraft& authoritative,
+                                  std::uint32_t acknowledged) 
+{
+    if (acknowledged == 0 || acknowledged <= m_acknowledged || acknowledged > m_latestSequence) {
+        return -1.0f;  // Nothing new confirmed, or an ack from before a reset
+    }
+    m_acknowledged = acknowledged;
+    
+    // Inputs after the ack must all still be in the ring, or the replay would skip some
+    if (m_latestSequence - acknowledged >= HISTORY_SIZE) {
+        return -1.0f;
+    }
+    
+    sf::Vector2f predicted = spacecraft.getPosition();
+    spacecraft = authoritative;
+    
+    // Dead spacecraft neither move nor accept input (as in Simulation::step)
+    for (std::uint32_t sequence = acknowledged + 1; sequence <= m_latestSequence && spacecraft.isAlive(); ++sequence) {
+        const Entry& entry = m_history[sequence % HISTORY_SIZE];
+        Simulation::moveSpacecraft(spacecraft, entry.input, entry.deltaTime);
+    }
+    
+    sf::Vector2f correction = spacecraft.getPosition() - predicted;
+    return std::sqrt(correction.x * correction.x + correction.y * correction.y);
+}
@@ -0,0 +1,54 @@
+#ifndef CLIENTPREDICTION_H
+#define CLIENTPREDICTION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "PlayerInput.h"
+#include "WireFormat.h"
+
+class Spacecraft;
+
+// Client-side prediction of the local spacecraft against an authoritative host
+// Every local input is numbered and kept in a fixed ring while the game applies it at once.
+// When the host's state arrives with the newest input it has simulated (the input ack), the
+// local spacecraft is reset to that state and the inputs the host has not seen yet are
+// replayed on top, so the player keeps an immediate response while the host stays in charge.
+// Nothing is allocated after construction.
+class ClientPrediction {
+public:
+    static constexpr std::size_t HISTORY_SIZE = 128;  // Inputs kept for replay (about 2 s at 60 Hz)
+    
+    ClientPrediction();
+    
+    // Forget every input and start numbering from 1 again (new connection)
+    void reset();
+    
+    // Remember an input applied for deltaTime seconds; returns its sequence number (starts at 1)
+    std::uint32_t record(const PlayerInput& input, float deltaTime);
+    
+    // Replace spacecraft with authoritative, the host's state after input acknowledged, and
+    // replay the newer inputs. Acks that are stale, from the future or older than the history
+    // are ignored (spacecraft untouched, returns a negative value). Otherwise returns how far
+    // the spacecraft moved, only the wire rounding while the prediction was right.
+    float reconcile(Spacecraft& spacecraft, const Spacecraft& authoritative, std::uint32_t acknowledged);
+    
+    // Inputs the host has not acknowledged yet, the newest MAX_FRAMES at most (sequence = tick)
+    void fillInputMessage(WireFormat::InputFrames& frames) const;
+    
+    std::uint32_t getLatestSequence() const { return m_latestSequence; }
+    std::uint32_t getAcknowledged() const { return m_acknowledged; }
+
+private:
+    struct Entry {
+        std::uint32_t sequence = 0;
+        PlayerInput input;
+        float deltaTime = 0.0f;
+    };
+    
+    std::array<Entry, HISTORY_SIZE> m_history;  // Indexed by sequence % HISTORY_SIZE
+    std::uint32_t m_latestSequence;  // Newest recorded input, 0 if none
+    std::uint32_t m_acknowledged;    // Newest input the host has confirmed, 0 if none
+};
+
+#endif // CLIENTPREDICTION_H
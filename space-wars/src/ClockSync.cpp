@@ -0,0 +1,185 @@
+#include "ClockSync.h"
+#include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------------------
+ClockSync::ClockSync()
+    : m_tickNs(1000000000 / 60)
+{
+    reset();
+}
+
+//----------------------------------------------------------------------------------------
+void ClockSync::reset() 
+{
+    m_origin = Clock::time_point();
+    m_baseOffsetUs = 0;
+    m_historyCount = 0;
+    m_historyNext = 0;
+    m_hasPeriodBest = false;
+    m_periodEnd = Clock::time_point();
+    m_fitTimeS = 0.0;
+    m_fitOffsetUs = 0.0;
+    m_driftPpm = 0.0;
+    m_epochStamps = 0;
+    m_tickEpochUs = 0;
+    m_hasTickEpoch = false;
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t ClockSync::timestampUs(Clock::time_point time) 
+{
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+    return static_cast<std::uint32_t>(us);
+}
+
+//----------------------------------------------------------------------------------------
+void ClockSync::addRoundTrip(std::uint32_t pingSentUs, std::uint32_t peerUs, Clock::time_point receivedAt) 
+{
+    // The peer answers at once, so its answer time stands for the middle of our round trip
+    std::uint32_t rttUs = timestampUs(receivedAt) - pingSentUs;
+    std::uint32_t midpointUs = pingSentUs + rttUs / 2;
+    Clock::time_point midpoint = receivedAt - std::chrono::microseconds(rttUs - rttUs / 2);
+    std::uint32_t offsetUs = peerUs - midpointUs;
+    
+    if (!isSynced()) {
+        m_origin = midpoint;
+        m_baseOffsetUs = offsetUs;
+        m_periodEnd = receivedAt + SAMPLE_PERIOD;
+    }
+    
+    // The period's best sample joins the history once the period is over
+    if (receivedAt >= m_periodEnd && m_hasPeriodBest) {
+        m_history[m_historyNext] = m_periodBest;
+        m_historyNext = (m_historyNext + 1) % HISTORY_SIZE;
+        m_historyCount = std::min(m_historyCount + 1, HISTORY_SIZE);
+        m_hasPeriodBest = false;
+        m_periodEnd = receivedAt + SAMPLE_PERIOD;
+    }
+    
+    if (!m_hasPeriodBest || rttUs < m_periodBest.rttUs) {
+        m_periodBest.timeS = secondsSinceOrigin(midpoint);
+        m_periodBest.offsetUs = static_cast<double>(static_cast<std::int32_t>(offsetUs - m_baseOffsetUs));
+        m_periodBest.rttUs = rttUs;
+        m_hasPeriodBest = true;
+    }
+    refit();
+}
+
+//----------------------------------------------------------------------------------------
+void ClockSync::addTickStamp(std::uint32_t tick, std::uint32_t peerUs) 
+{
+    // Peer time of tick 0 if the tick had started at peerUs; it started at or before that
+    std::uint32_t sinceEpochUs = static_cast<std::uint32_t>(static_cast<std::uint64_t>(tick) * m_tickNs / 1000);
+    std::uint32_t epochUs = peerUs - sinceEpochUs;
+    if (!m_hasTickEpoch) {
+        m_epochMinima.fill(epochUs);
+        m_hasTickEpoch = true;
+    }
+    
+    // Start a new part once the newest is full; the oldest part drops out of the window
+    if (m_epochStamps == EPOCH_WINDOW / EPOCH_PARTS) {
+        std::rotate(m_epochMinima.begin(), m_epochMinima.begin() + 1, m_epochMinima.end());
+        m_epochMinima.back() = epochUs;
+        m_epochStamps = 0;
+    }
+    m_epochStamps++;
+    
+    // Earliest, compared relative to the newest stamp (the epochs may wrap)
+    std::uint32_t& newest = m_epochMinima.back();
+    if (static_cast<std::int32_t>(epochUs - newest) < 0) {
+        newest = epochUs;
+    }
+    m_tickEpochUs = epochUs;
+    for (std::uint32_t minimum : m_epochMinima) {
+        if (static_cast<std::int32_t>(minimum - epochUs) < static_cast<std::int32_t>(m_tickEpochUs - epochUs)) {
+            m_tickEpochUs = minimum;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void ClockSync::refit() 
+{
+    // The filtered history plus the best sample of the period so far
+    std::size_t count = m_historyCount;
+    auto sample = [this, count](std::size_t i) -> const Sample& {
+        return (i < count) ? m_history[i] : m_periodBest;
+    };
+    std::size_t total = count + (m_hasPeriodBest ? 1 : 0);
+    if (total == 0) {
+        return;
+    }
+    
+    double meanTime = 0.0;
+    double meanOffset = 0.0;
+    double firstTime = sample(0).timeS;
+    double lastTime = firstTime;
+    std::size_t fastest = 0;
+    for (std::size_t i = 0; i < total; ++i) {
+        meanTime += sample(i).timeS;
+        meanOffset += sample(i).offsetUs;
+        firstTime = std::min(firstTime, sample(i).timeS);
+        lastTime = std::max(lastTime, sample(i).timeS);
+        if (sample(i).rttUs < sample(fastest).rttUs) {
+            fastest = i;
+        }
+    }
+    
+    if (lastTime - firstTime < std::chrono::duration<double>(MIN_DRIFT_SPAN).count()) {
+        // Too short to tell drift from jitter: the offset the fastest round trip saw
+        m_fitTimeS = sample(fastest).timeS;
+        m_fitOffsetUs = sample(fastest).offsetUs;
+        m_driftPpm = 0.0;
+        return;
+    }
+    
+    // Least squares: the offset drifts by microseconds per second, parts per million
+    meanTime /= static_cast<double>(total);
+    meanOffset /= static_cast<double>(total);
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (std::size_t i = 0; i < total; ++i) {
+        double dt = sample(i).timeS - meanTime;
+        covariance += dt * (sample(i).offsetUs - meanOffset);
+        variance += dt * dt;
+    }
+    m_fitTimeS = meanTime;
+    m_fitOffsetUs = meanOffset;
+    m_driftPpm = covariance / variance;
+}
+
+//----------------------------------------------------------------------------------------
+double ClockSync::secondsSinceOrigin(Clock::time_point time) const 
+{
+    return std::chrono::duration<double>(time - m_origin).count();
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t ClockSync::offsetAt(Clock::time_point time) const 
+{
+    double relativeUs = m_fitOffsetUs + m_driftPpm * (secondsSinceOrigin(time) - m_fitTimeS);
+    return m_baseOffsetUs + static_cast<std::uint32_t>(std::llround(relativeUs));
+}
+
+//----------------------------------------------------------------------------------------
+double ClockSync::getOffsetUs(Clock::time_point time) const 
+{
+    return static_cast<double>(static_cast<std::int32_t>(offsetAt(time)));
+}
+
+//----------------------------------------------------------------------------------------
+ClockSync::Clock::time_point ClockSync::peerToLocal(std::uint32_t peerUs, Clock::time_point now) const 
+{
+    // Our timestamp of the same moment, placed relative to now (the nearest wrap)
+    std::uint32_t localUs = peerUs - offsetAt(now);
+    std::int32_t fromNowUs = static_cast<std::int32_t>(localUs - timestampUs(now));
+    return now + std::chrono::microseconds(fromNowUs);
+}
+
+//----------------------------------------------------------------------------------------
+ClockSync::Clock::time_point ClockSync::tickToLocal(std::uint32_t tick, Clock::time_point now) const 
+{
+    std::uint32_t sinceEpochUs = static_cast<std::uint32_t>(static_cast<std::uint64_t>(tick) * m_tickNs / 1000);
+    return peerToLocal(m_tickEpochUs + sinceEpochUs, now);
+}
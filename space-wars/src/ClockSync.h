@@ -0,0 +1,102 @@
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Offset and drift of a peer's clock against ours, estimated NTP-style from heartbeats
+// A pong carries three timestamps: when our ping left (ours, echoed), when the peer answered
+// (the peer's clock) and, taken on arrival, when the pong came back (ours). Assuming the two
+// directions take equally long, the peer's clock is ahead of ours by its answer time minus
+// the midpoint of our round trip. Queueing only ever adds delay, so of the samples in each
+// SAMPLE_PERIOD only the one with the shortest round trip is kept (NTP's clock filter). The
+// offset is a least-squares line through the last HISTORY_SIZE of those; once they span
+// MIN_DRIFT_SPAN its slope is the drift, the rate at which the two clocks run apart.
+//
+// Messages are stamped with the sender's tick, and heartbeats also carry the sender's clock,
+// so each one pairs a tick of the peer with its clock time. Both sides run the same tick
+// rate, which makes that the peer's clock time of tick 0 (its tick epoch) plus whatever time
+// had passed since the tick started. The earliest pairing among the last EPOCH_WINDOW
+// stamps is the closest; the window lets the epoch move on when the peer stalls or pauses.
+// With the epoch and the offset, tickToLocal() places any tick of the peer on our timeline.
+//
+// Wire timestamps are 32-bit microseconds and wrap every 71 minutes; every difference is taken
+// modulo 2^32, so only the offset modulo that is known. All calls are made from one thread.
+class ClockSync {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    ClockSync();
+    
+    // Setup: length of the peer's ticks
+    void setTickDuration(std::chrono::nanoseconds tickDuration) { m_tickNs = static_cast<std::uint64_t>(tickDuration.count()); }
+    
+    // New connection: forget every sample
+    void reset();
+    
+    // Round trip from a pong: pingSentUs echoed from our ping, peerUs the peer's answer time
+    void addRoundTrip(std::uint32_t pingSentUs, std::uint32_t peerUs, Clock::time_point receivedAt);
+    
+    // The peer was at tick when its clock read peerUs
+    void addTickStamp(std::uint32_t tick, std::uint32_t peerUs);
+    
+    bool isSynced() const { return m_historyCount > 0 || m_hasPeriodBest; }  // Offset known
+    bool hasTickEpoch() const { return m_hasTickEpoch; }
+    
+    // Peer clock minus ours at time, in microseconds (modulo 2^32, as the nearest value)
+    double getOffsetUs(Clock::time_point time) const;
+    double getDriftPpm() const { return m_driftPpm; }  // Positive if the peer's clock runs fast
+    
+    // Peer clock timestamp, or the start of a peer tick, as our time (near now)
+    Clock::time_point peerToLocal(std::uint32_t peerUs, Clock::time_point now) const;
+    Clock::time_point tickToLocal(std::uint32_t tick, Clock::time_point now) const;
+    
+    // Wire timestamp of time (microseconds, wraps)
+    static std::uint32_t timestampUs(Clock::time_point time);
+    
+    static constexpr std::chrono::milliseconds SAMPLE_PERIOD{1000};
+    static constexpr std::size_t HISTORY_SIZE = 64;            // Filtered samples, about a minute
+    static constexpr std::chrono::seconds MIN_DRIFT_SPAN{10};  // Shorter spans are all jitter
+    static constexpr std::size_t EPOCH_WINDOW = 128;           // Tick stamps, about 3 seconds of heartbeats
+
+private:
+    // Offset measured by one round trip
+    struct Sample {
+        double timeS = 0.0;      // Midpoint of the round trip, seconds since m_origin
+        double offsetUs = 0.0;   // Relative to m_baseOffsetUs
+        std::uint32_t rttUs = 0;
+    };
+    
+    void refit();
+    double secondsSinceOrigin(Clock::time_point time) const;
+    std::uint32_t offsetAt(Clock::time_point time) const;  // Peer minus ours, modulo 2^32
+    
+    std::uint64_t m_tickNs;
+    
+    // Offsets are kept relative to the first one, so they never wrap between samples
+    Clock::time_point m_origin;
+    std::uint32_t m_baseOffsetUs;
+    
+    std::array<Sample, HISTORY_SIZE> m_history;  // Best sample of each period, ring
+    std::size_t m_historyCount;
+    std::size_t m_historyNext;
+    Sample m_periodBest;
+    bool m_hasPeriodBest;
+    Clock::time_point m_periodEnd;
+    
+    // Fitted line: offset m_fitOffsetUs at m_fitTimeS, changing by m_driftPpm microseconds per second
+    double m_fitTimeS;
+    double m_fitOffsetUs;
+    double m_driftPpm;
+    
+    // Earliest epoch of each quarter of the window, newest last
+    static constexpr std::size_t EPOCH_PARTS = 4;
+    std::array<std::uint32_t, EPOCH_PARTS> m_epochMinima{};
+    std::size_t m_epochStamps;    // In the newest part
+    std::uint32_t m_tickEpochUs;  // Peer clock at its tick 0
+    bool m_hasTickEpoch;
+};
+
+#endif // CLOCKSYNC_H
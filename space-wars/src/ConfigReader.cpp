@@ -1,4 +1,6 @@
 #include "ConfigReader.h"
+#include "EntityRegistry.h"
+#include "RollbackSession.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -92,6 +94,12 @@ bool ConfigReader::isValidPort(int port)
     return port >= 1 && port <= 65535;
 }
 
+//----------------------------------------------------------------------------------------
+bool ConfigReader::isValidTickRate(int tickRate) 
+{
+    return tickRate >= 10 && tickRate <= 240;
+}
+
 //----------------------------------------------------------------------------------------
 bool ConfigReader::readConfig(const std::string& filename, NetworkConfig& config) 
 {
@@ -158,6 +166,108 @@ bool ConfigReader::readConfig(const std::string& filename, NetworkConfig& config
             }
             config.clientPlayerId = playerId;
             hasClientPlayerId = true;
+        } else if (lowerKey == "tick_rate" || lowerKey == "tickrate") {
+            int tickRate;
+            if (!stringToInt(value, tickRate) || !isValidTickRate(tickRate)) {
+                return false;  // Invalid tick rate
+            }
+            config.tickRate = tickRate;
+        } else if (lowerKey == "frame_rate" || lowerKey == "framerate") {
+            int frameRate;
+            if (!stringToInt(value, frameRate) || frameRate < 0) {
+                return false;  // Invalid frame rate
+            }
+            config.frameRate = frameRate;
+        } else if (lowerKey == "max_projectiles" || lowerKey == "maxprojectiles") {
+            int maxProjectiles;
+            if (!stringToInt(value, maxProjectiles) || maxProjectiles < 1
+                || maxProjectiles > static_cast<int>(Entity::MAX_SLOTS)) {
+                return false;  // Invalid projectile capacity (must fit the handle's slot bits)
+            }
+            config.maxProjectiles = maxProjectiles;
+        } else if (lowerKey == "transport") {
+            std::string transport = value;
+            std::transform(transport.begin(), transport.end(), transport.begin(), ::tolower);
+            if (transport == "udp") {
+                config.transport = TransportType::Udp;
+            } else if (transport == "zmq" || transport == "zeromq") {
+                config.transport = TransportType::Zmq;
+            } else if (transport == "server") {
+                config.transport = TransportType::Server;
+            } else {
+                return false;  // Unknown transport
+            }
+        } else if (lowerKey == "latency_bounded" || lowerKey == "latencybounded") {
+            int latencyBounded;
+            if (!stringToInt(value, latencyBounded) || (latencyBounded != 0 && latencyBounded != 1)) {
+                return false;  // Must be 0 or 1
+            }
+            config.latencyBounded = (latencyBounded == 1);
+        } else if (lowerKey == "network_stats" || lowerKey == "networkstats") {
+            int networkStats;
+            if (!stringToInt(value, networkStats) || (networkStats != 0 && networkStats != 1)) {
+                return false;  // Must be 0 or 1
+            }
+            config.networkStats = (networkStats == 1);
+        } else if (lowerKey == "heartbeat_interval" || lowerKey == "heartbeatinterval") {
+            int heartbeatInterval;
+            if (!stringToInt(value, heartbeatInterval) || heartbeatInterval < 10 || heartbeatInterval > 1000) {
+                return false;  // Invalid heartbeat interval (10-1000 ms)
+            }
+            config.heartbeatInterval = heartbeatInterval;
+        } else if (lowerKey == "connection_timeout" || lowerKey == "connectiontimeout") {
+            int connectionTimeout;
+            if (!stringToInt(value, connectionTimeout) || connectionTimeout < 100 || connectionTimeout > 60000) {
+                return false;  // Invalid connection timeout (100-60000 ms)
+            }
+            config.connectionTimeout = connectionTimeout;
+        } else if (lowerKey == "netcode") {
+            std::string netcode = value;
+            std::transform(netcode.begin(), netcode.end(), netcode.begin(), ::tolower);
+            if (netcode == "snapshot") {
+                config.rollback = false;
+            } else if (netcode == "rollback") {
+                config.rollback = true;
+            } else {
+                return false;  // Unknown netcode
+            }
+        } else if (lowerKey == "rollback_frames" || lowerKey == "rollbackframes") {
+            int rollbackFrames;
+            if (!stringToInt(value, rollbackFrames) || rollbackFrames < 1
+                || rollbackFrames > RollbackSession::MAX_ROLLBACK) {
+                return false;  // Invalid rollback window (1-15 ticks)
+            }
+            config.rollbackFrames = rollbackFrames;
+        } else if (lowerKey == "interpolation_delay" || lowerKey == "interpolationdelay") {
+            int interpolationDelay;
+            if (!stringToInt(value, interpolationDelay) || interpolationDelay < 0 || interpolationDelay > 500) {
+                return false;  // Invalid interpolation delay (0-500 ms)
+            }
+            config.interpolationDelay = interpolationDelay;
+        } else if (lowerKey == "extrapolation_limit" || lowerKey == "extrapolationlimit") {
+            int extrapolationLimit;
+            if (!stringToInt(value, extrapolationLimit) || extrapolationLimit < 0 || extrapolationLimit > 1000) {
+                return false;  // Invalid extrapolation limit (0-1000 ms)
+            }
+            config.extrapolationLimit = extrapolationLimit;
+        } else if (lowerKey == "spectator_port" || lowerKey == "spectatorport") {
+            int spectatorPort;
+            if (!stringToInt(value, spectatorPort) || (spectatorPort != 0 && !isValidPort(spectatorPort))) {
+                return false;  // Invalid port (0 turns publishing off)
+            }
+            config.spectatorPort = spectatorPort;
+        } else if (lowerKey == "spectate") {
+            int spectate;
+            if (!stringToInt(value, spectate) || (spectate != 0 && spectate != 1)) {
+                return false;  // Must be 0 or 1
+            }
+            config.spectate = (spectate == 1);
+        } else if (lowerKey == "spectate_match" || lowerKey == "spectatematch") {
+            int spectateMatch;
+            if (!stringToInt(value, spectateMatch) || spectateMatch < -1) {
+                return false;  // Invalid match index (-1 watches a player's stream)
+            }
+            config.spectateMatch = spectateMatch;
         }
         // Ignore unknown keys (for future extensibility)
     }
@@ -170,6 +280,21 @@ bool ConfigReader::readConfig(const std::string& filename, NetworkConfig& config
         return false;
     }
     
+    // The timeout must leave room for a few heartbeats, or a single late one would drop the connection
+    if (config.connectionTimeout < 2 * config.heartbeatInterval) {
+        return false;
+    }
+    
+    // A dedicated server runs the match itself; there is no peer to roll back with
+    if (config.transport == TransportType::Server && config.rollback) {
+        return false;
+    }
+    
+    // A spectator only watches; the players publish
+    if (config.spectate && config.spectatorPort != 0) {
+        return false;
+    }
+    
     // If player IDs are not specified, use defaults (already set in constructor)
     // If they are specified, validate they are different
     if (hasHostPlayerId && hasClientPlayerId) {
@@ -2,6 +2,7 @@
 #define CONFIGREADER_H
 
 #include <string>
+#include "Transport.h"
 
 struct NetworkConfig {
     std::string hostIp;
@@ -11,6 +12,27 @@ struct NetworkConfig {
     int hostPlayerId;      // Which player this configuration is for (1 or 2)
     int clientPlayerId;    // Which player we're connecting to (1 or 2)
     
+    // Simulation and display settings (optional)
+    int tickRate;          // Fixed simulation steps per second
+    int frameRate;         // Rendered frames per second limit, 0 = vertical sync
+    int maxProjectiles;    // Projectile pool capacity (shots beyond it are dropped)
+    
+    // Network tuning (optional)
+    TransportType transport;  // udp or zmq (both players must use the same), or server
+    bool latencyBounded;   // ZeroMQ: keep only the newest snapshot in the socket queues
+    bool networkStats;     // Periodically print how long messages wait in the queues
+    int heartbeatInterval; // Milliseconds between heartbeat pings
+    int connectionTimeout; // Milliseconds of silence from the peer before the connection counts as lost
+    bool rollback;         // Exchange inputs only and re-simulate mispredicted ticks (both players must match)
+    int rollbackFrames;    // Ticks the rollback mode may run ahead of the peer's inputs
+    int interpolationDelay;  // Milliseconds the remote spacecraft is shown in the past
+    int extrapolationLimit;  // Milliseconds the remote spacecraft is dead-reckoned when states are late
+    
+    // Spectators (optional)
+    int spectatorPort;     // Publish the match for spectators on this port, 0 = off
+    bool spectate;         // Watch the match published at client_ip:client_port instead of playing
+    int spectateMatch;     // Match to watch on a server's spectator port, -1 = a player's stream
+    
     NetworkConfig()
         : hostIp("127.0.0.1")
         , hostPort(5555)
@@ -18,6 +40,21 @@ struct NetworkConfig {
         , clientPort(5556)
         , hostPlayerId(1)
         , clientPlayerId(2)
+        , tickRate(60)
+        , frameRate(60)
+        , maxProjectiles(1024)
+        , transport(TransportType::Udp)
+        , latencyBounded(true)
+        , networkStats(false)
+        , heartbeatInterval(50)
+        , connectionTimeout(500)
+        , rollback(false)
+        , rollbackFrames(8)
+        , interpolationDelay(100)
+        , extrapolationLimit(250)
+        , spectatorPort(0)
+        , spectate(false)
+        , spectateMatch(-1)
     {}
 };
 
@@ -36,6 +73,9 @@ public:
     // Validate port number (1-65535)
     static bool isValidPort(int port);
     
+    // Validate simulation tick rate (10-240 Hz)
+    static bool isValidTickRate(int tickRate);
+
 private:
     // Parse a line from the configuration file
     // Format: key=value or key = value (whitespace is trimmed)
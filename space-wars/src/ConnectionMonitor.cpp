@@ -0,0 +1,268 @@
+#include "ConnectionMonitor.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+//----------------------------------------------------------------------------------------
+ConnectionMonitor::ConnectionMonitor()
+    : m_heartbeatInterval(DEFAULT_HEARTBEAT_INTERVAL)
+    , m_timeout(DEFAULT_TIMEOUT)
+    , m_pingSequence(0)
+    , m_peerHeard(false)
+    , m_timedOut(false)
+    , m_hasRtt(false)
+    , m_lastRttMs(0.0f)
+    , m_lossHistory(0)
+    , m_lossSamples(0)
+    , m_hasSnapshotDelay(false)
+    , m_peerAlive(false)
+    , m_rttMs(0.0f)
+    , m_jitterMs(0.0f)
+    , m_lossRate(0.0f)
+    , m_lastReceiveTicks(0)
+    , m_pingsSent(0)
+    , m_pingsLost(0)
+    , m_snapshotsReceived(0)
+    , m_snapshotsLost(0)
+    , m_clockSynced(false)
+    , m_clockOffsetMs(0.0f)
+    , m_clockDriftPpm(0.0f)
+    , m_snapshotDelayMs(0.0f)
+    , m_stateSentTicks(0)
+{
+}
+
+//----------------------------------------------------------------------------------------
+void ConnectionMonitor::reset() 
+{
+    for (PendingPing& ping : m_pending) {
+        ping.outstanding = false;
+    }
+    m_nextPing = Clock::time_point();
+    m_peerHeard = false;
+    m_timedOut = false;
+    m_hasRtt = false;
+    m_lastRttMs = 0.0f;
+    m_lossHistory = 0;
+    m_lossSamples = 0;
+    m_clock.reset();
+    m_hasSnapshotDelay = false;
+    
+    m_peerAlive.store(false, std::memory_order_relaxed);
+    m_rttMs.store(0.0f, std::memory_order_relaxed);
+    m_jitterMs.store(0.0f, std::memory_order_relaxed);
+    m_lossRate.store(0.0f, std::memory_order_relaxed);
+    m_lastReceiveTicks.store(0, std::memory_order_relaxed);
+    m_pingsSent.store(0, std::memory_order_relaxed);
+    m_pingsLost.store(0, std::memory_order_relaxed);
+    m_snapshotsReceived.store(0, std::memory_order_relaxed);
+    m_snapshotsLost.store(0, std::memory_order_relaxed);
+    m_clockSynced.store(false, std::memory_order_relaxed);
+    m_clockOffsetMs.store(0.0f, std::memory_order_relaxed);
+    m_clockDriftPpm.store(0.0f, std::memory_order_relaxed);
+    m_snapshotDelayMs.store(0.0f, std::memory_order_relaxed);
+    m_stateSentTicks.store(0, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------
+bool ConnectionMonitor::preparePing(Clock::time_point now, WireFormat::Heartbeat& ping) 
+{
+    if (now < m_nextPing) {
+        return false;
+    }
+    // Keep the cadence, but never send a burst to catch up after a stall
+    m_nextPing = std::max(m_nextPing + m_heartbeatInterval, now);
+    
+    if (++m_pingSequence == 0) {
+        m_pingSequence = 1;
+    }
+    
+    // The window slot is still taken only if the timeout spans more than LOSS_WINDOW pings
+    PendingPing& pending = m_pending[m_pingSequence % LOSS_WINDOW];
+    if (pending.outstanding) {
+        resolvePing(pending, true);
+    }
+    pending.sequence = m_pingSequence;
+    pending.sentAt = now;
+    pending.outstanding = true;
+    m_pingsSent.fetch_add(1, std::memory_order_relaxed);
+    
+    ping.pong = false;
+    ping.sequence = m_pingSequence;
+    ping.timeUs = ClockSync::timestampUs(now);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void ConnectionMonitor::preparePong(Clock::time_point now, WireFormat::Heartbeat& heartbeat) 
+{
+    // Sequence and timestamp are echoed unchanged; our clock tells the peer the offset
+    heartbeat.pong = true;
+    heartbeat.replyUs = ClockSync::timestampUs(now);
+}
+
+//----------------------------------------------------------------------------------------
+void ConnectionMonitor::onReceive(Clock::time_point now) 
+{
+    if (!m_peerHeard) {
+        m_firstReceive = now;
+        m_peerHeard = true;
+    }
+    m_lastReceive = now;
+    m_timedOut = false;
+    m_peerAlive.store(true, std::memory_order_relaxed);
+    m_lastReceiveTicks.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------
+void ConnectionMonitor::onPing(const WireFormat::Heartbeat& ping, std::uint32_t tick) 
+{
+    m_clock.addTickStamp(tick, ping.timeUs);
+}
+
+//----------------------------------------------------------------------------------------
+void ConnectionMonitor::onPong(const WireFormat::Heartbeat& pong, std::uint32_t tick, Clock::time_point now) 
+{
+    // Late pongs still say how the clocks relate; only loss and RTT need the ping pending
+    m_clock.addTickStamp(tick, pong.replyUs);
+    m_clock.addRoundTrip(pong.timeUs, pong.replyUs, now);
+    publishClock(now);
+    
+    PendingPing& pending = m_pending[pong.sequence % LOSS_WINDOW];
+    if (!pending.outstanding || pending.sequence != pong.sequence) {
+        return;  // Duplicate, or so late the ping was already counted as lost
+    }
+    resolvePing(pending, false);
+    
+    // Measured on our clock from the echoed timestamp (unsigned difference handles the wrap)
+    float rttMs = static_cast<float>(ClockSync::timestampUs(now) - pong.timeUs) / 1000.0f;
+    float rtt = m_rttMs.load(std::memory_order_relaxed);
+    float jitter = m_jitterMs.load(std::memory_order_relaxed);
+    if (!m_hasRtt) {
+        rtt = rttMs;
+        jitter = 0.0f;
+        m_hasRtt = true;
+    } else {
+        rtt += (rttMs - rtt) / 8.0f;
+        jitter += (std::abs(rttMs - m_lastRttMs) - jitter) / 16.0f;
+    }
+    m_lastRttMs = rttMs;
+    m_rttMs.store(rtt, std::memory_order_relaxed);
+    m_jitterMs.store(jitter, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------
+void ConnectionMonitor::onSnapshots(std::uint64_t received, std::uint64_t lost) 
+{
+    m_snapshotsReceived.fetch_add(received, std::memory_order_relaxed);
+    m_snapshotsLost.fetch_add(lost, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------
+void ConnectionMonitor::onSnapshotTick(std::uint32_t tick, Clock::time_point now) 
+{
+    Clock::time_point sentAt;
+    if (!peerTickToLocal(tick, now, sentAt)) {
+        return;
+    }
+    m_stateSentTicks.store(sentAt.time_since_epoch().count(), std::memory_order_relaxed);
+    
+    // The peer's queue plus one way across the network, smoothed like the RTT
+    float delayMs = std::chrono::duration<float, std::milli>(now - sentAt).count();
+    float delay = m_snapshotDelayMs.load(std::memory_order_relaxed);
+    if (!m_hasSnapshotDelay) {
+        delay = delayMs;
+        m_hasSnapshotDelay = true;
+    } else {
+        delay += (delayMs - delay) / 8.0f;
+    }
+    m_snapshotDelayMs.store(delay, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------
+bool ConnectionMonitor::peerTickToLocal(std::uint32_t tick, Clock::time_point now, Clock::time_point& local) const 
+{
+    if (!m_clock.isSynced() || !m_clock.hasTickEpoch()) {
+        return false;
+    }
+    local = m_clock.tickToLocal(tick, now);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool ConnectionMonitor::update(Clock::time_point now) 
+{
+    for (PendingPing& pending : m_pending) {
+        if (pending.outstanding && now - pending.sentAt > m_timeout) {
+            // Pings sent before the peer was first heard say nothing about the path
+            if (m_peerHeard && pending.sentAt >= m_firstReceive) {
+                resolvePing(pending, true);
+            } else {
+                pending.outstanding = false;
+            }
+        }
+    }
+    
+    if (!m_peerHeard || m_timedOut || now - m_lastReceive <= m_timeout) {
+        return false;
+    }
+    m_timedOut = true;
+    m_peerAlive.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void ConnectionMonitor::resolvePing(PendingPing& ping, bool lost) 
+{
+    ping.outstanding = false;
+    m_lossHistory = (m_lossHistory << 1) | (lost ? 1 : 0);
+    if (m_lossSamples < LOSS_WINDOW) {
+        m_lossSamples++;
+    }
+    if (lost) {
+        m_pingsLost.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Bits beyond m_lossSamples are still zero, so they never count as losses
+    float lossRate = static_cast<float>(std::popcount(m_lossHistory)) / static_cast<float>(m_lossSamples);
+    m_lossRate.store(lossRate, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------
+void ConnectionMonitor::publishClock(Clock::time_point now) 
+{
+    m_clockOffsetMs.store(static_cast<float>(m_clock.getOffsetUs(now) / 1000.0), std::memory_order_relaxed);
+    m_clockDriftPpm.store(static_cast<float>(m_clock.getDriftPpm()), std::memory_order_relaxed);
+    m_clockSynced.store(m_clock.isSynced(), std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------------------
+ConnectionQuality ConnectionMonitor::quality() const 
+{
+    ConnectionQuality quality;
+    quality.peerAlive = m_peerAlive.load(std::memory_order_relaxed);
+    quality.rttMs = m_rttMs.load(std::memory_order_relaxed);
+    quality.jitterMs = m_jitterMs.load(std::memory_order_relaxed);
+    quality.lossRate = m_lossRate.load(std::memory_order_relaxed);
+    quality.pingsSent = m_pingsSent.load(std::memory_order_relaxed);
+    quality.pingsLost = m_pingsLost.load(std::memory_order_relaxed);
+    quality.snapshotsReceived = m_snapshotsReceived.load(std::memory_order_relaxed);
+    quality.snapshotsLost = m_snapshotsLost.load(std::memory_order_relaxed);
+    
+    std::int64_t lastReceive = m_lastReceiveTicks.load(std::memory_order_relaxed);
+    if (lastReceive != 0) {
+        Clock::time_point last{Clock::duration(lastReceive)};
+        quality.silenceMs = std::chrono::duration<float, std::milli>(Clock::now() - last).count();
+    }
+    
+    quality.clockSynced = m_clockSynced.load(std::memory_order_relaxed);
+    quality.clockOffsetMs = m_clockOffsetMs.load(std::memory_order_relaxed);
+    quality.clockDriftPpm = m_clockDriftPpm.load(std::memory_order_relaxed);
+    quality.snapshotDelayMs = m_snapshotDelayMs.load(std::memory_order_relaxed);
+    std::int64_t stateSent = m_stateSentTicks.load(std::memory_order_relaxed);
+    if (stateSent != 0) {
+        Clock::time_point sent{Clock::duration(stateSent)};
+        quality.stateAgeMs = std::chrono::duration<float, std::milli>(Clock::now() - sent).count();
+    }
+    return quality;
+}
@@ -0,0 +1,133 @@
+#ifndef CONNECTIONMONITOR_H
+#define CONNECTIONMONITOR_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "ClockSync.h"
+#include "WireFormat.h"
+
+// Connection quality as measured from this end (see ConnectionMonitor)
+struct ConnectionQuality {
+    bool peerAlive = false;     // Heard from the peer within the timeout
+    float rttMs = 0.0f;         // Smoothed heartbeat round trip, 0 until the first pong
+    float jitterMs = 0.0f;      // Smoothed change between consecutive round trips
+    float lossRate = 0.0f;      // Share of recent pings that went unanswered (0-1)
+    float silenceMs = 0.0f;     // Since anything last arrived from the peer, 0 if never heard
+    std::uint64_t pingsSent = 0;
+    std::uint64_t pingsLost = 0;
+    std::uint64_t snapshotsReceived = 0;
+    std::uint64_t snapshotsLost = 0;  // Sequence gaps: lost, or conflated away by ZeroMQ
+    
+    // From the peer's clock and tick stamps (see ClockSync), valid once clockSynced is set
+    bool clockSynced = false;
+    float clockOffsetMs = 0.0f;    // Peer's clock minus ours (modulo 71 minutes)
+    float clockDriftPpm = 0.0f;    // How fast the peer's clock runs ahead of ours, 0 until measured
+    float snapshotDelayMs = 0.0f;  // Smoothed time from a snapshot leaving the peer to its arrival here
+    float stateAgeMs = 0.0f;       // Since the newest received snapshot left the peer, 0 if unknown
+};
+
+// Heartbeat bookkeeping and connection quality estimates
+// The network thread sends a ping every heartbeat interval and answers the peer's pings with
+// pongs. Each pong gives a round trip sample: RTT is smoothed like TCP's SRTT (gain 1/8) and
+// jitter like RTP's interarrival jitter (gain 1/16 on the change between consecutive
+// samples). A ping still unanswered after the timeout counts as lost. The peer is declared
+// dead once nothing at all (state, events or heartbeats) has arrived for the timeout - but
+// only after it was heard once, so a peer that has not started yet is not a lost connection.
+// Pings and pongs also carry the peer's clock and tick, from which a ClockSync estimates the
+// offset between the clocks and places the tick stamps of the peer's snapshots on our
+// timeline: how long they took to arrive, and how stale the newest one is.
+//
+// Everything except quality() is called from the network thread. quality() may be called
+// from any thread; its fields are read one by one, so one may be an update newer than another.
+class ConnectionMonitor {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    static constexpr std::chrono::milliseconds DEFAULT_HEARTBEAT_INTERVAL{50};
+    static constexpr std::chrono::milliseconds DEFAULT_TIMEOUT{500};
+    
+    ConnectionMonitor();
+    
+    // Setup - call before the network thread starts
+    void setHeartbeatInterval(std::chrono::milliseconds interval) { m_heartbeatInterval = interval; }
+    void setTimeout(std::chrono::milliseconds timeout) { m_timeout = timeout; }
+    void setTickDuration(std::chrono::nanoseconds tickDuration) { m_clock.setTickDuration(tickDuration); }
+    
+    // New connection: forget the peer and every estimate
+    void reset();
+    
+    // Fill in the next ping if one is due at now
+    bool preparePing(Clock::time_point now, WireFormat::Heartbeat& ping);
+    
+    // Turn the peer's ping into its pong, answered at now
+    static void preparePong(Clock::time_point now, WireFormat::Heartbeat& heartbeat);
+    
+    // Traffic from the peer; tick is the sender's tick stamp
+    void onReceive(Clock::time_point now);  // Any message
+    void onPing(const WireFormat::Heartbeat& ping, std::uint32_t tick);
+    void onPong(const WireFormat::Heartbeat& pong, std::uint32_t tick, Clock::time_point now);
+    void onSnapshots(std::uint64_t received, std::uint64_t lost);
+    void onSnapshotTick(std::uint32_t tick, Clock::time_point now);  // The newest snapshot decoded
+    
+    // The peer's tick as our time, false until the clocks are synchronized
+    bool peerTickToLocal(std::uint32_t tick, Clock::time_point now, Clock::time_point& local) const;
+    
+    // Expire unanswered pings; true once when the peer times out
+    bool update(Clock::time_point now);
+    
+    ConnectionQuality quality() const;
+
+private:
+    // Ping awaiting its pong
+    struct PendingPing {
+        std::uint32_t sequence = 0;
+        Clock::time_point sentAt;
+        bool outstanding = false;
+    };
+    
+    void resolvePing(PendingPing& ping, bool lost);
+    void publishClock(Clock::time_point now);
+    
+    // Loss rate window, one bit per answered or expired ping
+    static constexpr std::size_t LOSS_WINDOW = 64;
+    
+    // Setup
+    std::chrono::milliseconds m_heartbeatInterval;
+    std::chrono::milliseconds m_timeout;
+    
+    // Network thread only
+    std::array<PendingPing, LOSS_WINDOW> m_pending;
+    std::uint32_t m_pingSequence;   // Last ping sent
+    Clock::time_point m_nextPing;
+    Clock::time_point m_firstReceive;
+    Clock::time_point m_lastReceive;
+    bool m_peerHeard;
+    bool m_timedOut;
+    bool m_hasRtt;
+    float m_lastRttMs;              // Latest sample, for the jitter estimate
+    std::uint64_t m_lossHistory;    // Bit set per lost ping, newest in bit 0
+    std::size_t m_lossSamples;      // Valid bits in m_lossHistory
+    ClockSync m_clock;
+    bool m_hasSnapshotDelay;
+    
+    // Published for quality()
+    std::atomic<bool> m_peerAlive;
+    std::atomic<float> m_rttMs;
+    std::atomic<float> m_jitterMs;
+    std::atomic<float> m_lossRate;
+    std::atomic<std::int64_t> m_lastReceiveTicks;  // Clock ticks since epoch, 0 if never heard
+    std::atomic<std::uint64_t> m_pingsSent;
+    std::atomic<std::uint64_t> m_pingsLost;
+    std::atomic<std::uint64_t> m_snapshotsReceived;
+    std::atomic<std::uint64_t> m_snapshotsLost;
+    std::atomic<bool> m_clockSynced;
+    std::atomic<float> m_clockOffsetMs;
+    std::atomic<float> m_clockDriftPpm;
+    std::atomic<float> m_snapshotDelayMs;
+    std::atomic<std::int64_t> m_stateSentTicks;  // When the newest snapshot left the peer, our clock ticks, 0 if unknown
+};
+
+#endif // CONNECTIONMONITOR_H
@@ -10,7 +10,8 @@ namespace Constants {
     constexpr float SPACECRAFT_ROTATION_SPEED = 180.0f;  // degrees per second
     constexpr float SPACECRAFT_THRUST_ACCELERATION = 200.0f;  // pixels per second squared
     constexpr float SPACECRAFT_MAX_VELOCITY = 300.0f;  // pixels per second
-    constexpr float SPACECRAFT_FRICTION = 0.98f;  // velocity multiplier per frame (simulates friction)
+    constexpr float SPACECRAFT_FRICTION = 0.98f;  // velocity multiplier per reference frame (simulates friction)
+    constexpr float SPACECRAFT_FRICTION_RATE = 60.0f;  // reference frames per second for SPACECRAFT_FRICTION
     
     // Gravitational force
     constexpr float GRAVITATIONAL_STRENGTH = 1000.0f;  // gravitational constant (pixels^3 per second^2)
@@ -0,0 +1,125 @@
+#include "EntityRegistry.h"
+
+//----------------------------------------------------------------------------------------
+void EntityRegistry::setCapacity(std::size_t slotsPerOwner) 
+{
+    if (slotsPerOwner > Entity::MAX_SLOTS) {
+        slotsPerOwner = Entity::MAX_SLOTS;
+    }
+    m_slotsPerOwner = slotsPerOwner;
+    
+    for (Partition& partition : m_partitions) {
+        partition.index.assign(slotsPerOwner, 0);
+        partition.handle.assign(slotsPerOwner, Entity::INVALID);
+        partition.nextSlot = 0;
+        partition.generation = 0;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+EntityRegistry::Partition* EntityRegistry::partition(std::uint32_t handle) 
+{
+    if (!Entity::isProjectile(handle) || Entity::slot(handle) >= m_slotsPerOwner) {
+        return nullptr;
+    }
+    return &m_partitions[Entity::kind(handle) - 1];
+}
+
+//----------------------------------------------------------------------------------------
+const EntityRegistry::Partition* EntityRegistry::partition(std::uint32_t handle) const 
+{
+    return const_cast<EntityRegistry*>(this)->partition(handle);
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t EntityRegistry::create(int ownerPlayerId, std::size_t index) 
+{
+    if (ownerPlayerId != 1 && ownerPlayerId != 2) {
+        return Entity::INVALID;
+    }
+    Partition& owned = m_partitions[ownerPlayerId - 1];
+    
+    for (std::size_t tried = 0; tried < m_slotsPerOwner; ++tried) {
+        std::uint32_t slot = owned.nextSlot;
+        std::uint32_t generation = owned.generation;
+        if (++owned.nextSlot == m_slotsPerOwner) {
+            owned.nextSlot = 0;
+            owned.generation = (owned.generation + 1) & ((1u << Entity::GENERATION_BITS) - 1);
+        }
+        
+        // Skip slots still held, by our own projectiles or by handles inserted from elsewhere
+        if (owned.handle[slot] != Entity::INVALID) {
+            continue;
+        }
+        std::uint32_t handle = Entity::make(static_cast<std::uint32_t>(ownerPlayerId), slot, generation);
+        owned.index[slot] = static_cast<std::uint32_t>(index);
+        owned.handle[slot] = handle;
+        return handle;
+    }
+    return Entity::INVALID;
+}
+
+//----------------------------------------------------------------------------------------
+bool EntityRegistry::insert(std::uint32_t handle, std::size_t index) 
+{
+    Partition* slots = partition(handle);
+    if (!slots) {
+        return false;
+    }
+    std::uint32_t slot = Entity::slot(handle);
+    slots->index[slot] = static_cast<std::uint32_t>(index);
+    slots->handle[slot] = handle;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t EntityRegistry::occupant(std::uint32_t handle) const 
+{
+    const Partition* slots = partition(handle);
+    return slots ? slots->handle[Entity::slot(handle)] : Entity::INVALID;
+}
+
+//----------------------------------------------------------------------------------------
+std::size_t EntityRegistry::find(std::uint32_t handle) const 
+{
+    const Partition* slots = partition(handle);
+    std::uint32_t slot = Entity::slot(handle);
+    if (!slots || slots->handle[slot] != handle) {
+        return NOT_FOUND;
+    }
+    return slots->index[slot];
+}
+
+//----------------------------------------------------------------------------------------
+void EntityRegistry::move(std::uint32_t handle, std::size_t index) 
+{
+    if (Partition* slots = partition(handle)) {
+        slots->index[Entity::slot(handle)] = static_cast<std::uint32_t>(index);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void EntityRegistry::release(std::uint32_t handle) 
+{
+    Partition* slots = partition(handle);
+    if (slots && slots->handle[Entity::slot(handle)] == handle) {
+        slots->handle[Entity::slot(handle)] = Entity::INVALID;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void EntityRegistry::clearEntries(const std::uint32_t* handles, std::size_t count) 
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        release(handles[i]);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void EntityRegistry::copyCursors(const EntityRegistry& other) 
+{
+    for (std::size_t kind = 0; kind < 2; ++kind) {
+        m_partitions[kind].nextSlot = other.m_partitions[kind].nextSlot;
+        m_partitions[kind].generation = other.m_partitions[kind].generation;
+    }
+}
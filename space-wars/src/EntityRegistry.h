@@ -0,0 +1,98 @@
+#ifndef ENTITYREGISTRY_H
+#define ENTITYREGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Generational 32-bit entity handles
+// Layout: [generation:12][slot:18][kind:2]. Kind 1 and 2 are the projectiles of player 1 and
+// 2 (so the owner can be read straight from the low bits), kind 3 the two spacecraft. Each
+// player allocates projectile slots only in its own kind's range, so the handle the firing
+// peer assigns is valid unchanged on every other peer. A slot is only handed out again under
+// a new generation, so a stale handle never finds the entity that reuses its slot. 0 is never
+// a valid handle.
+namespace Entity {
+    constexpr std::uint32_t INVALID = 0;
+    constexpr int KIND_BITS = 2;
+    constexpr int SLOT_BITS = 18;
+    constexpr int GENERATION_BITS = 12;
+    constexpr std::uint32_t KIND_SPACECRAFT = 3;
+    constexpr std::size_t MAX_SLOTS = (std::size_t(1) << SLOT_BITS) - 1;
+    
+    inline std::uint32_t make(std::uint32_t kind, std::uint32_t slot, std::uint32_t generation)
+    {
+        return (generation << (KIND_BITS + SLOT_BITS)) | (slot << KIND_BITS) | kind;
+    }
+    inline std::uint32_t kind(std::uint32_t handle) { return handle & ((1u << KIND_BITS) - 1); }
+    inline std::uint32_t slot(std::uint32_t handle) { return (handle >> KIND_BITS) & ((1u << SLOT_BITS) - 1); }
+    inline std::uint32_t generation(std::uint32_t handle) { return handle >> (KIND_BITS + SLOT_BITS); }
+    
+    // Fixed spacecraft handles (playerId is 1 or 2)
+    inline std::uint32_t spacecraft(int playerId) { return make(KIND_SPACECRAFT, static_cast<std::uint32_t>(playerId), 0); }
+    inline bool isProjectile(std::uint32_t handle) { return kind(handle) == 1 || kind(handle) == 2; }
+    
+    // Player who fired a projectile, or who flies a spacecraft (0 for an invalid handle)
+    inline int ownerPlayerId(std::uint32_t handle)
+    {
+        return static_cast<int>(kind(handle) == KIND_SPACECRAFT ? slot(handle) : kind(handle));
+    }
+}
+
+// Maps projectile handles to their current index in a densely packed store (ProjectilePool)
+// Lookups and release are O(1) and nothing allocates once setCapacity() has run. Slots are
+// handed out round-robin, skipping occupied ones (few unless the pool is nearly full), with
+// the generation counting the laps: a freed slot only comes back once every other slot had
+// its turn, long after peers have seen it go. Apart from the live entries the whole state is
+// the two cursors, so the store can copy a registry in O(live entities) (see clearEntries()
+// and copyCursors()).
+class EntityRegistry {
+public:
+    static constexpr std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+    
+    // Slots per owner (allocates and clears - call during setup only)
+    void setCapacity(std::size_t slotsPerOwner);
+    std::size_t getCapacity() const { return m_slotsPerOwner; }
+    
+    // New handle for a projectile of ownerPlayerId stored at index, INVALID if out of slots
+    std::uint32_t create(int ownerPlayerId, std::size_t index);
+    
+    // Register a handle created elsewhere (by the peer that fired it) at index
+    // The handle's slot must be free (see occupant()). Returns false for a malformed handle.
+    bool insert(std::uint32_t handle, std::size_t index);
+    
+    // Handle currently holding handle's slot (any generation), INVALID if the slot is free
+    std::uint32_t occupant(std::uint32_t handle) const;
+    
+    // Index of handle, NOT_FOUND if it is invalid or stale
+    std::size_t find(std::uint32_t handle) const;
+    
+    // The entity was moved to index (swap-remove in the store)
+    void move(std::uint32_t handle, std::size_t index);
+    
+    // Free handle's slot; the handle (and all copies of it) becomes stale
+    void release(std::uint32_t handle);
+    
+    // Copying, in two halves: free the slots of handles (the live entries, as the store
+    // lists them), and continue allocating exactly where other would. Both are O(1) per
+    // handle; other must have the same capacity.
+    void clearEntries(const std::uint32_t* handles, std::size_t count);
+    void copyCursors(const EntityRegistry& other);
+
+private:
+    // Slots of one projectile kind (one owner)
+    struct Partition {
+        std::vector<std::uint32_t> index;   // Store index per slot (only valid while occupied)
+        std::vector<std::uint32_t> handle;  // Handle holding each slot, INVALID if free
+        std::uint32_t nextSlot = 0;         // Where create() looks first
+        std::uint32_t generation = 0;       // Of the handles create() makes on this lap
+    };
+    
+    Partition* partition(std::uint32_t handle);
+    const Partition* partition(std::uint32_t handle) const;
+    
+    Partition m_partitions[2];  // Kind 1 and 2
+    std::size_t m_slotsPerOwner = 0;
+};
+
+#endif // ENTITYREGISTRY_H
@@ -15,29 +15,73 @@
 
 //----------------------------------------------------------------------------------------
 Game::Game() 
-    : m_isRunning(true)
+    : m_simulation(static_cast<unsigned int>(std::time(nullptr)))  // Random seed for respawn
+    , m_isRunning(true)
     , m_isPaused(false)
     , m_localPlayerId(1)  // Will be set from config file
-    , m_networkUpdateTimer(0.0f)
+    , m_rollback(m_simulation)
+    , m_lastSentTick(0)
+    , m_lastSentAck(0)
+    , m_inputResendTimer(0.0f)
     , m_reconnectTimer(0.0f)
     , m_bothPlayersConnected(false)
-    , m_respawnTimer1(-1.0f)  // Negative means not respawning
-    , m_respawnTimer2(-1.0f)  // Negative means not respawning
-    , m_pendingRespawnPos1(0.0f, 0.0f)
-    , m_pendingRespawnPos2(0.0f, 0.0f)
+    , m_tickDuration(1.0f / 60.0f)
+    , m_tickAccumulator(0.0f)
+    , m_localTick(0)
+    , m_remoteTimeOffset(0.0)
 {
     // Initialize SFML window (1024x768, windowed mode)
     m_window.create(sf::VideoMode(sf::Vector2u(Constants::WINDOW_WIDTH, Constants::WINDOW_HEIGHT)), "Space Wars");
-    m_window.setFramerateLimit(static_cast<unsigned int>(TARGET_FPS));
     m_window.setKeyRepeatEnabled(true);  // Enable key repeat for continuous input
     
     m_lastFrameTime = std::chrono::high_resolution_clock::now();
     
-    // Initialize random seed for respawn
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
-    
     // Initialize network connection
     initializeNetwork();
+    
+    // Projectile storage is allocated once up front so the simulation never allocates per step
+    m_simulation.getGameState().setProjectileCapacity(static_cast<std::size_t>(m_networkConfig.maxProjectiles));
+    m_previousState.setProjectileCapacity(static_cast<std::size_t>(m_networkConfig.maxProjectiles));
+    m_remoteState.setProjectileCapacity(static_cast<std::size_t>(m_networkConfig.maxProjectiles));
+    if (m_networkConfig.rollback) {
+        m_rollback.setProjectileCapacity(static_cast<std::size_t>(m_networkConfig.maxProjectiles));
+    }
+    
+    // Simulation runs at a fixed tick rate; rendering is limited separately and interpolates
+    m_tickDuration = 1.0f / static_cast<float>(m_networkConfig.tickRate);
+    m_remoteSpacecraft.setDelay(static_cast<float>(m_networkConfig.interpolationDelay) / 1000.0f);
+    m_remoteSpacecraft.setExtrapolationLimit(static_cast<float>(m_networkConfig.extrapolationLimit) / 1000.0f);
+    for (InterpolationBuffer& spacecraft : m_spectatedSpacecraft) {
+        spacecraft.setDelay(static_cast<float>(m_networkConfig.interpolationDelay) / 1000.0f);
+        spacecraft.setExtrapolationLimit(static_cast<float>(m_networkConfig.extrapolationLimit) / 1000.0f);
+    }
+    if (m_networkConfig.frameRate > 0) {
+        m_window.setFramerateLimit(static_cast<unsigned int>(m_networkConfig.frameRate));
+    } else {
+        m_window.setVerticalSyncEnabled(true);
+    }
+    
+    // The local spacecraft is driven by keyboard input; the remote one is replicated from the
+    // network, or in rollback mode driven by the peer's inputs
+    int remotePlayerId = (m_localPlayerId == 1) ? 2 : 1;
+    m_simulation.setPlayerControlled(m_localPlayerId, true);
+    m_simulation.setPlayerControlled(remotePlayerId, m_networkConfig.rollback);
+    
+    // With a dedicated server we only predict movement; hits, respawns and shots are its call
+    m_simulation.setAuthoritative(!usesServer());
+    
+    if (isSpectating()) {
+        // Both spacecraft, the hits and the scores come from the stream; we only move projectiles
+        m_simulation.setPlayerControlled(1, false);
+        m_simulation.setPlayerControlled(2, false);
+        m_simulation.setAuthoritative(false);
+        m_renderer.setSpectating(true);
+    } else if (m_networkConfig.spectatorPort != 0) {
+        m_spectatorPublisher.setProjectileCapacity(static_cast<std::size_t>(m_networkConfig.maxProjectiles));
+        if (m_spectatorPublisher.open(m_networkConfig.spectatorPort)) {
+            std::cout << "Publishing the match for spectators on port " << m_networkConfig.spectatorPort << std::endl;
+        }
+    }
 }
 
 //----------------------------------------------------------------------------------------
@@ -54,13 +98,16 @@ void Game::run()
         auto deltaTime = std::chrono::duration<float>(currentTime - m_lastFrameTime).count();
         m_lastFrameTime = currentTime;
         
+        // Clamp long frames (window drag, debugger break) so we don't try to catch up forever
+        deltaTime = std::min(deltaTime, MAX_FRAME_TIME);
+        
         processInput();
         
         // Always call update - it handles network sync even when paused/waiting
-        // and only updates game logic when both players are connected
+        // and only runs simulation steps when both players are connected
         update(deltaTime);
         
-        render();
+        render(m_tickAccumulator / m_tickDuration);
     }
 }
 
@@ -80,68 +127,79 @@ void Game::processInput()
             m_inputHandler.handleEvent(*event);
         }
     }
-    
-    // Process game input (only if not paused, both players connected, game not over, and window has focus)
-    // Note: Input processing uses fixed timestep for consistency
-    if (!m_isPaused && m_bothPlayersConnected && !m_gameState.isGameOver() && m_window.hasFocus()) {
-        float fixedDeltaTime = 1.0f / TARGET_FPS;
-        m_inputHandler.processInput(m_gameState, m_localPlayerId, fixedDeltaTime);
-    }
 }
 
 //----------------------------------------------------------------------------------------
 void Game::update(float deltaTime) 
 {
-    // Network synchronization - always send/receive when connected, even when paused
-    // This allows both players to detect each other and start the game
-    if (m_networkManager.isConnected()) {
-        m_networkUpdateTimer += deltaTime;
-        if (m_networkUpdateTimer >= NETWORK_UPDATE_INTERVAL) {
-            syncNetworkState();
-            m_networkUpdateTimer = 0.0f;
-        }
-    }
-    
-    // Only update game logic if not paused and both players are connected
-    if (m_isPaused || !m_bothPlayersConnected) {
+    if (isSpectating()) {
+        updateSpectator(deltaTime);
         return;
     }
     
-    // Update game state
-    m_gameState.updateProjectiles(deltaTime);
-    m_gameState.removeInactiveProjectiles();
-    
-    // Update remote player's spacecraft (local player's is updated in InputHandler)
-    int remotePlayerId = (m_localPlayerId == 1) ? 2 : 1;
-    Spacecraft& remoteSpacecraft = m_gameState.getSpacecraft(remotePlayerId);
-    // Only update if alive
-    if (remoteSpacecraft.isAlive()) {
-        remoteSpacecraft.update(deltaTime);
+    // Network synchronization - always receive when connected, even when paused
+    // This allows both players to detect each other and start the game
+    if (m_networkManager.isConnected()) {
+        syncNetworkState();
     }
     
-    // Check collisions
-    checkCollisions();
+    // Connection handling runs even while paused, otherwise a lost connection would never
+    // get past the pause it triggers
+    updateConnection(deltaTime);
     
-    // Check win condition
-    checkWinCondition();
-    
-    // Update explosion animation
-    m_renderer.updateExplosion(deltaTime);
-    
-    // Update respawn timers
-    if (m_respawnTimer1 >= 0.0f) {
-        m_respawnTimer1 += deltaTime;
-        if (m_respawnTimer1 >= RESPAWN_DELAY) {
-            respawnSpacecraft(1, m_pendingRespawnPos1);
-            m_respawnTimer1 = -1.0f;  // Reset timer (negative = inactive)
+    // Only update game logic if not paused and both players are connected
+    if (m_isPaused || !m_bothPlayersConnected) {
+        // Nothing to interpolate while stopped - render the state as it is
+        m_tickAccumulator = 0.0f;
+        m_previousState = m_simulation.getGameState();
+    } else {
+        // Run as many fixed simulation steps as the elapsed frame time covers
+        // Leftover time stays in the accumulator and is used to interpolate rendering
+        m_tickAccumulator += deltaTime;
+        while (m_tickAccumulator >= m_tickDuration) {
+            if (m_networkConfig.rollback && !m_rollback.canAdvance()) {
+                // Too far ahead of the peer's inputs - wait for them instead of guessing further
+                m_tickAccumulator = std::min(m_tickAccumulator, m_tickDuration);
+                break;
+            }
+            tick(m_tickDuration);
+            m_tickAccumulator -= m_tickDuration;
         }
+        
+        // Update explosion animation (presentation only, runs at frame rate)
+        m_renderer.updateExplosion(deltaTime);
     }
     
-    if (m_respawnTimer2 >= 0.0f) {
-        m_respawnTimer2 += deltaTime;
-        if (m_respawnTimer2 >= RESPAWN_DELAY) {
-            respawnSpacecraft(2, m_pendingRespawnPos2);
-            m_respawnTimer2 = -1.0f;  // Reset timer (negative = inactive)
+    // Send after stepping, so the snapshot carries this frame's state and a shot or hit in
+    // these steps goes out right away
+    if (m_networkManager.isConnected()) {
+        sendNetworkState(deltaTime);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void Game::updateConnection(float deltaTime) 
+{
+    // Results of connect requests from the network thread
+    NetworkEvent event;
+    while (m_networkManager.pollEvent(event)) {
+        if (event.type == NetworkEvent::Type::Connected) {
+            m_isPaused = false;
+            m_bothPlayersConnected = false;  // Reset - need to receive message again to confirm both players
+            // Send the first message on the next update
+            m_sendScheduler.reset();
+            m_prediction.reset();
+            m_remoteSpacecraft.clear();
+            m_lastSentTick = 0;
+            m_lastSentAck = 0;
+            if (m_networkConfig.rollback) {
+                // Both peers start the match over from the same state at tick 0
+                m_rollback.reset(m_localPlayerId, m_tickDuration, m_networkConfig.rollbackFrames);
+            }
+            std::cout << "Connected! Waiting for other player..." << std::endl;
+        } else {
+            // Connection failed - will try again in RECONNECT_INTERVAL seconds
+            std::cout << "Connection failed. Will retry in " << RECONNECT_INTERVAL << " seconds..." << std::endl;
         }
     }
     
@@ -166,214 +224,280 @@ void Game::update(float deltaTime)
             if (m_reconnectTimer >= RECONNECT_INTERVAL) {
                 m_reconnectTimer = 0.0f;
                 
+                // Runs on the network thread - the outcome arrives as an event
                 std::cout << "Attempting to reconnect..." << std::endl;
-                if (m_networkManager.connect(m_networkConfig.clientIp, 
-                                             m_networkConfig.clientPort, 
-                                             m_networkConfig.hostPort)) {
-                    // Reconnection successful!
-                    m_isPaused = false;
-                    m_networkManager.resetConnectionStatus();
-                    m_bothPlayersConnected = false;  // Reset - need to receive message again to confirm both players
-                    std::cout << "Reconnected! Waiting for other player..." << std::endl;
-                } else {
-                    // Reconnection failed - will try again in RECONNECT_INTERVAL seconds
-                    std::cout << "Reconnection failed. Will retry in " << RECONNECT_INTERVAL << " seconds..." << std::endl;
-                }
+                m_networkManager.resetConnectionStatus();
+                m_networkManager.connect(m_networkConfig.clientIp, 
+                                         m_networkConfig.clientPort, 
+                                         m_networkConfig.hostPort);
             }
         }
     }
 }
 
 //----------------------------------------------------------------------------------------
-void Game::render() 
+void Game::updateSpectator(float deltaTime) 
+{
+    // Everything the stream brought since the last frame, in the order it was published
+    SpectatorFeed::Item item;
+    while ((item = m_spectatorFeed.poll()) != SpectatorFeed::Item::None) {
+        if (item == SpectatorFeed::Item::Event) {
+            handleRemoteProjectile(m_spectatorFeed.getEvent());
+        } else {
+            handleSpectatedSnapshot(m_spectatorFeed.getSnapshot());
+        }
+    }
+    
+    GameState& gameState = m_simulation.getGameState();
+    if (!m_bothPlayersConnected) {
+        // Nothing to show until the first keyframe
+        m_tickAccumulator = 0.0f;
+        m_previousState = gameState;
+        return;
+    }
+    
+    // Projectiles fly on in our own steps; both spacecraft follow the streamed states
+    m_tickAccumulator += deltaTime;
+    while (m_tickAccumulator >= m_tickDuration) {
+        m_previousState = gameState;
+        m_simulation.step({}, m_tickDuration);
+        for (int playerId = 1; playerId <= 2; ++playerId) {
+            m_spectatedSpacecraft[playerId - 1].sample(gameState.getTime(), gameState.getSpacecraft(playerId));
+        }
+        m_tickAccumulator -= m_tickDuration;
+    }
+    m_renderer.updateExplosion(deltaTime);
+}
+
+//----------------------------------------------------------------------------------------
+void Game::handleSpectatedSnapshot(const Snapshot& snapshot) 
+{
+    GameState& gameState = m_simulation.getGameState();
+    bool watching = m_bothPlayersConnected;
+    if (!watching) {
+        m_bothPlayersConnected = true;
+        std::cout << "Spectating - the match stream is live" << std::endl;
+    }
+    
+    // Track the stream's clock to place projectiles, like a peer's
+    snapshot.apply(m_remoteState);
+    m_remoteTimeOffset = m_remoteState.getTime() - gameState.getTime();
+    
+    for (int playerId = 1; playerId <= 2; ++playerId) {
+        const Spacecraft& streamed = m_remoteState.getSpacecraft(playerId);
+        Spacecraft& spacecraft = gameState.getSpacecraft(playerId);
+        m_spectatedSpacecraft[playerId - 1].push(m_remoteState.getTime(), gameState.getTime(), streamed);
+        
+        // Hits are not streamed as events; a spacecraft that was alive and no longer is was hit
+        if (watching && spacecraft.isAlive() && !streamed.isAlive()) {
+            m_renderer.triggerExplosion(streamed.getPosition());
+        }
+        spacecraft.setAlive(streamed.isAlive());
+        gameState.setScore(playerId, m_remoteState.getScore(playerId));
+    }
+    gameState.setGameOver(m_remoteState.isGameOver());
+}
+
+//----------------------------------------------------------------------------------------
+void Game::tick(float tickDuration) 
+{
+    // Keep the pre-step state so rendering can interpolate toward the new one
+    m_previousState = m_simulation.getGameState();
+    
+    // What we send from here on is stamped with this tick
+    m_networkManager.setLocalTick(++m_localTick);
+    
+    // Sample local input (only if game not over and window has focus)
+    std::array<PlayerInput, 2> inputs{};
+    if (!m_simulation.getGameState().isGameOver() && m_window.hasFocus()) {
+        inputs[m_localPlayerId - 1] = m_inputHandler.sampleInput();
+    }
+    
+    // Advance the simulation (movement, projectiles, collisions, respawns)
+    if (m_networkConfig.rollback) {
+        // Replays mispredicted ticks first; the hits below are the new tick's
+        m_rollback.advance(inputs[m_localPlayerId - 1]);
+    } else {
+        // Applied at once (predicted) and kept for replay if an authoritative host corrects us
+        m_prediction.record(inputs[m_localPlayerId - 1], tickDuration);
+        if (usesServer()) {
+            // The server fires our shots from the recorded input; they come back as spawn events
+            inputs[m_localPlayerId - 1].fire = false;
+        }
+        m_simulation.step(inputs, tickDuration);
+        
+        // The peer's spacecraft follows its received states instead of our physics
+        GameState& gameState = m_simulation.getGameState();
+        m_remoteSpacecraft.sample(gameState.getTime(), gameState.getSpacecraft((m_localPlayerId == 1) ? 2 : 1));
+    }
+    handleHits();
+    handleSpawns();
+    
+    // Check win condition
+    checkWinCondition();
+    
+    // Spectators see the match as we do (a no-op unless spectator_port is set)
+    m_spectatorPublisher.publish(m_simulation.getGameState(), m_localTick);
+}
+
+//----------------------------------------------------------------------------------------
+void Game::render(float alpha) 
 {
     m_window.clear(sf::Color::Black);
     
-    // Render game state
+    // Render game state, interpolated between the last two simulation steps
     bool connectionLost = m_networkManager.isConnectionLost();
     bool connected = m_networkManager.isConnected();
-    m_renderer.render(m_window, m_gameState, connectionLost, m_localPlayerId, connected, m_bothPlayersConnected);
+    m_renderer.render(m_window, m_previousState, m_simulation.getGameState(), alpha, m_tickDuration,
+                      connectionLost, m_localPlayerId, connected, m_bothPlayersConnected,
+                      m_networkManager.getConnectionQuality());
     
     m_window.display();
 }
 
 //----------------------------------------------------------------------------------------
-void Game::checkCollisions() {
-    const auto& projectiles = m_gameState.getProjectiles();
+void Game::handleHits() {
+    const GameState& gameState = m_simulation.getGameState();
     
-    for (const auto& projectile : projectiles) {
-        if (!projectile.isActive()) continue;
-        
-        sf::Vector2f projPos = projectile.getPosition();
-        int projOwnerId = projectile.getOwnerPlayerId();
+    for (const HitEvent& hit : m_simulation.getHitEvents()) {
+        // Trigger explosion at hit location
+        m_renderer.triggerExplosion(hit.position);
+        m_sendScheduler.requestUrgent();  // The peer should see the destroyed spacecraft at once
         
-        // Check collision with spacecraft 1
-        if (projOwnerId != 1) {
-            Spacecraft& sc1 = m_gameState.getSpacecraft(1);
-            // Don't check collision with dead spacecraft
-            if (sc1.isAlive()) {
-                sf::Vector2f sc1Pos = sc1.getPosition();
-                float distance = std::sqrt(
-                    (projPos.x - sc1Pos.x) * (projPos.x - sc1Pos.x) +
-                    (projPos.y - sc1Pos.y) * (projPos.y - sc1Pos.y)
-                );
-                
-                if (distance < Constants::SPACECRAFT_SIZE + Constants::PROJECTILE_SIZE) {
-                    handleHit(projectile, 1);
-                    return;  // Only one hit per frame
-                }
-            }
+        std::cout << "Player " << hit.shooterId << " hit Player " << hit.victimId 
+                  << "! Score: " << gameState.getScore(hit.shooterId) << std::endl;
+        if (m_networkConfig.rollback) {
+            continue;  // The peer simulates the same hit
         }
         
-        // Check collision with spacecraft 2
-        if (projOwnerId != 2) {
-            Spacecraft& sc2 = m_gameState.getSpacecraft(2);
-            // Don't check collision with dead spacecraft
-            if (sc2.isAlive()) {
-                sf::Vector2f sc2Pos = sc2.getPosition();
-                float distance = std::sqrt(
-                    (projPos.x - sc2Pos.x) * (projPos.x - sc2Pos.x) +
-                    (projPos.y - sc2Pos.y) * (projPos.y - sc2Pos.y)
-                );
-                
-                if (distance < Constants::SPACECRAFT_SIZE + Constants::PROJECTILE_SIZE) {
-                    handleHit(projectile, 2);
-                    return;  // Only one hit per frame
-                }
-            }
+        // We are authoritative for our own spacecraft - tell the peer it was destroyed.
+        // If our projectile hit the other spacecraft, tell the peer it is gone; its own
+        // simulation decides whether the spacecraft was hit.
+        GameEvent event;
+        event.shooterId = static_cast<std::uint8_t>(hit.shooterId);
+        event.projectileId = hit.projectileId;
+        if (hit.victimId == m_localPlayerId) {
+            event.type = GameEvent::Type::Hit;
+            event.victimId = static_cast<std::uint8_t>(hit.victimId);
+            event.score = static_cast<std::uint8_t>(gameState.getScore(hit.shooterId));
+            event.position = hit.position;
+            m_networkManager.sendGameEvent(event);
+        } else if (hit.shooterId == m_localPlayerId) {
+            event.type = GameEvent::Type::ProjectileDespawn;
+            m_networkManager.sendGameEvent(event);
         }
     }
 }
 
 //----------------------------------------------------------------------------------------
-void Game::handleHit(const Projectile& projectile, int hitSpacecraftId) {
-    int projectileOwnerId = projectile.getOwnerPlayerId();
-    
-    // Remove only the specific projectile that hit (not all projectiles from that player)
-    // Find and remove the projectile that matches position and owner
-    auto& projectiles = m_gameState.getProjectiles();
-    sf::Vector2f hitPos = projectile.getPosition();
-    
-    projectiles.erase(
-        std::remove_if(
-            projectiles.begin(),
-            projectiles.end(),
-            [projectileOwnerId, hitPos](const Projectile& p) {
-                // Remove the projectile that matches owner and is at the hit position
-                // Use a small epsilon for floating point comparison
-                if (p.getOwnerPlayerId() == projectileOwnerId && p.isActive()) {
-                    sf::Vector2f pPos = p.getPosition();
-                    float dist = std::sqrt(
-                        (pPos.x - hitPos.x) * (pPos.x - hitPos.x) +
-                        (pPos.y - hitPos.y) * (pPos.y - hitPos.y)
-                    );
-                    return dist < 1.0f;  // Within 1 pixel - should be the same projectile
-                }
-                return false;
-            }
-        ),
-        projectiles.end()
-    );
-    
-    // Increment score for the player who fired
-    m_gameState.incrementScore(projectileOwnerId);
-    
-    // Trigger explosion at hit location
-    Spacecraft& hitSpacecraft = m_gameState.getSpacecraft(hitSpacecraftId);
-    sf::Vector2f destructionPos = hitSpacecraft.getPosition();
-    m_renderer.triggerExplosion(destructionPos);
-    
-    // Mark spacecraft as dead
-    hitSpacecraft.setAlive(false);
-    hitSpacecraft.setVelocity(sf::Vector2f(0.0f, 0.0f));  // Stop movement
-    hitSpacecraft.setThrusting(false);  // Stop thrust animation
-    
-    // Start respawn timer
-    if (hitSpacecraftId == 1) {
-        m_respawnTimer1 = 0.0f;  // Start timer at 0
-        m_pendingRespawnPos1 = destructionPos;  // Store destruction position
-    } else {
-        m_respawnTimer2 = 0.0f;
-        m_pendingRespawnPos2 = destructionPos;
+void Game::handleSpawns() 
+{
+    // The peer simulates our projectiles from where and when they were fired; leaving the
+    // screen needs no message since both sides see it happen
+    if (m_networkConfig.rollback) {
+        return;  // The peer fires them itself from our inputs
+    }
+    for (const SpawnEvent& spawn : m_simulation.getSpawnEvents()) {
+        if (spawn.ownerPlayerId != m_localPlayerId) {
+            continue;
+        }
+        GameEvent event;
+        event.type = GameEvent::Type::ProjectileSpawn;
+        event.shooterId = static_cast<std::uint8_t>(spawn.ownerPlayerId);
+        event.projectileId = spawn.projectileId;
+        event.timeMs = static_cast<std::uint32_t>(std::llround(spawn.time * 1000.0));
+        event.position = spawn.origin;
+        event.orientation = spawn.orientation;
+        m_networkManager.sendGameEvent(event);
+        m_sendScheduler.requestUrgent();  // Fresh orientation to go with the shot
     }
-    
-    std::cout << "Player " << projectileOwnerId << " hit Player " << hitSpacecraftId 
-              << "! Score: " << m_gameState.getScore(projectileOwnerId) << std::endl;
 }
 
 //----------------------------------------------------------------------------------------
-void Game::respawnSpacecraft(int playerId, sf::Vector2f avoidPosition) {
-    Spacecraft& spacecraft = m_gameState.getSpacecraft(playerId);
-    
-    // Initial spawn positions (to avoid respawning at these)
-    sf::Vector2f initialPos1(100.0f, Constants::WINDOW_HEIGHT / 2.0f);
-    sf::Vector2f initialPos2(Constants::WINDOW_WIDTH - 100.0f, Constants::WINDOW_HEIGHT / 2.0f);
-    sf::Vector2f initialPos = (playerId == 1) ? initialPos1 : initialPos2;
-    
-    // Minimum distance to avoid respawning too close to avoided positions
-    constexpr float MIN_DISTANCE = 150.0f;
-    
-    // Try to find a valid random position (max attempts to avoid infinite loop)
-    float x, y;
-    int attempts = 0;
-    constexpr int MAX_ATTEMPTS = 100;
-    
-    do {
-        // Generate random position within screen bounds
-        // Leave some margin from edges (50 pixels)
-        x = 50.0f + static_cast<float>(std::rand() % (Constants::WINDOW_WIDTH - 100));
-        y = 50.0f + static_cast<float>(std::rand() % (Constants::WINDOW_HEIGHT - 100));
-        
-        attempts++;
-        
-        // Check distance from initial spawn position
-        float distToInitial = std::sqrt(
-            (x - initialPos.x) * (x - initialPos.x) +
-            (y - initialPos.y) * (y - initialPos.y)
-        );
+void Game::handleRemoteEvents() 
+{
+    int otherPlayerId = (m_localPlayerId == 1) ? 2 : 1;
+    
+    GameState& gameState = m_simulation.getGameState();
+    
+    GameEvent event;
+    while (m_networkManager.pollGameEvent(event)) {
+        if (event.type == GameEvent::Type::ProjectileSpawn || event.type == GameEvent::Type::ProjectileDespawn) {
+            handleRemoteProjectile(event);
+            continue;
+        }
+        if (event.type == GameEvent::Type::GameOver) {
+            if (!gameState.isGameOver()) {
+                gameState.setScore(event.shooterId, std::max<int>(gameState.getScore(event.shooterId), event.score));
+                gameState.setGameOver(true);
+            }
+            continue;
+        }
+        if (event.victimId != otherPlayerId && !usesServer()) {
+            continue;  // The peer only reports hits on its own spacecraft (a server reports all)
+        }
         
-        // Check distance from destruction position
-        float distToDestruction = std::sqrt(
-            (x - avoidPosition.x) * (x - avoidPosition.x) +
-            (y - avoidPosition.y) * (y - avoidPosition.y)
-        );
+        // Already applied if our simulation saw the same hit
+        HitEvent hit{event.shooterId, event.victimId, event.position, event.projectileId};
+        bool applied = m_simulation.applyHit(hit);
         
-        // If position is far enough from both, use it
-        if (distToInitial >= MIN_DISTANCE && distToDestruction >= MIN_DISTANCE) {
-            break;
-        }
+        // The victim's side counts the hits on it, so its score for the shooter wins (scores
+        // never go down)
+        gameState.setScore(hit.shooterId, std::max<int>(gameState.getScore(hit.shooterId), event.score));
         
-    } while (attempts < MAX_ATTEMPTS);
-    
-    // If we couldn't find a good position after max attempts, use a fallback
-    // Position on the opposite side from initial spawn
-    if (attempts >= MAX_ATTEMPTS) {
-        if (playerId == 1) {
-            // Player 1: try right side
-            x = Constants::WINDOW_WIDTH - 150.0f;
-            y = Constants::WINDOW_HEIGHT / 2.0f;
-        } else {
-            // Player 2: try left side
-            x = 150.0f;
-            y = Constants::WINDOW_HEIGHT / 2.0f;
+        if (applied) {
+            m_renderer.triggerExplosion(hit.position);
+            std::cout << "Player " << hit.shooterId << " hit Player " << hit.victimId 
+                      << "! Score: " << gameState.getScore(hit.shooterId) << std::endl;
         }
     }
+}
+
+//----------------------------------------------------------------------------------------
+void Game::handleRemoteProjectile(const GameEvent& event) 
+{
+    // The peer only reports its own projectiles (a server or spectator stream reports all),
+    // under handles from the shooter's range
+    int otherPlayerId = (m_localPlayerId == 1) ? 2 : 1;
+    bool validShooter = (usesServer() || isSpectating()) ? (event.shooterId == 1 || event.shooterId == 2)
+                                                         : event.shooterId == otherPlayerId;
+    if (!validShooter || Entity::ownerPlayerId(event.projectileId) != event.shooterId) {
+        return;
+    }
     
-    // Random orientation
-    float orientation = static_cast<float>(std::rand() % 360);
+    if (event.type == GameEvent::Type::ProjectileDespawn) {
+        m_simulation.getGameState().removeProjectile(event.projectileId);
+        return;
+    }
     
-    // Reset spacecraft at random position
-    spacecraft.reset(sf::Vector2f(x, y), orientation);
+    // Move the projectile forward by the time that has passed on the peer since it fired
+    // (the peer's clock is estimated from its latest state)
+    SpawnEvent spawn{event.projectileId, event.shooterId, event.position, event.orientation,
+                     static_cast<double>(event.timeMs) / 1000.0};
+    double peerTime = m_simulation.getGameState().getTime() + m_remoteTimeOffset;
+    float age = m_bothPlayersConnected ? static_cast<float>(std::max(0.0, peerTime - spawn.time)) : 0.0f;
+    m_simulation.spawnProjectile(spawn, age);
 }
 
 //----------------------------------------------------------------------------------------
 void Game::checkWinCondition() {
     static bool once = true;
-    if (m_gameState.hasWinner()) {
-        int winner = m_gameState.getWinner();
+    const GameState& gameState = m_simulation.getGameState();
+    if (gameState.hasWinner()) {
+        int winner = gameState.getWinner();
         if(once){
             std::cout << "Player " << winner << " wins!" << std::endl;
             once = false;
+            
+            // Make sure the peer ends the match too, even if it missed the final hit (in
+            // rollback mode it simulates the same ending, a server decides it)
+            if (!m_networkConfig.rollback && !usesServer()) {
+                GameEvent event;
+                event.type = GameEvent::Type::GameOver;
+                event.shooterId = static_cast<std::uint8_t>(winner);
+                event.score = static_cast<std::uint8_t>(gameState.getScore(winner));
+                m_networkManager.sendGameEvent(event);
+            }
         }
         // Game over state is already set in GameState
     }
@@ -384,77 +508,122 @@ void Game::syncNetworkState() {
     if (!m_networkManager.isConnected()) {
         return;
     }
+    if (m_networkConfig.rollback) {
+        syncRollbackInputs();
+        return;
+    }
     
-    // Always send local game state first (this breaks the deadlock)
-    // Both players send continuously, so they will eventually receive each other's messages
-    // Even if send fails initially (peer not ready), we keep trying - ZeroMQ will queue messages
-    // once the peer's PULL socket is bound and ready
-    m_networkManager.sendGameState(m_gameState);
+    GameState& gameState = m_simulation.getGameState();
     
-    // Process ALL queued messages, not just one (this prevents lag from message buildup)
-    // Use the latest message received (most up-to-date state)
-    GameState latestRemoteState;
-    bool receivedAny = false;
+    // Drain ALL queued messages (this prevents lag from message buildup) but only decode the
+    // latest one (most up-to-date state) into the reusable remote state
+    GameState& latestRemoteState = m_remoteState;
+    std::uint32_t inputAck = 0;
+    bool receivedAny = m_networkManager.receiveLatestGameState(latestRemoteState, inputAck);
     
-    while (true) {
-        GameState remoteState;
-        bool received = m_networkManager.receiveGameState(remoteState);
-        
-        if (!received) {
-            break;  // No more messages
-        }
-        
-        receivedAny = true;
-        latestRemoteState = remoteState;  // Keep the latest state
-        
-        // Mark that both players are now connected (we've received a message from the other player)
-        if (!m_bothPlayersConnected) {
-            m_bothPlayersConnected = true;
-            std::cout << "Player " << ((m_localPlayerId == 1) ? 2 : 1) << " has joined! Game starting..." << std::endl;
-        }
+    // Mark that both players are now connected (we've received a message from the other player)
+    if (receivedAny && !m_bothPlayersConnected) {
+        m_bothPlayersConnected = true;
+        std::cout << "Player " << ((m_localPlayerId == 1) ? 2 : 1) << " has joined! Game starting..." << std::endl;
     }
     
     // Only process if we received at least one message
     if (receivedAny) {
-        // Sync other player's spacecraft
+        // Other player's spacecraft: buffered and played back a little in the past, so it
+        // moves smoothly between states and coasts on when they are late (see tick())
         int otherPlayerId = (m_localPlayerId == 1) ? 2 : 1;
-        Spacecraft& otherSc = m_gameState.getSpacecraft(otherPlayerId);
-        const Spacecraft& remoteOtherSc = latestRemoteState.getSpacecraft(otherPlayerId);
+        m_remoteSpacecraft.push(latestRemoteState.getTime(), gameState.getTime(),
+                                latestRemoteState.getSpacecraft(otherPlayerId));
+        m_remoteSpacecraft.sample(gameState.getTime(), gameState.getSpacecraft(otherPlayerId));
         
-        // Update other player's spacecraft from remote state
-        otherSc.setPosition(remoteOtherSc.getPosition());
-        otherSc.setOrientation(remoteOtherSc.getOrientation());
-        otherSc.setVelocity(remoteOtherSc.getVelocity());
-        otherSc.setThrusting(remoteOtherSc.isThrusting());
-        
-        // Merge projectiles intelligently:
-        // - Keep local player's projectiles (they're authoritative on this side)
-        // - Replace remote player's projectiles with the latest from network
-        auto& localProjectiles = m_gameState.getProjectiles();
+        // Only an authoritative host acknowledges our inputs; then our own spacecraft is its
+        // state plus the inputs it has not simulated yet. Peer-to-peer we stay authoritative.
+        if (inputAck != 0) {
+            m_prediction.reconcile(gameState.getSpacecraft(m_localPlayerId),
+                                   latestRemoteState.getSpacecraft(m_localPlayerId), inputAck);
+        }
         
-        // Remove projectiles owned by the remote player (we'll replace them with network data)
-        localProjectiles.erase(
-            std::remove_if(
-                localProjectiles.begin(),
-                localProjectiles.end(),
-                [otherPlayerId](const Projectile& p) {
-                    return p.getOwnerPlayerId() == otherPlayerId;
-                }
-            ),
-            localProjectiles.end()
-        );
+        // Projectiles are not part of the state: they arrive as spawn and despawn events.
+        // Track the peer's clock to place them.
+        m_remoteTimeOffset = latestRemoteState.getTime() - gameState.getTime();
         
-        // Add remote player's projectiles from network state
-        for (const auto& proj : latestRemoteState.getProjectiles()) {
-            if (proj.isActive() && proj.getOwnerPlayerId() == otherPlayerId) {
-                m_gameState.addProjectile(proj);
+        if (usesServer()) {
+            // The server owns the scores, the end of the match and who is alive
+            for (int playerId = 1; playerId <= 2; ++playerId) {
+                gameState.setScore(playerId, latestRemoteState.getScore(playerId));
+                gameState.getSpacecraft(playerId).setAlive(latestRemoteState.getSpacecraft(playerId).isAlive());
             }
+            gameState.setGameOver(latestRemoteState.isGameOver());
+        } else {
+            // IMPORTANT: Only sync the OTHER player's score, not our own
+            // Our local score is authoritative - we don't overwrite it with potentially stale remote data
+            gameState.setScore(otherPlayerId, latestRemoteState.getScore(otherPlayerId));
+            // Keep our own score (m_localPlayerId) - don't overwrite it!
         }
-        
-        // IMPORTANT: Only sync the OTHER player's score, not our own
-        // Our local score is authoritative - we don't overwrite it with potentially stale remote data
-        m_gameState.setScore(otherPlayerId, latestRemoteState.getScore(otherPlayerId));
-        // Keep our own score (m_localPlayerId) - don't overwrite it!
+    }
+    
+    // Hits, projectiles and game over, reported by the peer
+    handleRemoteEvents();
+}
+
+//----------------------------------------------------------------------------------------
+void Game::sendNetworkState(float deltaTime) 
+{
+    // Both players keep sending (at least a keep-alive), which breaks the startup deadlock:
+    // each eventually receives the other's messages. A send that fails while the peer is not
+    // up yet is simply superseded by the next one.
+    if (m_networkConfig.rollback || usesServer()) {
+        sendInputs(deltaTime);
+        return;
+    }
+    const GameState& gameState = m_simulation.getGameState();
+    m_sendProbe.capture(gameState);
+    if (m_sendScheduler.update(deltaTime, m_sendProbe.contentHash(), m_networkManager.getConnectionQuality(),
+                               m_networkManager.getQueuedSnapshots())) {
+        m_networkManager.sendGameState(gameState);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void Game::syncRollbackInputs() 
+{
+    // Every message counts: each covers the inputs we had not acknowledged when it was sent
+    WireFormat::InputFrames frames;
+    bool receivedAny = false;
+    while (m_networkManager.pollInputs(frames)) {
+        m_rollback.addRemoteInputs(frames);
+        receivedAny = true;
+    }
+    
+    if (receivedAny && !m_bothPlayersConnected) {
+        m_bothPlayersConnected = true;
+        std::cout << "Player " << ((m_localPlayerId == 1) ? 2 : 1) << " has joined! Game starting..." << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void Game::sendInputs(float deltaTime) 
+{
+    // New inputs and acks go out at once. Unchanged ones are repeated now and then, so a lost
+    // message never leaves a waiting peer stuck and the peer sees us before the match starts.
+    m_inputResendTimer += deltaTime;
+    bool rollback = m_networkConfig.rollback;
+    std::uint32_t tick = rollback ? m_rollback.getCurrentTick() : m_prediction.getLatestSequence();
+    std::uint32_t ack = rollback ? m_rollback.getConfirmedTick() : m_prediction.getAcknowledged();
+    if (tick == m_lastSentTick && ack == m_lastSentAck && m_inputResendTimer < INPUT_RESEND_INTERVAL) {
+        return;
+    }
+    
+    WireFormat::InputFrames frames;
+    if (rollback) {
+        m_rollback.fillInputMessage(frames);
+    } else {
+        m_prediction.fillInputMessage(frames);
+    }
+    if (m_networkManager.sendInputs(frames)) {
+        m_lastSentTick = tick;
+        m_lastSentAck = ack;
+        m_inputResendTimer = 0.0f;
     }
 }
 
@@ -514,34 +683,47 @@ void Game::initializeNetwork() {
     std::cout << "Host Port: " << config.hostPort << std::endl;
     std::cout << "Client IP: " << config.clientIp << std::endl;
     std::cout << "Client Port: " << config.clientPort << std::endl;
-    std::cout << "You are Player: " << config.hostPlayerId << std::endl;
-    std::cout << "Connecting to Player: " << config.clientPlayerId << std::endl;
-    std::cout << "Connecting..." << std::endl;
     
     // Store configuration for reconnection attempts
     m_networkConfig = config;
     
+    if (config.spectate) {
+        // No peer to connect to: the stream arrives on the spectator feed
+        std::cout << "Spectating the match at " << config.clientIp << ":" << config.clientPort;
+        if (config.spectateMatch >= 0) {
+            std::cout << " (server match " << config.spectateMatch << ")";
+        }
+        std::cout << std::endl;
+        m_spectatorFeed.open(config.clientIp, config.clientPort, config.spectateMatch);
+        std::cout << std::endl;
+        return;
+    }
+    std::cout << "You are Player: " << config.hostPlayerId << std::endl;
+    std::cout << "Connecting to Player: " << config.clientPlayerId << std::endl;
+    std::cout << "Connecting..." << std::endl;
+    
     // Set local player ID from configuration
     m_localPlayerId = config.hostPlayerId;
     
+    // Received states hold as many projectiles as our own pool
+    m_networkManager.setProjectileCapacity(static_cast<std::size_t>(config.maxProjectiles));
+    m_networkManager.setTransportType(config.transport);
+    m_networkManager.setPlayerId(config.hostPlayerId);
+    m_networkManager.setLatencyBounded(config.latencyBounded);
+    m_networkManager.setStatsEnabled(config.networkStats);
+    m_networkManager.setHeartbeatInterval(std::chrono::milliseconds(config.heartbeatInterval));
+    m_networkManager.setConnectionTimeout(std::chrono::milliseconds(config.connectionTimeout));
+    m_networkManager.setTickDuration(std::chrono::nanoseconds(1000000000 / config.tickRate));
+    
     // Connect using configuration
     // host_ip/host_port: where this player binds (receives)
     // client_ip/client_port: where this player connects (sends)
-    if (m_networkManager.connect(config.clientIp, config.clientPort, config.hostPort)) {
-        std::cout << "Connected! Waiting for other player..." << std::endl;
-        // Reset network timer to send first message immediately on next update
-        m_networkUpdateTimer = NETWORK_UPDATE_INTERVAL;
-        // Note: We don't send immediately here because the peer's PULL socket might not be bound yet
-        // The first send will happen in the next update() call, by which time both players should be ready
-    } else {
-        std::cerr << "Failed to connect. Please check:" << std::endl;
-        std::cerr << "  1. Network configuration in " << configFile << std::endl;
-        std::cerr << "  2. Firewall settings" << std::endl;
-        std::cerr << "  3. Other player is running and ready to connect" << std::endl;
-        std::cerr << "Continuing in single-player mode. Will attempt to reconnect automatically." << std::endl;
-        // Mark as connection lost so reconnection attempts will begin
-        m_networkManager.resetConnectionStatus();  // This will be set to lost on first send attempt
-    }
+    // The sockets are set up on the network thread; updateConnection() reports the result
+    // and retries every RECONNECT_INTERVAL seconds if it fails. If it keeps failing, check:
+    //   1. Network configuration in config.txt
+    //   2. Firewall settings
+    //   3. Other player is running and ready to connect
+    m_networkManager.connect(config.clientIp, config.clientPort, config.hostPort);
     
     std::cout << std::endl;
 }
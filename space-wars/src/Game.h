@@ -3,13 +3,18 @@
 
 #include <SFML/Graphics.hpp>
 #include <chrono>
-#include "GameState.h"
+#include "Simulation.h"
 #include "InputHandler.h"
 #include "Renderer.h"
 #include "NetworkManager.h"
 #include "ConfigReader.h"
-
-class Projectile;  // Forward declaration
+#include "SendScheduler.h"
+#include "Snapshot.h"
+#include "ClientPrediction.h"
+#include "RollbackSession.h"
+#include "InterpolationBuffer.h"
+#include "SpectatorStream.h"
+#include <array>
 
 class Game {
 public:
@@ -17,26 +22,38 @@ public:
     ~Game();
     
     void run();
-    
+
 private:
     void processInput();
     void update(float deltaTime);
-    void render();
+    void tick(float tickDuration);  // Advance the simulation by one fixed step
+    void render(float alpha);  // alpha: progress from the previous to the current step (0-1)
     
     // Game logic
-    void checkCollisions();
-    void handleHit(const Projectile& projectile, int hitSpacecraftId);
-    void respawnSpacecraft(int playerId, sf::Vector2f avoidPosition);
+    void handleHits();
+    void handleSpawns();  // Report our new projectiles to the peer
     void checkWinCondition();
     
     // Network
     void initializeNetwork();
-    void syncNetworkState();
+    void syncNetworkState();  // Apply what the peer sent
+    void sendNetworkState(float deltaTime);  // Send our state when the scheduler says so
+    void syncRollbackInputs();  // Rollback mode: hand the peer's inputs to the session
+    void sendInputs(float deltaTime);  // Rollback or server mode: send our unacknowledged inputs
+    void handleRemoteEvents();  // Apply GameEvents received from the peer
+    void handleRemoteProjectile(const GameEvent& event);  // Spawn or despawn one of the peer's projectiles
+    void updateConnection(float deltaTime);  // Network events, loss detection and reconnection
+    
+    // Spectator mode (spectate=1): watch a published match instead of playing
+    void updateSpectator(float deltaTime);
+    void handleSpectatedSnapshot(const Snapshot& snapshot);
+    bool isSpectating() const { return m_networkConfig.spectate; }
     std::string findConfigFile();  // Helper to locate config.txt
+    bool usesServer() const { return m_networkConfig.transport == TransportType::Server; }  // Dedicated server owns the match
     
     // Game components
     sf::RenderWindow m_window;
-    GameState m_gameState;
+    Simulation m_simulation;
     InputHandler m_inputHandler;
     Renderer m_renderer;
     NetworkManager m_networkManager;
@@ -45,8 +62,18 @@ private:
     bool m_isRunning;
     bool m_isPaused;
     int m_localPlayerId;  // 1 or 2
-    float m_networkUpdateTimer;
-    static constexpr float NETWORK_UPDATE_INTERVAL = 1.0f / 60.0f;  // 60 updates per second (matches frame rate for lower latency)
+    SendScheduler m_sendScheduler;  // Adaptive, change-driven snapshot sending
+    Snapshot m_sendProbe;  // Our state as the peer would see it, to detect changes (reused)
+    ClientPrediction m_prediction;  // Local inputs not yet confirmed by an authoritative host
+    
+    // Rollback mode (netcode=rollback): inputs only, both spacecraft simulated here
+    RollbackSession m_rollback;
+    
+    // Input messages (rollback mode, or to a dedicated server)
+    std::uint32_t m_lastSentTick;  // Newest of our inputs in the last input message
+    std::uint32_t m_lastSentAck;   // Input ack (ours of the peer's, or the server's of ours) as of the last input message
+    float m_inputResendTimer;      // Since the last input message
+    static constexpr float INPUT_RESEND_INTERVAL = 0.1f;  // Repeat unchanged inputs this often (lost messages, startup)
     
     // Network reconnection
     NetworkConfig m_networkConfig;  // Store config for reconnection attempts
@@ -56,16 +83,23 @@ private:
     // Player connection state
     bool m_bothPlayersConnected;  // True when we've received at least one message from the other player
     
-    // Respawn system
-    float m_respawnTimer1;  // Timer for player 1 respawn
-    float m_respawnTimer2;  // Timer for player 2 respawn
-    sf::Vector2f m_pendingRespawnPos1;  // Position to respawn player 1
-    sf::Vector2f m_pendingRespawnPos2;  // Position to respawn player 2
-    static constexpr float RESPAWN_DELAY = 1.5f;  // Delay before respawning in seconds
+    // Fixed-timestep simulation
+    float m_tickDuration;  // Seconds per simulation step (1 / tick_rate)
+    float m_tickAccumulator;  // Frame time not yet consumed by simulation steps
+    std::uint32_t m_localTick;  // Steps taken, stamped on our messages
+    GameState m_previousState;  // State before the last step, for render interpolation
+    static constexpr float MAX_FRAME_TIME = 0.25f;  // Clamp long frames to avoid a spiral of catch-up steps
+    
+    // Latest state received from the peer (reused every frame so receiving does not allocate)
+    GameState m_remoteState;
+    double m_remoteTimeOffset;  // Peer's simulated time minus ours, as of its latest state
+    InterpolationBuffer m_remoteSpacecraft;  // Peer's spacecraft states, played back smoothly
     
-    // Frame rate limiting
-    static constexpr float TARGET_FPS = 60.0f;
-    static constexpr float FRAME_TIME = 1.0f / TARGET_FPS;
+    // Spectators: the stream we publish (spectator_port), or the one we watch (both
+    // spacecraft played back like the peer's)
+    SpectatorPublisher m_spectatorPublisher;
+    SpectatorFeed m_spectatorFeed;
+    std::array<InterpolationBuffer, 2> m_spectatedSpacecraft;
     
     std::chrono::high_resolution_clock::time_point m_lastFrameTime;
 };
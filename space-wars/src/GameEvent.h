@@ -0,0 +1,29 @@
+#ifndef GAMEEVENT_H
+#define GAMEEVENT_H
+
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+
+// A discrete gameplay event exchanged on the ordered event channel
+// Unlike snapshots, events are never conflated or skipped: each one is delivered once, in order.
+// Fields not used by an event's type are left at their defaults and not sent.
+struct GameEvent {
+    enum class Type : std::uint8_t {
+        Hit = 1,                // shooterId destroyed victimId's spacecraft at position with
+                                // projectileId; score is shooterId's new score
+        GameOver = 2,           // shooterId won the match with score
+        ProjectileSpawn = 3,    // shooterId fired projectileId from position towards orientation at timeMs
+        ProjectileDespawn = 4   // shooterId's projectileId was spent before leaving the screen
+    };
+    
+    Type type = Type::Hit;
+    std::uint8_t shooterId = 0;
+    std::uint8_t victimId = 0;
+    std::uint8_t score = 0;
+    sf::Vector2f position;
+    std::uint32_t projectileId = 0;
+    std::uint32_t timeMs = 0;    // Sender's simulated time
+    float orientation = 0.0f;    // Degrees
+};
+
+#endif // GAMEEVENT_H
@@ -0,0 +1,274 @@
+#include "GameServer.h"
+#include "ClockSync.h"
+#include "WireFormat.h"
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+
+//----------------------------------------------------------------------------------------
+GameServer::GameServer(int tickRate, std::size_t matchCount, std::size_t workerCount, std::size_t maxProjectiles)
+    : m_host(matchCount, workerCount, tickRate, maxProjectiles)
+    , m_clients(matchCount * 2)
+    , m_nextConnection(1)
+    , m_running(true)
+{
+    m_slotsByIdentity.reserve(matchCount * 2);
+    m_sendBuffer.reserve(64);
+    try {
+        m_context = std::make_unique<zmq::context_t>(1);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create ZeroMQ context: " << e.what() << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+GameServer::~GameServer() 
+{
+    // Close the sockets before the context
+    m_spectatorSocket.reset();
+    m_socket.reset();
+}
+
+//----------------------------------------------------------------------------------------
+bool GameServer::open(int port, int spectatorPort) 
+{
+    if (!m_context) {
+        return false;
+    }
+    
+    try {
+        m_socket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_ROUTER);
+        m_socket->set(zmq::sockopt::linger, 0);
+        m_socket->bind("tcp://*:" + std::to_string(port));
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to bind port " << port << ": " << e.what() << std::endl;
+        m_socket.reset();
+        return false;
+    }
+    
+    if (spectatorPort == 0) {
+        return true;
+    }
+    try {
+        m_spectatorSocket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PUB);
+        m_spectatorSocket->set(zmq::sockopt::linger, 0);
+        m_spectatorSocket->set(zmq::sockopt::sndhwm, SPECTATOR_HIGH_WATER_MARK);
+        m_spectatorSocket->bind("tcp://*:" + std::to_string(spectatorPort));
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to bind spectator port " << spectatorPort << ": " << e.what() << std::endl;
+        m_spectatorSocket.reset();
+        m_socket.reset();
+        return false;
+    }
+    m_host.enableSpectators();
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void GameServer::run() 
+{
+    Clock::time_point lastHousekeeping = Clock::now();
+    Clock::time_point lastStats = lastHousekeeping;
+    
+    while (m_running.load(std::memory_order_acquire)) {
+        // Ticks that are due go to the workers; whatever finished since the last pass is sent
+        Clock::time_point now = Clock::now();
+        Clock::time_point nextTick = m_host.runDueTicks(now);
+        sendMatchMessages();
+        
+        if (now - lastHousekeeping >= HOUSEKEEPING_INTERVAL) {
+            dropSilentClients(now);
+            lastHousekeeping = now;
+        }
+        if (now - lastStats >= STATS_INTERVAL) {
+            m_host.reportStats(std::cout);
+            lastStats = now;
+        }
+        
+        // Sleep until a message arrives or the next tick is due, but wake regularly while
+        // ticks are running so their snapshots and events go out soon after they finish
+        Clock::time_point wakeAt = std::min(nextTick, lastHousekeeping + HOUSEKEEPING_INTERVAL);
+        if (m_host.hasTicksInFlight()) {
+            wakeAt = std::min(wakeAt, now + FLUSH_INTERVAL);
+        }
+        std::chrono::milliseconds timeout(0);
+        if (wakeAt > now) {
+            timeout = std::chrono::ceil<std::chrono::milliseconds>(wakeAt - now);
+        }
+        zmq::pollitem_t items[] = {
+            { m_socket->handle(), 0, ZMQ_POLLIN, 0 }
+        };
+        try {
+            zmq::poll(items, 1, timeout);
+            receiveMessages();
+        } catch (const zmq::error_t& e) {
+            // A signal (stop() from a handler) interrupts the wait; the loop condition decides
+            if (e.num() != EINTR) {
+                throw;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void GameServer::receiveMessages() 
+{
+    // A ROUTER socket prefixes each message with the sender's routing ID
+    while (m_socket->recv(m_identity, zmq::recv_flags::dontwait).has_value()) {
+        if (!m_identity.more() || !m_socket->recv(m_payload, zmq::recv_flags::dontwait).has_value()) {
+            continue;
+        }
+        bool extraFrames = m_payload.more();
+        while (m_payload.more() && m_socket->recv(m_payload, zmq::recv_flags::dontwait).has_value()) {
+            // Our clients send single-frame messages; drop the rest of anything else
+        }
+        if (!extraFrames) {
+            std::string_view identity(static_cast<const char*>(m_identity.data()), m_identity.size());
+            handleMessage(identity, static_cast<const std::uint8_t*>(m_payload.data()), m_payload.size());
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void GameServer::handleMessage(std::string_view identity, const std::uint8_t* data, std::size_t size) 
+{
+    WireFormat::MessageType type;
+    if (!WireFormat::peekMessageType(data, size, type)) {
+        return;
+    }
+    if (type == WireFormat::MessageType::Join) {
+        handleJoin(identity, data, size);
+        return;
+    }
+    
+    auto found = m_slotsByIdentity.find(identity);
+    if (found == m_slotsByIdentity.end()) {
+        return;  // Not joined, or timed out
+    }
+    std::size_t slot = found->second;
+    Client& client = m_clients[slot];
+    client.lastHeard = Clock::now();
+    
+    if (type == WireFormat::MessageType::Input) {
+        // A full inbox only delays inputs: the client repeats them until they are acknowledged
+        WireFormat::InputFrames frames;
+        if (WireFormat::decodeInputFrames(data, size, frames)) {
+            m_host.getMatch(slot / 2).addInputs(static_cast<int>(slot % 2) + 1, client.connection, frames);
+        }
+    } else if (type == WireFormat::MessageType::Heartbeat) {
+        // Answer pings right away; the client measures the round trip on its own clock and
+        // synchronizes to ours and the match's tick
+        WireFormat::Heartbeat heartbeat;
+        if (WireFormat::decodeHeartbeat(data, size, heartbeat) && !heartbeat.pong) {
+            heartbeat.pong = true;
+            heartbeat.replyUs = ClockSync::timestampUs(Clock::now());
+            WireFormat::encodeHeartbeat(heartbeat, m_host.getMatch(slot / 2).getTick(), m_sendBuffer);
+            send(client.identity, m_sendBuffer.data(), m_sendBuffer.size());
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void GameServer::handleJoin(std::string_view identity, const std::uint8_t* data, std::size_t size) 
+{
+    WireFormat::Join join;
+    if (!WireFormat::decodeJoin(data, size, join) || m_slotsByIdentity.find(identity) != m_slotsByIdentity.end()) {
+        return;  // Malformed, or already joined
+    }
+    
+    int playerId = join.playerId;
+    std::size_t slot = findFreeSlot(playerId);
+    if (slot == m_clients.size()) {
+        std::cout << "No free slot for player " << playerId << ", join refused" << std::endl;
+        return;
+    }
+    
+    Client& client = m_clients[slot];
+    client.connection = m_nextConnection++;
+    if (m_nextConnection == 0) {
+        m_nextConnection = 1;  // 0 marks a free slot
+    }
+    client.identity.assign(identity);
+    client.lastHeard = Clock::now();
+    m_slotsByIdentity.emplace(client.identity, slot);
+    
+    std::size_t matchIndex = slot / 2;
+    m_host.getMatch(matchIndex).setPlayer(playerId, client.connection);
+    m_host.wake(matchIndex, client.lastHeard);
+    std::cout << "Player " << playerId << " joined match " << matchIndex << std::endl;
+}
+
+//----------------------------------------------------------------------------------------
+std::size_t GameServer::findFreeSlot(int playerId) const 
+{
+    // Complete a match where the other player is waiting, otherwise start an empty one
+    std::size_t offset = static_cast<std::size_t>(playerId - 1);
+    std::size_t firstEmpty = m_clients.size();
+    for (std::size_t slot = offset; slot < m_clients.size(); slot += 2) {
+        if (m_clients[slot].connection != 0) {
+            continue;
+        }
+        if (m_clients[slot ^ 1].connection != 0) {
+            return slot;
+        }
+        firstEmpty = std::min(firstEmpty, slot);
+    }
+    return firstEmpty;
+}
+
+//----------------------------------------------------------------------------------------
+void GameServer::dropSilentClients(Clock::time_point now) 
+{
+    for (std::size_t slot = 0; slot < m_clients.size(); ++slot) {
+        Client& client = m_clients[slot];
+        if (client.connection == 0 || now - client.lastHeard <= CLIENT_TIMEOUT) {
+            continue;
+        }
+        int playerId = static_cast<int>(slot % 2) + 1;
+        m_host.getMatch(slot / 2).setPlayer(playerId, 0);
+        m_slotsByIdentity.erase(client.identity);
+        client.connection = 0;
+        client.identity.clear();
+        std::cout << "Player " << playerId << " of match " << (slot / 2) << " timed out" << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void GameServer::sendMatchMessages() 
+{
+    for (std::size_t matchIndex = 0; matchIndex < m_host.getMatchCount(); ++matchIndex) {
+        HostedMatch& match = m_host.getMatch(matchIndex);
+        while (MatchMessage* message = match.frontMessage()) {
+            // Messages for a connection that has since left or been replaced are dropped
+            const Client& client = m_clients[matchIndex * 2 + static_cast<std::size_t>(message->playerId - 1)];
+            if (client.connection == message->connection) {
+                send(client.identity, message->data.data(), message->size);
+            }
+            match.popMessage();
+        }
+        if (m_spectatorSocket) {
+            publishSpectatorMessages(matchIndex, match);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void GameServer::send(const std::string& identity, const std::uint8_t* data, std::size_t size) 
+{
+    // A client that is gone or not keeping up simply misses the message (ROUTER drops it)
+    m_socket->send(zmq::buffer(identity.data(), identity.size()), zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+    m_socket->send(zmq::buffer(data, size), zmq::send_flags::dontwait);
+}
+
+//----------------------------------------------------------------------------------------
+void GameServer::publishSpectatorMessages(std::size_t matchIndex, HostedMatch& match) 
+{
+    // Viewers subscribe to the topic of one match; one that is not keeping up misses messages
+    // (PUB drops them whole) until its next keyframe
+    SpectatorTopic topic = spectatorTopic(matchIndex);
+    while (MatchMessage* message = match.frontSpectatorMessage()) {
+        m_spectatorSocket->send(zmq::buffer(topic.data(), topic.size()), zmq::send_flags::sndmore | zmq::send_flags::dontwait);
+        m_spectatorSocket->send(zmq::buffer(message->data.data(), message->size), zmq::send_flags::dontwait);
+        match.popSpectatorMessage();
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <zmq.hpp>
+#include "MatchHost.h"
+
+// Headless, authoritative host for many independent matches (SpaceWarsServer)
+// Clients connect a DEALER socket (ServerTransport) to the server's ROUTER socket and claim
+// a player slot with a Join message; they are paired into matches in the order they join.
+// From then on they send only their inputs. The calling thread does all socket I/O: it
+// routes inputs to the matches, answers heartbeat pings, sends what the matches produce and
+// sleeps in a poll of the socket until a message arrives or the next tick is due. The ticks
+// themselves run on a MatchHost's work-stealing worker pool. A client that stays silent for
+// CLIENT_TIMEOUT loses its slot. Optionally, every match is also published to spectators on
+// a PUB socket, each message preceded by its match's topic frame (see spectatorTopic()).
+class GameServer {
+public:
+    // workerCount threads tick up to matchCount matches at tickRate
+    GameServer(int tickRate, std::size_t matchCount, std::size_t workerCount, std::size_t maxProjectiles);
+    ~GameServer();
+    
+    // Bind the ROUTER socket on all interfaces, and the spectator PUB socket unless
+    // spectatorPort is 0; false (after reporting why) on failure
+    bool open(int port, int spectatorPort = 0);
+    
+    // Serve until stop() is called (from any thread, or a signal handler)
+    void run();
+    void stop() { m_running.store(false, std::memory_order_release); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    // One player slot of one match
+    struct Client {
+        std::uint32_t connection = 0;  // 0 while the slot is free, else unique per joined client
+        std::string identity;          // ZeroMQ routing ID of the client's DEALER socket
+        Clock::time_point lastHeard;
+    };
+    
+    // Lookup of routing IDs straight from received message bytes (no string is built)
+    struct IdentityHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view identity) const { return std::hash<std::string_view>()(identity); }
+    };
+    
+    void receiveMessages();
+    void handleMessage(std::string_view identity, const std::uint8_t* data, std::size_t size);
+    void handleJoin(std::string_view identity, const std::uint8_t* data, std::size_t size);
+    std::size_t findFreeSlot(int playerId) const;  // Slot index, m_clients.size() if none
+    void dropSilentClients(Clock::time_point now);
+    void sendMatchMessages();
+    void send(const std::string& identity, const std::uint8_t* data, std::size_t size);
+    void publishSpectatorMessages(std::size_t matchIndex, HostedMatch& match);
+    
+    MatchHost m_host;
+    std::vector<Client> m_clients;  // Match index * 2 + player - 1
+    std::unordered_map<std::string, std::size_t, IdentityHash, std::equal_to<>> m_slotsByIdentity;
+    std::uint32_t m_nextConnection;
+    std::atomic<bool> m_running;
+    
+    std::unique_ptr<zmq::context_t> m_context;
+    std::unique_ptr<zmq::socket_t> m_socket;
+    std::unique_ptr<zmq::socket_t> m_spectatorSocket;  // Only with spectators enabled
+    zmq::message_t m_identity;  // Receive messages, reused
+    zmq::message_t m_payload;
+    std::vector<std::uint8_t> m_sendBuffer;
+    
+    static constexpr std::chrono::milliseconds CLIENT_TIMEOUT{2000};
+    static constexpr std::chrono::milliseconds HOUSEKEEPING_INTERVAL{100};  // Longest sleep: timeouts, stats
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{1};  // Sleep while ticks are running, to send their results
+    static constexpr std::chrono::seconds STATS_INTERVAL{10};
+    static constexpr int SPECTATOR_HIGH_WATER_MARK = 1000;  // Per viewer; a slow viewer misses messages beyond it
+};
+
+#endif // GAMESERVER_H
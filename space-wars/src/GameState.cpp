@@ -1,12 +1,12 @@
 #include "GameState.h"
 #include "Constants.h"
-#include <algorithm>
 
 //----------------------------------------------------------------------------------------
 GameState::GameState()
     : m_score1(0)
     , m_score2(0)
     , m_gameOver(false) 
+    , m_time(0.0)
 {
     initializeSpacecraft();
 }
@@ -51,30 +51,73 @@ const Spacecraft& GameState::getSpacecraft(int playerId) const
 }
 
 //----------------------------------------------------------------------------------------
-void GameState::addProjectile(const Projectile& projectile) 
+Spacecraft* GameState::findSpacecraft(std::uint32_t handle) 
 {
-    m_projectiles.push_back(projectile);
+    if (Entity::kind(handle) != Entity::KIND_SPACECRAFT) {
+        return nullptr;
+    }
+    switch (Entity::slot(handle)) {
+        case 1: return &m_spacecraft1;
+        case 2: return &m_spacecraft2;
+        default: return nullptr;
+    }
 }
 
 //----------------------------------------------------------------------------------------
-void GameState::updateProjectiles(float deltaTime) 
+void GameState::setProjectileCapacity(std::size_t capacity) 
+{
+    m_projectiles.setCapacity(capacity);
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t GameState::addProjectile(const Projectile& projectile) 
+{
+    // The pool's registry hands out the handle; its low bits are the owner, so handles from
+    // both peers never collide
+    return m_projectiles.add(projectile);
+}
+
+//----------------------------------------------------------------------------------------
+bool GameState::removeProjectile(std::uint32_t id) 
 {
-    for (auto& projectile : m_projectiles) {
-        projectile.update(deltaTime);
+    std::size_t index = m_projectiles.find(id);
+    if (index == ProjectilePool::NOT_FOUND) {
+        return false;
     }
+    m_projectiles.remove(index);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void GameState::updateProjectiles(float deltaTime) 
+{
+    m_projectiles.update(deltaTime);
 }
 
 //----------------------------------------------------------------------------------------
 void GameState::removeInactiveProjectiles() 
 {
-    m_projectiles.erase(
-        std::remove_if(
-            m_projectiles.begin(),
-            m_projectiles.end(),
-            [](const Projectile& p) { return !p.isActive(); }
-        ),
-        m_projectiles.end()
-    );
+    m_projectiles.removeInactive();
+}
+
+//----------------------------------------------------------------------------------------
+RespawnState& GameState::getRespawnState(int playerId) 
+{
+    if (playerId == 1) {
+        return m_respawn1;
+    } else {
+        return m_respawn2;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+const RespawnState& GameState::getRespawnState(int playerId) const 
+{
+    if (playerId == 1) {
+        return m_respawn1;
+    } else {
+        return m_respawn2;
+    }
 }
 
 //----------------------------------------------------------------------------------------
@@ -147,7 +190,9 @@ void GameState::reset()
 {
     resetScores();
     m_gameOver = false;
-    m_projectiles.clear();
+    m_projectiles.clear();  // Handles go stale; a reused slot gets a new generation (see EntityRegistry.h)
+    m_respawn1 = RespawnState();
+    m_respawn2 = RespawnState();
     initializeSpacecraft();
 }
 
@@ -3,7 +3,17 @@
 
 #include "Spacecraft.h"
 #include "Projectile.h"
-#include <vector>
+#include "ProjectilePool.h"
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+// Pending respawn for one spacecraft
+struct RespawnState {
+    float timer = -1.0f;  // Seconds since destruction, negative means not respawning
+    sf::Vector2f avoidPosition;  // Destruction position to keep away from when respawning
+};
 
 class GameState {
 public:
@@ -12,13 +22,16 @@ public:
     // Spacecraft access
     Spacecraft& getSpacecraft(int playerId);  // playerId is 1 or 2
     const Spacecraft& getSpacecraft(int playerId) const;
+    Spacecraft* findSpacecraft(std::uint32_t handle);  // Entity::spacecraft() handle, nullptr if it is not one
     
     // Projectile management
-    void addProjectile(const Projectile& projectile);
+    void setProjectileCapacity(std::size_t capacity);  // Allocates - call during setup only
+    std::uint32_t addProjectile(const Projectile& projectile);  // Returns the new handle, Entity::INVALID if the pool is full
     void updateProjectiles(float deltaTime);
     void removeInactiveProjectiles();
-    const std::vector<Projectile>& getProjectiles() const { return m_projectiles; }
-    std::vector<Projectile>& getProjectiles() { return m_projectiles; }
+    bool removeProjectile(std::uint32_t id);  // O(1), returns false if no projectile has this handle
+    const ProjectilePool& getProjectiles() const { return m_projectiles; }
+    ProjectilePool& getProjectiles() { return m_projectiles; }
     
     // Score management
     int getScore(int playerId) const;  // playerId is 1 or 2
@@ -33,13 +46,30 @@ public:
     bool isGameOver() const { return m_gameOver; }
     void setGameOver(bool gameOver) { m_gameOver = gameOver; }
     
+    // Simulated seconds (advanced by Simulation::step, not reset between matches)
+    double getTime() const { return m_time; }
+    void advanceTime(float deltaTime) { m_time += deltaTime; }
+    void setTime(double time) { m_time = time; }  // For synchronization
+    
+    // Respawn state
+    RespawnState& getRespawnState(int playerId);  // playerId is 1 or 2
+    const RespawnState& getRespawnState(int playerId) const;
+    
+    // Random source for gameplay decisions (part of the state so copies replay identically)
+    std::minstd_rand& getRandom() { return m_random; }
+    void seedRandom(unsigned int seed) { m_random.seed(seed); }
+    
 private:
     Spacecraft m_spacecraft1;
     Spacecraft m_spacecraft2;
-    std::vector<Projectile> m_projectiles;
+    ProjectilePool m_projectiles;
     int m_score1;
     int m_score2;
     bool m_gameOver;
+    double m_time;
+    RespawnState m_respawn1;
+    RespawnState m_respawn2;
+    std::minstd_rand m_random;
     
     void initializeSpacecraft();
 };
@@ -1,14 +1,4 @@
 #include "InputHandler.h"
-#include "Constants.h"
-#include "Projectile.h"
-#include <cmath>
-#include <cstdlib>
-#include <ctime>
-#include <algorithm>
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
 
 //----------------------------------------------------------------------------------------
 InputHandler::InputHandler()
@@ -51,71 +41,20 @@ void InputHandler::handleEvent(const sf::Event& event)
 }
 
 //----------------------------------------------------------------------------------------
-void InputHandler::processInput(GameState& gameState, int localPlayerId, float deltaTime) 
+PlayerInput InputHandler::sampleInput() 
 {
-    // Get local player's spacecraft
-    Spacecraft& spacecraft = gameState.getSpacecraft(localPlayerId);
-    
-    // Don't process input for dead spacecraft
-    if (!spacecraft.isAlive()) {
-        return;
-    }
+    PlayerInput input;
+    input.left = m_leftPressed;
+    input.right = m_rightPressed;
+    input.thrust = m_upPressed;
     
-    // Handle spacecraft movement
-    handleSpacecraftInput(spacecraft, deltaTime);
-    
-    // Handle firing (on spacebar press, not hold)
+    // Fire on spacebar press, not hold
     if (m_spacePressed && !m_spaceWasPressed) {
-        handleFiring(gameState, localPlayerId);
+        input.fire = true;
         m_spaceWasPressed = true;
     }
-}
-
-//----------------------------------------------------------------------------------------
-void InputHandler::handleSpacecraftInput(Spacecraft& spacecraft, float deltaTime) 
-{
-    // Rotate left
-    if (m_leftPressed) {
-        spacecraft.rotateLeft(deltaTime);
-    }
-    
-    // Rotate right
-    if (m_rightPressed) {
-        spacecraft.rotateRight(deltaTime);
-    }
-    
-    // Apply thrust
-    if (m_upPressed) {
-        spacecraft.applyThrust(deltaTime);
-        spacecraft.setThrusting(true);
-    } else {
-        spacecraft.setThrusting(false);
-    }
-    
-    // Update spacecraft
-    spacecraft.update(deltaTime);
-}
-
-//----------------------------------------------------------------------------------------
-void InputHandler::handleFiring(GameState& gameState, int localPlayerId) 
-{
-    const Spacecraft& spacecraft = gameState.getSpacecraft(localPlayerId);
-    
-    // Allow multiple projectiles - just add a new one without removing existing ones
-    // Calculate projectile direction from spacecraft orientation
-    float angleRad = spacecraft.getOrientation() * M_PI / 180.0f;
-    sf::Vector2f direction(
-        std::cos(angleRad),
-        std::sin(angleRad)
-    );
-    
-    // Calculate projectile starting position (front of spacecraft)
-    float spacecraftSize = 15.0f;
-    sf::Vector2f startPosition = spacecraft.getPosition() + direction * spacecraftSize;
     
-    // Create and add projectile
-    Projectile projectile(startPosition, direction, localPlayerId);
-    gameState.addProjectile(projectile);
+    return input;
 }
 
 //----------------------------------------------------------------------------------------
@@ -3,7 +3,7 @@
 
 #include <SFML/Window/Keyboard.hpp>
 #include <SFML/Window/Event.hpp>
-#include "GameState.h"
+#include "PlayerInput.h"
 
 class InputHandler {
 public:
@@ -12,8 +12,9 @@ public:
     // Handle SFML events
     void handleEvent(const sf::Event& event);
     
-    // Process input and update game state (called every frame)
-    void processInput(GameState& gameState, int localPlayerId, float deltaTime);
+    // Sample the current key state as simulation input (called once per simulation step)
+    // The fire press is consumed by the first sample after the spacebar goes down
+    PlayerInput sampleInput();
     
     // Reset input state (for preventing repeated firing)
     void reset();
@@ -25,12 +26,6 @@ private:
     bool m_upPressed;
     bool m_spacePressed;
     bool m_spaceWasPressed;  // To detect spacebar press (not hold)
-    
-    // Handle spacecraft controls
-    void handleSpacecraftInput(Spacecraft& spacecraft, float deltaTime);
-    
-    // Handle projectile firing
-    void handleFiring(GameState& gameState, int localPlayerId);
 };
 
 #endif // INPUTHANDLER_H
@@ -0,0 +1,191 @@
+#include "InterpolationBuffer.h"
+#include "Constants.h"
+#include "Spacecraft.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float WORLD_WIDTH = static_cast<float>(Constants::WINDOW_WIDTH);
+constexpr float WORLD_HEIGHT = static_cast<float>(Constants::WINDOW_HEIGHT);
+
+// Farther than a spacecraft can fly between two states (plus slack for quantization):
+// a respawn, not movement
+constexpr float JUMP_SLACK = 50.0f;
+
+//----------------------------------------------------------------------------------------
+float unwrap(float delta, float size) 
+{
+    // Shortest way across the screen edges
+    if (delta > size / 2.0f) {
+        return delta - size;
+    }
+    if (delta < -size / 2.0f) {
+        return delta + size;
+    }
+    return delta;
+}
+
+//----------------------------------------------------------------------------------------
+float wrap(float value, float size) 
+{
+    if (value < 0.0f) {
+        return value + size;
+    }
+    if (value > size) {
+        return value - size;
+    }
+    return value;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+InterpolationBuffer::InterpolationBuffer() 
+    : m_newest(0)
+    , m_count(0)
+    , m_clockOffset(0.0)
+    , m_delay(DEFAULT_DELAY)
+    , m_extrapolationLimit(DEFAULT_EXTRAPOLATION_LIMIT)
+{
+}
+
+//----------------------------------------------------------------------------------------
+void InterpolationBuffer::clear() 
+{
+    m_newest = 0;
+    m_count = 0;
+    m_clockOffset = 0.0;
+}
+
+//----------------------------------------------------------------------------------------
+void InterpolationBuffer::push(double remoteTime, double localTime, const Spacecraft& spacecraft) 
+{
+    if (m_count > 0 && remoteTime <= at(0).time) {
+        return;  // Duplicate or out of order
+    }
+    
+    // The sender's clock runs at our rate, so the offset only moves with network delay;
+    // a large jump (peer paused or restarted) starts the estimate over
+    double offset = remoteTime - localTime;
+    if (m_count == 0 || std::abs(offset - m_clockOffset) > OFFSET_RESYNC) {
+        m_clockOffset = offset;
+    } else {
+        m_clockOffset += (offset - m_clockOffset) * OFFSET_GAIN;
+    }
+    
+    m_newest = (m_newest + 1) % SIZE;
+    State& state = m_states[m_newest];
+    state.time = remoteTime;
+    state.position = spacecraft.getPosition();
+    state.velocity = spacecraft.getVelocity();
+    state.orientation = spacecraft.getOrientation();
+    state.thrusting = spacecraft.isThrusting();
+    m_count = std::min(m_count + 1, SIZE);
+}
+
+//----------------------------------------------------------------------------------------
+bool InterpolationBuffer::sample(double localTime, Spacecraft& spacecraft) const 
+{
+    if (m_count == 0) {
+        return false;
+    }
+    
+    double time = localTime + m_clockOffset - m_delay;
+    if (time >= at(0).time) {
+        extrapolate(at(0), time, spacecraft);
+        return true;
+    }
+    
+    // Newest pair around the playback time
+    for (std::size_t age = 1; age < m_count; ++age) {
+        if (at(age).time <= time) {
+            interpolate(at(age), at(age - 1), time, spacecraft);
+            return true;
+        }
+    }
+    
+    // Further back than the buffer reaches - hold the oldest state
+    const State& oldest = at(m_count - 1);
+    interpolate(oldest, oldest, oldest.time, spacecraft);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool InterpolationBuffer::isExtrapolating(double localTime) const 
+{
+    return m_count > 0 && localTime + m_clockOffset - m_delay > at(0).time;
+}
+
+//----------------------------------------------------------------------------------------
+void InterpolationBuffer::interpolate(const State& from, const State& to, double time,
+                                      Spacecraft& spacecraft) const 
+{
+    float span = static_cast<float>(to.time - from.time);
+    sf::Vector2f delta(unwrap(to.position.x - from.position.x, WORLD_WIDTH),
+                       unwrap(to.position.y - from.position.y, WORLD_HEIGHT));
+    float maxDistance = Constants::SPACECRAFT_MAX_VELOCITY * span + JUMP_SLACK;
+    if (span <= 0.0f || delta.x * delta.x + delta.y * delta.y > maxDistance * maxDistance) {
+        // Same state, or a jump (respawn): no path in between
+        spacecraft.setPosition(from.position);
+        spacecraft.setVelocity(from.velocity);
+        spacecraft.setOrientation(from.orientation);
+        spacecraft.setThrusting(from.thrusting);
+        return;
+    }
+    
+    // Cubic Hermite basis on s in [0, 1]; tangents are the velocities scaled to the span
+    float s = std::clamp(static_cast<float>((time - from.time) / span), 0.0f, 1.0f);
+    float s2 = s * s;
+    float s3 = s2 * s;
+    float h00 = 2.0f * s3 - 3.0f * s2 + 1.0f;
+    float h10 = s3 - 2.0f * s2 + s;
+    float h01 = -2.0f * s3 + 3.0f * s2;
+    float h11 = s3 - s2;
+    sf::Vector2f end = from.position + delta;  // Unwrapped across screen edges
+    sf::Vector2f position = from.position * h00 + from.velocity * (h10 * span) + end * h01 +
+                            to.velocity * (h11 * span);
+    
+    // Derivative of the same curve, so the velocity matches the motion shown
+    float d00 = 6.0f * s2 - 6.0f * s;
+    float d10 = 3.0f * s2 - 4.0f * s + 1.0f;
+    float d01 = -d00;
+    float d11 = 3.0f * s2 - 2.0f * s;
+    sf::Vector2f velocity = (from.position * d00 + end * d01) / span + from.velocity * d10 + to.velocity * d11;
+    
+    // Orientation the short way round
+    float turn = to.orientation - from.orientation;
+    if (turn > 180.0f) {
+        turn -= 360.0f;
+    } else if (turn < -180.0f) {
+        turn += 360.0f;
+    }
+    float orientation = from.orientation + turn * s;
+    if (orientation < 0.0f) {
+        orientation += 360.0f;
+    } else if (orientation >= 360.0f) {
+        orientation -= 360.0f;
+    }
+    
+    spacecraft.setPosition(sf::Vector2f(wrap(position.x, WORLD_WIDTH), wrap(position.y, WORLD_HEIGHT)));
+    spacecraft.setVelocity(velocity);
+    spacecraft.setOrientation(orientation);
+    spacecraft.setThrusting(from.thrusting);
+}
+
+//----------------------------------------------------------------------------------------
+void InterpolationBuffer::extrapolate(const State& from, double time, Spacecraft& spacecraft) const 
+{
+    spacecraft.setPosition(from.position);
+    spacecraft.setVelocity(from.velocity);
+    spacecraft.setOrientation(from.orientation);
+    spacecraft.setThrusting(from.thrusting);
+    
+    // Coast under gravity and friction (the sender's inputs are unknown), then hold
+    float remaining = std::min(static_cast<float>(time - from.time), m_extrapolationLimit);
+    while (remaining > 0.0f) {
+        float step = std::min(remaining, EXTRAPOLATION_STEP);
+        spacecraft.update(step);
+        remaining -= step;
+    }
+}
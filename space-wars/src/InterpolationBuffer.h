@@ -0,0 +1,68 @@
+#ifndef INTERPOLATIONBUFFER_H
+#define INTERPOLATIONBUFFER_H
+
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstddef>
+
+class Spacecraft;
+
+// Timestamped states of a remote spacecraft, played back slightly in the past
+// States are stamped with the sender's simulated time. Playback runs a fixed delay behind the
+// newest state (on a smoothed estimate of the sender's clock), so there is usually a state on
+// either side: the position follows the cubic Hermite curve through both, using the
+// transmitted velocities as tangents. When the buffer runs dry (late or lost packets) the
+// newest state is dead-reckoned with the spacecraft's own gravity and friction, for up to the
+// extrapolation limit. Nothing is allocated after construction.
+class InterpolationBuffer {
+public:
+    static constexpr std::size_t SIZE = 32;  // States kept (over a second at 30 Hz)
+    static constexpr float DEFAULT_DELAY = 0.1f;                // Seconds behind the sender
+    static constexpr float DEFAULT_EXTRAPOLATION_LIMIT = 0.25f;  // Seconds of dead reckoning
+    
+    InterpolationBuffer();
+    
+    // Tuning (seconds): a longer delay covers larger send intervals and jitter, at the cost
+    // of seeing the remote spacecraft later. A delay of 0 always extrapolates.
+    void setDelay(float delay) { m_delay = delay; }
+    void setExtrapolationLimit(float limit) { m_extrapolationLimit = limit; }
+    
+    // Forget all states (new connection)
+    void clear();
+    
+    // Add the sender's spacecraft at its time remoteTime, received at our time localTime
+    // States older than the newest one are ignored.
+    void push(double remoteTime, double localTime, const Spacecraft& spacecraft);
+    
+    // Position, orientation, velocity and thrust of the remote spacecraft to show at our time
+    // localTime, written into spacecraft (other fields untouched). False if there is no state yet.
+    bool sample(double localTime, Spacecraft& spacecraft) const;
+    
+    bool isExtrapolating(double localTime) const;  // Playback is past the newest state
+
+private:
+    struct State {
+        double time = 0.0;  // Sender's simulated time
+        sf::Vector2f position;
+        sf::Vector2f velocity;
+        float orientation = 0.0f;
+        bool thrusting = false;
+    };
+    
+    const State& at(std::size_t age) const { return m_states[(m_newest + SIZE - age) % SIZE]; }  // 0 = newest
+    void interpolate(const State& from, const State& to, double time, Spacecraft& spacecraft) const;
+    void extrapolate(const State& from, double time, Spacecraft& spacecraft) const;
+    
+    std::array<State, SIZE> m_states;
+    std::size_t m_newest;  // Index of the newest state
+    std::size_t m_count;
+    double m_clockOffset;  // Smoothed sender time minus our time
+    float m_delay;
+    float m_extrapolationLimit;
+    
+    static constexpr double OFFSET_GAIN = 0.05;      // Smoothing of the clock offset per state
+    static constexpr double OFFSET_RESYNC = 0.5;     // Offset error (seconds) that resets the estimate
+    static constexpr float EXTRAPOLATION_STEP = 1.0f / 60.0f;  // Physics step while dead reckoning
+};
+
+#endif // INTERPOLATIONBUFFER_H
@@ -0,0 +1,118 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+//----------------------------------------------------------------------------------------
+JobSystem::JobSystem(std::size_t workerCount, std::size_t queueCapacity)
+    : m_queued(0)
+    , m_sleeping(0)
+    , m_running(true)
+    , m_steals(0)
+{
+    workerCount = std::max<std::size_t>(workerCount, 1);
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->ring.resize(std::max<std::size_t>(queueCapacity, 1));
+    }
+    
+    // Start the threads only once every queue exists, since any worker may steal from any other
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        m_workers[i]->thread = std::thread(&JobSystem::run, this, i);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+JobSystem::~JobSystem() 
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_running.store(false);
+    }
+    m_wake.notify_all();
+    for (std::unique_ptr<Worker>& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+bool JobSystem::push(Worker& worker, const Job& job) 
+{
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.count == worker.ring.size()) {
+        return false;
+    }
+    worker.ring[(worker.head + worker.count) % worker.ring.size()] = job;
+    worker.count++;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool JobSystem::pop(Worker& worker, Job& job) 
+{
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.count == 0) {
+        return false;
+    }
+    job = worker.ring[worker.head];
+    worker.head = (worker.head + 1) % worker.ring.size();
+    worker.count--;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool JobSystem::submit(const Job& job, std::size_t preferredWorker) 
+{
+    // Counted before it is visible, so a worker taking it at once never sees the count wrap
+    m_queued.fetch_add(1);
+    
+    // Fall back to the next queues if the preferred one is full
+    std::size_t workerCount = m_workers.size();
+    bool queued = false;
+    for (std::size_t i = 0; i < workerCount && !queued; ++i) {
+        queued = push(*m_workers[(preferredWorker + i) % workerCount], job);
+    }
+    if (!queued) {
+        m_queued.fetch_sub(1);
+        return false;
+    }
+    
+    // Pairs with the check in run(): a worker counts itself as sleeping before it looks at
+    // m_queued, so either it sees this job or we see it and wake it (under the mutex, so the
+    // notification cannot fall between its check and its wait)
+    if (m_sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wake.notify_one();
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void JobSystem::run(std::size_t index) 
+{
+    std::size_t workerCount = m_workers.size();
+    Job job;
+    
+    while (true) {
+        // Own queue first, then the others in turn starting with the next one
+        bool found = pop(*m_workers[index], job);
+        for (std::size_t i = 1; i < workerCount && !found; ++i) {
+            found = pop(*m_workers[(index + i) % workerCount], job);
+            if (found) {
+                m_steals.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        
+        if (found) {
+            m_queued.fetch_sub(1);
+            job.function(job.context);
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleeping.fetch_add(1);
+        m_wake.wait(lock, [this] { return m_queued.load() > 0 || !m_running.load(); });
+        m_sleeping.fetch_sub(1);
+        if (!m_running.load() && m_queued.load() == 0) {
+            return;
+        }
+    }
+}
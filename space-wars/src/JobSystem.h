@@ -0,0 +1,64 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads with one job queue each and work stealing
+// A job goes to the queue of the worker it prefers (so the data it touches stays in that
+// core's cache from one run to the next); a worker whose own queue is empty takes jobs from
+// the others. Queues are FIFO at both ends so the oldest job - the one closest to its
+// deadline - runs first, whoever runs it. Workers sleep while there is no work at all.
+// Jobs are a function pointer and a context pointer, and the queues are fixed-size rings,
+// so submitting never allocates.
+class JobSystem {
+public:
+    using JobFunction = void (*)(void* context);
+    
+    struct Job {
+        JobFunction function = nullptr;
+        void* context = nullptr;
+    };
+    
+    // Start workerCount threads (at least 1); each queue holds up to queueCapacity jobs
+    JobSystem(std::size_t workerCount, std::size_t queueCapacity);
+    ~JobSystem();  // Runs the jobs already queued, then joins the workers
+    
+    // Queue a job, preferably for worker preferredWorker (any value, taken modulo the worker
+    // count). Callable from any thread, including from inside a job. Returns false only if
+    // every queue is full.
+    bool submit(const Job& job, std::size_t preferredWorker);
+    
+    std::size_t getWorkerCount() const { return m_workers.size(); }
+    std::uint64_t getSteals() const { return m_steals.load(std::memory_order_relaxed); }  // Jobs run by a worker other than the preferred one
+
+private:
+    // Fixed-capacity ring of jobs guarded by a mutex (held for a few instructions)
+    struct Worker {
+        std::mutex mutex;
+        std::vector<Job> ring;
+        std::size_t head = 0;   // Oldest job
+        std::size_t count = 0;
+        std::thread thread;
+    };
+    
+    bool push(Worker& worker, const Job& job);
+    bool pop(Worker& worker, Job& job);
+    void run(std::size_t index);
+    
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<std::size_t> m_queued;    // Jobs submitted and not yet taken
+    std::atomic<std::size_t> m_sleeping;  // Workers waiting for m_wake
+    std::atomic<bool> m_running;
+    std::atomic<std::uint64_t> m_steals;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+};
+
+#endif // JOBSYSTEM_H
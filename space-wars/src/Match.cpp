@@ -0,0 +1,138 @@
+#include "Match.h"
+#include <algorithm>
+#include <cmath>
+
+//----------------------------------------------------------------------------------------
+Match::Match(unsigned int seed)
+    : m_simulation(seed)
+    , m_restartTimer(-1.0f)
+{
+    // Both spacecraft are driven by their players' inputs here
+    m_simulation.setPlayerControlled(1, true);
+    m_simulation.setPlayerControlled(2, true);
+    
+    // At most two hits, two shots and a game over per tick
+    m_events.reserve(5);
+}
+
+//----------------------------------------------------------------------------------------
+void Match::setProjectileCapacity(std::size_t capacity) 
+{
+    m_simulation.getGameState().setProjectileCapacity(capacity);
+}
+
+//----------------------------------------------------------------------------------------
+void Match::setPlayerPresent(int playerId, bool present) 
+{
+    PlayerStream& stream = m_players[playerId == 1 ? 0 : 1];
+    stream = PlayerStream();
+    stream.present = present;
+}
+
+//----------------------------------------------------------------------------------------
+void Match::addInputs(int playerId, const WireFormat::InputFrames& frames) 
+{
+    PlayerStream& stream = m_players[playerId == 1 ? 0 : 1];
+    std::uint32_t last = frames.firstTick + frames.count - 1;
+    if (!stream.present || frames.count == 0 || last <= stream.received) {
+        return;
+    }
+    
+    // Inputs between the newest received and this message were never sent again (the client
+    // only repeats its newest MAX_FRAMES) - they are lost, so skip over them
+    if (frames.firstTick > stream.received + 1) {
+        stream.consumed = std::max(stream.consumed, frames.firstTick - 1);
+    }
+    
+    for (std::uint32_t sequence = std::max(frames.firstTick, stream.received + 1); sequence <= last; ++sequence) {
+        stream.inputs[sequence % INPUT_HISTORY] = frames.inputs[sequence - frames.firstTick];
+    }
+    stream.received = last;
+}
+
+//----------------------------------------------------------------------------------------
+PlayerInput Match::nextInput(PlayerStream& stream) 
+{
+    if (stream.received - stream.consumed > MAX_BACKLOG) {
+        stream.consumed = stream.received - static_cast<std::uint32_t>(MAX_BACKLOG);
+    }
+    
+    if (stream.consumed < stream.received) {
+        stream.consumed++;
+        stream.lastInput = stream.inputs[stream.consumed % INPUT_HISTORY];
+        return PlayerInput::fromBits(stream.lastInput);
+    }
+    
+    // Late input: keep turning and thrusting as before, but never fire a shot twice
+    return PlayerInput::fromBits(static_cast<std::uint8_t>(stream.lastInput & ~PlayerInput::FIRE));
+}
+
+//----------------------------------------------------------------------------------------
+void Match::step(float deltaTime) 
+{
+    m_events.clear();
+    if (!isRunning()) {
+        return;
+    }
+    
+    GameState& gameState = m_simulation.getGameState();
+    if (gameState.isGameOver()) {
+        m_restartTimer += deltaTime;
+        if (m_restartTimer >= RESTART_DELAY) {
+            // Fresh match with the same players; the clock keeps running for the clients
+            m_simulation.reset();
+            gameState.setProjectileCapacity(gameState.getProjectiles().capacity());
+            m_restartTimer = -1.0f;
+        }
+    }
+    
+    std::array<PlayerInput, 2> inputs = { nextInput(m_players[0]), nextInput(m_players[1]) };
+    bool wasGameOver = gameState.isGameOver();
+    m_simulation.step(inputs, deltaTime);
+    collectEvents();
+    
+    if (!wasGameOver && gameState.isGameOver()) {
+        int winner = gameState.getWinner();
+        GameEvent event;
+        event.type = GameEvent::Type::GameOver;
+        event.shooterId = static_cast<std::uint8_t>(winner);
+        event.score = static_cast<std::uint8_t>(gameState.getScore(winner));
+        m_events.push_back(event);
+        m_restartTimer = 0.0f;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void Match::collectEvents() 
+{
+    const GameState& gameState = m_simulation.getGameState();
+    
+    for (const SpawnEvent& spawn : m_simulation.getSpawnEvents()) {
+        GameEvent event;
+        event.type = GameEvent::Type::ProjectileSpawn;
+        event.shooterId = static_cast<std::uint8_t>(spawn.ownerPlayerId);
+        event.projectileId = spawn.projectileId;
+        event.timeMs = static_cast<std::uint32_t>(std::llround(spawn.time * 1000.0));
+        event.position = spawn.origin;
+        event.orientation = spawn.orientation;
+        m_events.push_back(event);
+    }
+    
+    for (const HitEvent& hit : m_simulation.getHitEvents()) {
+        GameEvent event;
+        event.type = GameEvent::Type::Hit;
+        event.shooterId = static_cast<std::uint8_t>(hit.shooterId);
+        event.victimId = static_cast<std::uint8_t>(hit.victimId);
+        event.score = static_cast<std::uint8_t>(gameState.getScore(hit.shooterId));
+        event.position = hit.position;
+        event.projectileId = hit.projectileId;
+        m_events.push_back(event);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void Match::captureSnapshot(int playerId, Snapshot& snapshot) const 
+{
+    snapshot.capture(m_simulation.getGameState());
+    snapshot.inputAck = m_players[playerId == 1 ? 0 : 1].consumed;
+}
@@ -0,0 +1,69 @@
+#ifndef MATCH_H
+#define MATCH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GameEvent.h"
+#include "PlayerInput.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "WireFormat.h"
+
+// One match as run by a dedicated server: the authoritative Simulation plus the input
+// streams of both players
+// Clients number their inputs by their own tick (see ClientPrediction). Every server tick
+// consumes the next input of each player; when it has not arrived, the last one is repeated
+// without firing and the stream waits for it. A client running ahead of the server (clock
+// drift, a burst after a stall) has its oldest inputs skipped once more than MAX_BACKLOG are
+// waiting, so its latency stays bounded. The newest consumed input is the ack that goes back
+// in that player's snapshots. Nothing is allocated once setProjectileCapacity() has run.
+class Match {
+public:
+    static constexpr std::size_t MAX_BACKLOG = 6;     // Waiting inputs per player before skipping
+    static constexpr float RESTART_DELAY = 5.0f;      // Seconds from game over to the next match
+    
+    explicit Match(unsigned int seed);
+    
+    void setProjectileCapacity(std::size_t capacity);  // Allocates - call during setup only
+    
+    // A player joined (or rejoined) or left; a joining player's input stream starts over
+    void setPlayerPresent(int playerId, bool present);  // playerId is 1 or 2
+    bool isPlayerPresent(int playerId) const { return m_players[playerId == 1 ? 0 : 1].present; }
+    bool isRunning() const { return isPlayerPresent(1) && isPlayerPresent(2); }
+    
+    // Inputs received from a player (duplicates and stale messages are ignored)
+    void addInputs(int playerId, const WireFormat::InputFrames& frames);
+    
+    // Advance by one tick while both players are present; events() then holds what happened
+    void step(float deltaTime);
+    const std::vector<GameEvent>& events() const { return m_events; }
+    
+    // Current state as sent to playerId, with that player's input ack
+    void captureSnapshot(int playerId, Snapshot& snapshot) const;
+    
+    const GameState& getGameState() const { return m_simulation.getGameState(); }
+
+private:
+    static constexpr std::size_t INPUT_HISTORY = 64;  // Per player, must exceed MAX_FRAMES
+    static_assert(INPUT_HISTORY > WireFormat::InputFrames::MAX_FRAMES, "A message must fit in the ring");
+    
+    struct PlayerStream {
+        bool present = false;
+        std::uint32_t consumed = 0;  // Newest input simulated (the ack), 0 if none
+        std::uint32_t received = 0;  // Newest input received
+        std::uint8_t lastInput = 0;  // Bits of the input simulated last
+        std::array<std::uint8_t, INPUT_HISTORY> inputs{};  // Indexed by sequence % INPUT_HISTORY
+    };
+    
+    PlayerInput nextInput(PlayerStream& stream);
+    void collectEvents();
+    
+    Simulation m_simulation;
+    std::array<PlayerStream, 2> m_players;
+    std::vector<GameEvent> m_events;
+    float m_restartTimer;  // Seconds since game over, negative while playing
+};
+
+#endif // MATCH_H
@@ -0,0 +1,323 @@
+#include "MatchHost.h"
+#include "GameEvent.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+//----------------------------------------------------------------------------------------
+HostedMatch::HostedMatch(unsigned int seed, std::size_t maxProjectiles, float tickDuration,
+                         std::atomic<std::size_t>& ticksInFlight)
+    : m_match(seed)
+    , m_tickDuration(tickDuration)
+    , m_tick(0)
+    , m_session(WireFormat::newSession())
+    , m_running(false)
+    , m_currentTick(0)
+    , m_scheduled(false)
+    , m_busy(false)
+    , m_ticksInFlight(ticksInFlight)
+    , m_statTicks(0)
+    , m_statCostNs(0)
+    , m_statMaxCostNs(0)
+    , m_statMisses(0)
+    , m_statSkipped(0)
+    , m_statDropped(0)
+{
+    m_match.setProjectileCapacity(maxProjectiles);
+    m_encodeBuffer.reserve(MatchMessage::MAX_SIZE);
+}
+
+//----------------------------------------------------------------------------------------
+void HostedMatch::setPlayer(int playerId, std::uint32_t connection) 
+{
+    m_connections[playerId == 1 ? 0 : 1].store(connection, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------
+void HostedMatch::enableSpectators() 
+{
+    m_spectators = std::make_unique<SpectatorEncoder>(static_cast<SpectatorSink&>(*this));
+    m_spectators->setProjectileCapacity(m_match.getGameState().getProjectiles().capacity());
+    m_spectatorOutbox = std::make_unique<SpectatorOutbox>();
+}
+
+//----------------------------------------------------------------------------------------
+bool HostedMatch::addInputs(int playerId, std::uint32_t connection, const WireFormat::InputFrames& frames) 
+{
+    MatchInput* input = m_inbox.prepare();
+    if (!input) {
+        return false;
+    }
+    input->playerId = playerId;
+    input->connection = connection;
+    input->frames = frames;
+    m_inbox.publish();
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+HostedMatch::TickStats HostedMatch::takeStats() 
+{
+    TickStats stats;
+    stats.ticks = m_statTicks.exchange(0, std::memory_order_relaxed);
+    std::int64_t costNs = m_statCostNs.exchange(0, std::memory_order_relaxed);
+    stats.maxCostUs = static_cast<double>(m_statMaxCostNs.exchange(0, std::memory_order_relaxed)) / 1000.0;
+    stats.misses = m_statMisses.exchange(0, std::memory_order_relaxed);
+    stats.skipped = m_statSkipped.exchange(0, std::memory_order_relaxed);
+    stats.dropped = m_statDropped.exchange(0, std::memory_order_relaxed);
+    if (stats.ticks > 0) {
+        stats.averageCostUs = static_cast<double>(costNs) / 1000.0 / static_cast<double>(stats.ticks);
+    }
+    return stats;
+}
+
+//----------------------------------------------------------------------------------------
+void HostedMatch::tickJob(void* context) 
+{
+    static_cast<HostedMatch*>(context)->tick();
+}
+
+//----------------------------------------------------------------------------------------
+void HostedMatch::tick() 
+{
+    Clock::time_point start = Clock::now();
+    
+    // Players that joined or left since the last tick; a new connection starts its input
+    // stream and snapshot numbering over
+    for (int playerId = 1; playerId <= 2; ++playerId) {
+        std::uint32_t connection = m_connections[playerId - 1].load(std::memory_order_acquire);
+        if (connection != m_appliedConnections[playerId - 1]) {
+            m_appliedConnections[playerId - 1] = connection;
+            m_sendSequences[playerId - 1] = 0;
+            m_match.setPlayerPresent(playerId, connection != 0);
+        }
+    }
+    
+    // Inputs from an earlier connection of the same slot are dropped
+    while (MatchInput* input = m_inbox.front()) {
+        if (input->connection == m_appliedConnections[input->playerId - 1]) {
+            m_match.addInputs(input->playerId, input->frames);
+        }
+        m_inbox.pop();
+    }
+    
+    m_match.step(m_tickDuration);
+    m_running.store(m_match.isRunning(), std::memory_order_relaxed);
+    std::uint32_t tick = static_cast<std::uint32_t>(++m_tick);
+    m_currentTick.store(tick, std::memory_order_relaxed);
+    
+    for (const GameEvent& event : m_match.events()) {
+        WireFormat::encodeGameEvent(event, tick, m_encodeBuffer);
+        post(1, m_encodeBuffer);
+        post(2, m_encodeBuffer);
+    }
+    
+    // Full snapshots: clients send only inputs, so there is no acknowledged baseline
+    if (m_match.isRunning() && m_tick % SNAPSHOT_INTERVAL == 0) {
+        for (int playerId = 1; playerId <= 2; ++playerId) {
+            m_match.captureSnapshot(playerId, m_snapshot);
+            m_snapshot.sequence = ++m_sendSequences[playerId - 1];
+            WireFormat::encodeSnapshotDelta(nullptr, m_snapshot, m_session, 0, tick, m_encodeBuffer);
+            post(playerId, m_encodeBuffer);
+        }
+    }
+    
+    if (m_spectators) {
+        m_spectators->publish(m_match.getGameState(), tick);
+    }
+    
+    // A tick that ends after the next one was due delays that one
+    Clock::time_point end = Clock::now();
+    std::int64_t costNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    m_statTicks.fetch_add(1, std::memory_order_relaxed);
+    m_statCostNs.fetch_add(costNs, std::memory_order_relaxed);
+    if (costNs > m_statMaxCostNs.load(std::memory_order_relaxed)) {
+        m_statMaxCostNs.store(costNs, std::memory_order_relaxed);
+    }
+    if (end - m_due > std::chrono::duration<float>(m_tickDuration)) {
+        m_statMisses.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    // Last: from here on the I/O thread may queue the next tick
+    m_busy.store(false, std::memory_order_release);
+    m_ticksInFlight.fetch_sub(1, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------------------
+void HostedMatch::post(int playerId, const std::vector<std::uint8_t>& buffer) 
+{
+    std::uint32_t connection = m_appliedConnections[playerId - 1];
+    if (connection == 0) {
+        return;
+    }
+    MatchMessage* message = m_outbox.prepare();
+    if (!message || buffer.size() > MatchMessage::MAX_SIZE) {
+        m_statDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    message->playerId = playerId;
+    message->connection = connection;
+    message->size = buffer.size();
+    std::memcpy(message->data.data(), buffer.data(), buffer.size());
+    m_outbox.publish();
+}
+
+//----------------------------------------------------------------------------------------
+void HostedMatch::sendSpectatorMessage(const std::uint8_t* data, std::size_t size) 
+{
+    MatchMessage* message = m_spectatorOutbox->prepare();
+    if (!message || size > MatchMessage::MAX_SIZE) {
+        m_statDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    message->playerId = 0;
+    message->connection = 0;
+    message->size = size;
+    std::memcpy(message->data.data(), data, size);
+    m_spectatorOutbox->publish();
+}
+
+//----------------------------------------------------------------------------------------
+MatchHost::MatchHost(std::size_t matchCount, std::size_t workerCount, int tickRate, std::size_t maxProjectiles)
+    : m_ticksInFlight(0)
+    , m_tickDuration(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate)))
+    , m_jobs(workerCount, matchCount)
+{
+    // Every match has at most one schedule entry and one queued job, so nothing grows later
+    std::vector<ScheduleEntry> schedule;
+    schedule.reserve(matchCount);
+    m_schedule = decltype(m_schedule)(std::greater<ScheduleEntry>(), std::move(schedule));
+    m_reportOrder.reserve(matchCount);
+    m_reportStats.resize(matchCount);
+    
+    float tickDuration = 1.0f / static_cast<float>(tickRate);
+    for (std::size_t i = 0; i < matchCount; ++i) {
+        unsigned int seed = static_cast<unsigned int>(std::time(nullptr)) + static_cast<unsigned int>(i) * 7919u;
+        m_matches.push_back(std::make_unique<HostedMatch>(seed, maxProjectiles, tickDuration, m_ticksInFlight));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void MatchHost::enableSpectators() 
+{
+    for (std::unique_ptr<HostedMatch>& match : m_matches) {
+        match->enableSpectators();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void MatchHost::wake(std::size_t index, Clock::time_point now) 
+{
+    HostedMatch& match = *m_matches[index];
+    if (!match.m_scheduled) {
+        match.m_scheduled = true;
+        m_schedule.push(ScheduleEntry{now, index});
+    }
+}
+
+//----------------------------------------------------------------------------------------
+MatchHost::Clock::time_point MatchHost::runDueTicks(Clock::time_point now) 
+{
+    while (!m_schedule.empty() && m_schedule.top().due <= now) {
+        ScheduleEntry entry = m_schedule.top();
+        m_schedule.pop();
+        HostedMatch& match = *m_matches[entry.index];
+        
+        // Asleep until a player joins again. The tick that would apply the departure is not
+        // needed: the next tick applies all connection changes at once.
+        if (!match.hasPlayers()) {
+            match.m_scheduled = false;
+            continue;
+        }
+        
+        if (match.m_busy.load(std::memory_order_acquire)) {
+            // Still running the previous tick - skip this one rather than queue a second tick
+            match.m_statSkipped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            match.m_due = entry.due;
+            match.m_busy.store(true, std::memory_order_relaxed);
+            m_ticksInFlight.fetch_add(1, std::memory_order_relaxed);
+            if (!m_jobs.submit(JobSystem::Job{&HostedMatch::tickJob, &match}, entry.index)) {
+                match.m_busy.store(false, std::memory_order_relaxed);
+                m_ticksInFlight.fetch_sub(1, std::memory_order_relaxed);
+                match.m_statSkipped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        
+        // Fixed rate, without a burst of catch-up ticks after a long stall
+        entry.due += m_tickDuration;
+        if (now - entry.due > MAX_LAG) {
+            entry.due = now;
+        }
+        m_schedule.push(entry);
+    }
+    return m_schedule.empty() ? Clock::time_point::max() : m_schedule.top().due;
+}
+
+//----------------------------------------------------------------------------------------
+void MatchHost::reportStats(std::ostream& out) 
+{
+    std::size_t running = 0;
+    std::size_t waiting = 0;
+    HostedMatch::TickStats total;
+    double totalCostUs = 0.0;
+    m_reportOrder.clear();
+    
+    for (std::size_t i = 0; i < m_matches.size(); ++i) {
+        HostedMatch& match = *m_matches[i];
+        HostedMatch::TickStats& stats = m_reportStats[i];
+        stats = match.takeStats();
+        if (match.isRunning()) {
+            running++;
+        } else if (match.hasPlayers()) {
+            waiting++;
+        }
+        
+        total.ticks += stats.ticks;
+        total.misses += stats.misses;
+        total.skipped += stats.skipped;
+        total.dropped += stats.dropped;
+        total.maxCostUs = std::max(total.maxCostUs, stats.maxCostUs);
+        totalCostUs += stats.averageCostUs * static_cast<double>(stats.ticks);
+        if (stats.ticks > 0) {
+            m_reportOrder.emplace_back(stats.maxCostUs, i);
+        }
+    }
+    if (total.ticks > 0) {
+        total.averageCostUs = totalCostUs / static_cast<double>(total.ticks);
+    }
+    
+    std::ios_base::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(1);
+    out << "Matches: " << running << " running, " << waiting << " waiting | " << m_jobs.getWorkerCount()
+        << " workers, " << m_jobs.getSteals() << " steals | ";
+    printStats(out, total);
+    
+    // Every match that fell behind, then the most expensive ones by their slowest tick
+    for (std::size_t i = 0; i < m_matches.size(); ++i) {
+        const HostedMatch::TickStats& stats = m_reportStats[i];
+        if (stats.misses > 0 || stats.skipped > 0 || stats.dropped > 0) {
+            out << "  match " << i << ": ";
+            printStats(out, stats);
+        }
+    }
+    std::size_t top = std::min(REPORT_TOP, m_reportOrder.size());
+    std::partial_sort(m_reportOrder.begin(), m_reportOrder.begin() + static_cast<std::ptrdiff_t>(top),
+                      m_reportOrder.end(), std::greater<>());
+    for (std::size_t i = 0; i < top; ++i) {
+        out << "  slowest match " << m_reportOrder[i].second << ": ";
+        printStats(out, m_reportStats[m_reportOrder[i].second]);
+    }
+    out.flags(flags);
+}
+
+//----------------------------------------------------------------------------------------
+void MatchHost::printStats(std::ostream& out, const HostedMatch::TickStats& stats) 
+{
+    out << stats.ticks << " ticks, cost avg " << stats.averageCostUs << " us max " << stats.maxCostUs
+        << " us, deadline misses " << stats.misses << ", skipped " << stats.skipped
+        << ", dropped messages " << stats.dropped << std::endl;
+}
@@ -0,0 +1,182 @@
+#ifndef MATCHHOST_H
+#define MATCHHOST_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <queue>
+#include <vector>
+#include "JobSystem.h"
+#include "Match.h"
+#include "Snapshot.h"
+#include "SpectatorEncoder.h"
+#include "SpscQueue.h"
+#include "WireFormat.h"
+
+// Inputs received for one player of a hosted match
+struct MatchInput {
+    int playerId = 0;
+    std::uint32_t connection = 0;  // Player connection they came from (see HostedMatch::setPlayer)
+    WireFormat::InputFrames frames;
+};
+
+// Encoded message from a hosted match to one of its players, or to its spectators
+struct MatchMessage {
+    static constexpr std::size_t MAX_SIZE = 64;  // Snapshots and events are well under this
+    int playerId = 0;              // 0 for the spectator stream
+    std::uint32_t connection = 0;  // Player connection it is meant for; dropped if that has changed
+    std::size_t size = 0;
+    std::array<std::uint8_t, MAX_SIZE> data{};
+};
+
+// One Match as run by a MatchHost, with the queues between it and the server's I/O thread
+// The I/O thread sets the players' connections and queues their inputs; each tick runs as a
+// job on whichever worker is free, applies what was queued, steps the match and queues the
+// resulting snapshots and events for the I/O thread to send. At most one tick of a match
+// runs at a time, so the Match itself needs no locking. With spectators enabled, each tick
+// also encodes the match's spectator stream into a second, larger outbox.
+class HostedMatch : private SpectatorSink {
+public:
+    HostedMatch(unsigned int seed, std::size_t maxProjectiles, float tickDuration, std::atomic<std::size_t>& ticksInFlight);
+    
+    // I/O thread: connection is a nonzero ID that is new for every client connection, 0 when
+    // the slot is empty. The match picks the change up on its next tick.
+    void setPlayer(int playerId, std::uint32_t connection);
+    std::uint32_t getPlayer(int playerId) const { return m_connections[playerId == 1 ? 0 : 1].load(std::memory_order_relaxed); }
+    bool hasPlayers() const { return getPlayer(1) != 0 || getPlayer(2) != 0; }
+    
+    // I/O thread: queue inputs for the next tick, false if the queue is full (the client
+    // repeats unacknowledged inputs, so they are not lost)
+    bool addInputs(int playerId, std::uint32_t connection, const WireFormat::InputFrames& frames);
+    
+    // I/O thread: messages to send, oldest first
+    MatchMessage* frontMessage() { return m_outbox.front(); }
+    void popMessage() { m_outbox.pop(); }
+    
+    // Setup, before the first tick: also encode the match for spectators (allocates)
+    void enableSpectators();
+    
+    // I/O thread: spectator stream messages to publish, oldest first (none unless enabled)
+    MatchMessage* frontSpectatorMessage() { return m_spectatorOutbox ? m_spectatorOutbox->front() : nullptr; }
+    void popSpectatorMessage() { m_spectatorOutbox->pop(); }
+    
+    // Tick cost and deadline statistics since the last call (I/O thread)
+    struct TickStats {
+        std::uint64_t ticks = 0;
+        double averageCostUs = 0.0;
+        double maxCostUs = 0.0;
+        std::uint64_t misses = 0;    // Ticks that finished after the next one was due
+        std::uint64_t skipped = 0;   // Ticks not run because the previous one was still running
+        std::uint64_t dropped = 0;   // Messages dropped because an outbox was full
+    };
+    TickStats takeStats();
+    bool isRunning() const { return m_running.load(std::memory_order_relaxed); }  // Both players present, as of the last tick
+    std::uint32_t getTick() const { return m_currentTick.load(std::memory_order_relaxed); }  // Stamped on its messages
+
+private:
+    friend class MatchHost;
+    
+    static void tickJob(void* context);
+    void tick();
+    void post(int playerId, const std::vector<std::uint8_t>& buffer);
+    void sendSpectatorMessage(const std::uint8_t* data, std::size_t size) override;
+    
+    using Clock = std::chrono::steady_clock;
+    static constexpr int SNAPSHOT_INTERVAL = 2;  // Ticks between snapshots (30 per second at 60 ticks)
+    
+    // A keyframe is followed by a spawn for every projectile in flight; more than this in one
+    // tick are dropped (and reach viewers with a later keyframe, if there are fewer by then)
+    static constexpr std::size_t SPECTATOR_OUTBOX_SIZE = 256;
+    using SpectatorOutbox = SpscQueue<MatchMessage, SPECTATOR_OUTBOX_SIZE>;
+    
+    // Tick job only
+    Match m_match;
+    float m_tickDuration;
+    std::uint64_t m_tick;  // Ticks run, with or without players
+    std::uint32_t m_session;  // Snapshot session, one numbering per player for the match's life
+    std::array<std::uint32_t, 2> m_appliedConnections{};  // As of the last tick
+    std::array<std::uint32_t, 2> m_sendSequences{};       // Last snapshot sent to each player
+    Snapshot m_snapshot;
+    std::vector<std::uint8_t> m_encodeBuffer;
+    std::unique_ptr<SpectatorEncoder> m_spectators;  // Only with spectators enabled
+    
+    // Shared with the I/O thread
+    std::array<std::atomic<std::uint32_t>, 2> m_connections{};
+    SpscQueue<MatchInput, 32> m_inbox;
+    SpscQueue<MatchMessage, 64> m_outbox;
+    std::unique_ptr<SpectatorOutbox> m_spectatorOutbox;
+    std::atomic<bool> m_running;
+    std::atomic<std::uint32_t> m_currentTick;
+    
+    // Scheduling (MatchHost, on the I/O thread)
+    bool m_scheduled;               // Has an entry in the tick schedule
+    Clock::time_point m_due;        // When the tick being run was due (read by the job)
+    std::atomic<bool> m_busy;       // A tick job is queued or running
+    std::atomic<std::size_t>& m_ticksInFlight;
+    
+    // Statistics, written by the tick job, taken by the I/O thread
+    std::atomic<std::uint64_t> m_statTicks;
+    std::atomic<std::int64_t> m_statCostNs;
+    std::atomic<std::int64_t> m_statMaxCostNs;
+    std::atomic<std::uint64_t> m_statMisses;
+    std::atomic<std::uint64_t> m_statSkipped;
+    std::atomic<std::uint64_t> m_statDropped;
+};
+
+// Runs the ticks of many independent matches on a work-stealing JobSystem
+// Each match with at least one player has its next tick due one tick duration after the
+// previous one; runDueTicks() queues the ticks that are due as jobs, each match preferring
+// the same worker every tick (idle workers steal the rest). A match without players is
+// taken off the schedule and costs nothing until wake() puts it back (a player joined).
+// Matches, their queues and projectile pools are all allocated up front.
+class MatchHost {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    MatchHost(std::size_t matchCount, std::size_t workerCount, int tickRate, std::size_t maxProjectiles);
+    
+    std::size_t getMatchCount() const { return m_matches.size(); }
+    HostedMatch& getMatch(std::size_t index) { return *m_matches[index]; }
+    
+    // Setup: encode every match's spectator stream as well (see HostedMatch::enableSpectators)
+    void enableSpectators();
+    
+    // Put a match that has players back on the schedule, its first tick due now
+    void wake(std::size_t index, Clock::time_point now);
+    
+    // Queue the ticks due by now; returns when the next one is due (time_point::max() if none)
+    Clock::time_point runDueTicks(Clock::time_point now);
+    
+    // True while tick jobs are queued or running (their messages will need sending soon)
+    bool hasTicksInFlight() const { return m_ticksInFlight.load(std::memory_order_acquire) > 0; }
+    
+    // Print the tick statistics since the last report: totals, then every match that
+    // missed a deadline and the most expensive matches
+    void reportStats(std::ostream& out);
+
+private:
+    struct ScheduleEntry {
+        Clock::time_point due;
+        std::size_t index;
+        bool operator>(const ScheduleEntry& other) const { return due > other.due; }
+    };
+    
+    static void printStats(std::ostream& out, const HostedMatch::TickStats& stats);
+    
+    static constexpr std::chrono::milliseconds MAX_LAG{250};  // Further behind than this restarts the schedule from now
+    static constexpr std::size_t REPORT_TOP = 3;
+    
+    std::atomic<std::size_t> m_ticksInFlight;
+    std::vector<std::unique_ptr<HostedMatch>> m_matches;
+    std::priority_queue<ScheduleEntry, std::vector<ScheduleEntry>, std::greater<ScheduleEntry>> m_schedule;
+    Clock::duration m_tickDuration;
+    std::vector<HostedMatch::TickStats> m_reportStats;         // Reused by reportStats
+    std::vector<std::pair<double, std::size_t>> m_reportOrder;  // (slowest tick, match), reused by reportStats
+    JobSystem m_jobs;  // Declared last: its workers are joined before the matches go away
+};
+
+#endif // MATCHHOST_H
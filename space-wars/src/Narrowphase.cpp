@@ -0,0 +1,74 @@
+#include "Narrowphase.h"
+#include "SimdKernels.h"
+#include <algorithm>
+
+//----------------------------------------------------------------------------------------
+void Narrowphase::clear() 
+{
+    m_projectileX.clear();
+    m_projectileY.clear();
+    m_spacecraftX.clear();
+    m_spacecraftY.clear();
+    m_projectileIndex.clear();
+    m_shooterId.clear();
+    m_victimId.clear();
+}
+
+//----------------------------------------------------------------------------------------
+void Narrowphase::addCandidate(std::uint32_t projectileIndex, sf::Vector2f projectilePosition, int shooterId,
+                               int victimId, sf::Vector2f spacecraftPosition) 
+{
+    m_projectileX.push_back(projectilePosition.x);
+    m_projectileY.push_back(projectilePosition.y);
+    m_spacecraftX.push_back(spacecraftPosition.x);
+    m_spacecraftY.push_back(spacecraftPosition.y);
+    m_projectileIndex.push_back(projectileIndex);
+    m_shooterId.push_back(static_cast<std::uint8_t>(shooterId));
+    m_victimId.push_back(static_cast<std::uint8_t>(victimId));
+}
+
+//----------------------------------------------------------------------------------------
+void Narrowphase::findContacts(float radius, std::vector<Contact>& contacts) 
+{
+    contacts.clear();
+    const std::size_t count = m_projectileX.size();
+    if (count == 0) {
+        return;
+    }
+    
+    // Test every candidate pair in one batch
+    m_hits.resize(count);
+    SimdKernels::overlapMask(m_projectileX.data(), m_projectileY.data(),
+                             m_spacecraftX.data(), m_spacecraftY.data(),
+                             radius * radius, m_hits.data(), count);
+    
+    // Compact hit candidates without branching: always write, advance only on a hit
+    m_hitCandidates.resize(count);
+    std::size_t hitCount = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        m_hitCandidates[hitCount] = static_cast<std::uint32_t>(i);
+        hitCount += m_hits[i];
+    }
+    
+    for (std::size_t h = 0; h < hitCount; ++h) {
+        std::uint32_t i = m_hitCandidates[h];
+        float dx = m_projectileX[i] - m_spacecraftX[i];
+        float dy = m_projectileY[i] - m_spacecraftY[i];
+        contacts.push_back(Contact{
+            m_projectileIndex[i],
+            m_shooterId[i],
+            m_victimId[i],
+            sf::Vector2f(m_projectileX[i], m_projectileY[i]),
+            dx * dx + dy * dy
+        });
+    }
+    
+    // Deterministic order: independent of pool indices, which differ between peers
+    std::sort(contacts.begin(), contacts.end(), [](const Contact& a, const Contact& b) {
+        if (a.victimId != b.victimId) return a.victimId < b.victimId;
+        if (a.distanceSquared != b.distanceSquared) return a.distanceSquared < b.distanceSquared;
+        if (a.position.x != b.position.x) return a.position.x < b.position.x;
+        if (a.position.y != b.position.y) return a.position.y < b.position.y;
+        return a.shooterId < b.shooterId;
+    });
+}
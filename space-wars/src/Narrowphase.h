@@ -0,0 +1,46 @@
+#ifndef NARROWPHASE_H
+#define NARROWPHASE_H
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A projectile touching a spacecraft
+struct Contact {
+    std::uint32_t projectileIndex;  // ProjectilePool index at the time of the test
+    int shooterId;   // Player who fired the projectile
+    int victimId;    // Player whose spacecraft was touched
+    sf::Vector2f position;  // Projectile position
+    float distanceSquared;  // Squared distance between projectile and spacecraft centers
+};
+
+// Batched projectile-vs-spacecraft narrowphase
+// Broadphase candidate pairs are gathered into contiguous arrays and tested in one pass with
+// the SIMD overlap kernel, so the hot loop has no per-pair branches. All contacts of a step
+// are reported, sorted in an order that does not depend on pool layout.
+class Narrowphase {
+public:
+    void clear();
+    void addCandidate(std::uint32_t projectileIndex, sf::Vector2f projectilePosition, int shooterId,
+                      int victimId, sf::Vector2f spacecraftPosition);
+    
+    // Test all candidates against radius and replace contacts with the sorted hits
+    // Sort order: victim, then closest projectile first, then projectile position, then shooter
+    void findContacts(float radius, std::vector<Contact>& contacts);
+    
+    std::size_t getCandidateCount() const { return m_projectileX.size(); }
+    
+private:
+    std::vector<float> m_projectileX;
+    std::vector<float> m_projectileY;
+    std::vector<float> m_spacecraftX;
+    std::vector<float> m_spacecraftY;
+    std::vector<std::uint32_t> m_projectileIndex;
+    std::vector<std::uint8_t> m_shooterId;
+    std::vector<std::uint8_t> m_victimId;
+    std::vector<std::uint8_t> m_hits;          // Kernel output, one flag per candidate
+    std::vector<std::uint32_t> m_hitCandidates;  // Compacted indices of hit candidates
+};
+
+#endif // NARROWPHASE_H
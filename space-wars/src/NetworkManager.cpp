@@ -1,353 +1,637 @@
 #include "NetworkManager.h"
-#include <sstream>
+#include "WireFormat.h"
+#include "UdpTransport.h"
+#include "ZmqTransport.h"
+#include "ServerTransport.h"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <stdexcept>
 
 //----------------------------------------------------------------------------------------
 NetworkManager::NetworkManager()
-    : m_connected(false)
+    : m_transportOpen(false)
+    , m_transportType(TransportType::Udp)
+    , m_playerId(1)
+    , m_latencyBounded(true)
+    , m_statsEnabled(false)
+    , m_running(false)
+    , m_connected(false)
     , m_connectionLost(false)
-    , m_localPort(0) 
+    , m_localTick(0)
+    , m_skippedSnapshots(0)
+    , m_sendSession(0)
+    , m_sendSequence(0)
+    , m_peerAck(0)
+    , m_peerSession(0)
+    , m_receiveSequence(0)
 {
-    try {
-        m_context = std::make_unique<zmq::context_t>(1);
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to create ZeroMQ context: " << e.what() << std::endl;
-    }
+    m_sendBuffer.reserve(SEND_BUFFER_RESERVE);
 }
 
 //----------------------------------------------------------------------------------------
 NetworkManager::~NetworkManager() 
 {
-    disconnect();
-    // Context will be automatically destroyed by unique_ptr
-    // ZeroMQ contexts should be destroyed after all sockets are closed
+    // Stop the network thread, which closes the transport on the way out
+    m_running.store(false, std::memory_order_release);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
 }
 
 //----------------------------------------------------------------------------------------
-std::string NetworkManager::createAddress(const std::string& ip, int port) 
+void NetworkManager::setProjectileCapacity(std::size_t capacity) 
 {
-    return "tcp://" + ip + ":" + std::to_string(port);
+    for (InboundState& inbound : m_inbound.slots()) {
+        inbound.state.setProjectileCapacity(capacity);
+    }
+    m_overflowState.setProjectileCapacity(capacity);
 }
 
 //----------------------------------------------------------------------------------------
-std::string NetworkManager::createLocalAddress(int port) 
+void NetworkManager::connect(const std::string& peerIp, int peerPort, int localPort) 
 {
-    return "tcp://*:" + std::to_string(port);
+    if (!m_thread.joinable()) {
+        m_running.store(true, std::memory_order_release);
+        m_thread = std::thread(&NetworkManager::run, this);
+    }
+    
+    Command* command = m_commands.prepare();
+    if (!command) {
+        std::cerr << "Network request queue full, connect request dropped" << std::endl;
+        return;
+    }
+    command->type = Command::Type::Connect;
+    command->peerIp = peerIp;
+    command->peerPort = peerPort;
+    command->localPort = localPort;
+    m_commands.publish();
 }
 
 //----------------------------------------------------------------------------------------
-bool NetworkManager::connect(const std::string& peerIp, int peerPort, int localPort) 
+void NetworkManager::disconnect() 
 {
-    try {
-        disconnect();
-        
-        // Create PULL socket for receiving (bind locally)
-        m_receiveSocket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PULL);
-        std::string receiveAddress = createLocalAddress(localPort);
-        m_receiveSocket->bind(receiveAddress);
-        
-        // Create PUSH socket for sending (connect to peer)
-        m_sendSocket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PUSH);
-        
-        // Set send high water mark to allow queuing messages when peer isn't ready
-        // This helps prevent message loss during initial connection
-        int sendHWM = 1000;  // Allow up to 1000 messages to queue
-        m_sendSocket->set(zmq::sockopt::sndhwm, sendHWM);
-        
-        std::string sendAddress = createAddress(peerIp, peerPort);
-        m_sendSocket->connect(sendAddress);
-        
-        // Set socket options for non-blocking receive
-        int timeout = 100;  // 100ms timeout
-        m_receiveSocket->set(zmq::sockopt::rcvtimeo, timeout);
-        
-        // Set receive high water mark
-        int recvHWM = 1000;
-        m_receiveSocket->set(zmq::sockopt::rcvhwm, recvHWM);
-        
-        // Set linger to 0 so sockets close immediately (prevents hanging on shutdown)
-        int linger = 0;
-        m_receiveSocket->set(zmq::sockopt::linger, linger);
-        m_sendSocket->set(zmq::sockopt::linger, linger);
-        
-        m_connected = true;
-        m_connectionLost = false;
-        m_localPort = localPort;
-        m_peerAddress = sendAddress;
-        
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to connect: " << e.what() << std::endl;
-        m_connected = false;
+    // Stop sending right away; the network thread closes the sockets
+    m_connected.store(false, std::memory_order_release);
+    
+    Command* command = m_commands.prepare();
+    if (command) {
+        command->type = Command::Type::Disconnect;
+        m_commands.publish();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+bool NetworkManager::pollEvent(NetworkEvent& event) 
+{
+    NetworkEvent* next = m_events.front();
+    if (!next) {
         return false;
     }
+    event = *next;
+    m_events.pop();
+    return true;
 }
 
 //----------------------------------------------------------------------------------------
-void NetworkManager::disconnect() 
+bool NetworkManager::sendGameState(const GameState& gameState, std::uint32_t inputAck) 
 {
-    // Set linger to 0 on sockets before destroying them to prevent hanging on shutdown
-    // This ensures sockets close immediately rather than waiting for pending messages
-    try {
-        if (m_receiveSocket) {
-            // Set linger to 0 to close immediately (no waiting for pending messages)
-            m_receiveSocket->set(zmq::sockopt::linger, 0);
-        }
-        if (m_sendSocket) {
-            // Set linger to 0 to close immediately (no waiting for pending messages)
-            m_sendSocket->set(zmq::sockopt::linger, 0);
-        }
-    } catch (const std::exception& e) {
-        // Ignore errors during cleanup - we're shutting down anyway
-        // Socket might already be closed or in an invalid state
+    if (!isConnected()) {
+        return false;
     }
     
-    // Reset the unique pointers - sockets will be automatically closed/destroyed
-    // Setting linger=0 ensures they close immediately without blocking
-    m_sendSocket.reset();
-    m_receiveSocket.reset();
-    m_connected = false;
-    m_peerAddress.clear();
+    // Capture straight into the queue slot; the network thread sequences and encodes it
+    OutboundSnapshot* queued = m_outbound.prepare();
+    if (!queued) {
+        m_skippedSnapshots.fetch_add(1, std::memory_order_relaxed);
+        return false;  // Network thread is behind - drop this one, the next snapshot supersedes it
+    }
+    queued->snapshot.capture(gameState);
+    queued->snapshot.inputAck = inputAck;
+    queued->queuedAt = Clock::now();
+    m_outbound.publish();
+    return true;
 }
 
 //----------------------------------------------------------------------------------------
-std::string NetworkManager::serializeGameState(const GameState& gameState) 
+bool NetworkManager::receiveLatestGameState(GameState& gameState) 
 {
-    std::ostringstream oss;
-    
-    // Serialize spacecraft 1
-    const Spacecraft& sc1 = gameState.getSpacecraft(1);
-    sf::Vector2f pos1 = sc1.getPosition();
-    oss << "SC1:" << pos1.x << "," << pos1.y << "," 
-        << sc1.getOrientation() << "," 
-        << sc1.getVelocity().x << "," << sc1.getVelocity().y << ","
-        << (sc1.isThrusting() ? "1" : "0") << ";";
-    
-    // Serialize spacecraft 2
-    const Spacecraft& sc2 = gameState.getSpacecraft(2);
-    sf::Vector2f pos2 = sc2.getPosition();
-    oss << "SC2:" << pos2.x << "," << pos2.y << "," 
-        << sc2.getOrientation() << "," 
-        << sc2.getVelocity().x << "," << sc2.getVelocity().y << ","
-        << (sc2.isThrusting() ? "1" : "0") << ";";
-    
-    // Serialize projectiles
-    oss << "PROJ:";
-    const auto& projectiles = gameState.getProjectiles();
-    for (const auto& proj : projectiles) {
-        if (proj.isActive()) {
-            sf::Vector2f ppos = proj.getPosition();
-            oss << ppos.x << "," << ppos.y << "," 
-                << proj.getVelocity().x << "," << proj.getVelocity().y << "," 
-                << proj.getOwnerPlayerId() << "|";
-        }
+    std::uint32_t inputAck = 0;
+    return receiveLatestGameState(gameState, inputAck);
+}
+
+//----------------------------------------------------------------------------------------
+bool NetworkManager::receiveLatestGameState(GameState& gameState, std::uint32_t& inputAck) 
+{
+    if (m_inbound.available() == 0) {
+        return false;
     }
-    oss << ";";
     
-    // Serialize scores
-    oss << "SCORE:" << gameState.getScore(1) << "," << gameState.getScore(2) << ";";
+    // Each state supersedes the previous one, so skip all but the newest
+    while (m_inbound.available() > 1) {
+        m_inbound.pop();
+        m_skippedSnapshots.fetch_add(1, std::memory_order_relaxed);
+    }
+    const InboundState* inbound = m_inbound.front();
+    gameState = inbound->state;
+    inputAck = inbound->inputAck;
+    m_inboundWait.record(Clock::now() - inbound->queuedAt);
+    m_inbound.pop();
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool NetworkManager::sendGameEvent(const GameEvent& event) 
+{
+    if (!isConnected()) {
+        return false;
+    }
     
-    // Serialize game over status
-    oss << "GAMEOVER:" << (gameState.isGameOver() ? "1" : "0") << ";";
+    OutboundEvent* queued = m_outboundEvents.prepare();
+    if (!queued) {
+        std::cerr << "Network event queue full, game event dropped" << std::endl;
+        return false;
+    }
+    queued->event = event;
+    queued->queuedAt = Clock::now();
+    m_outboundEvents.publish();
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool NetworkManager::pollGameEvent(GameEvent& event) 
+{
+    const GameEvent* next = m_inboundEvents.front();
+    if (!next) {
+        return false;
+    }
+    event = *next;
+    m_inboundEvents.pop();
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool NetworkManager::sendInputs(const WireFormat::InputFrames& frames) 
+{
+    if (!isConnected()) {
+        return false;
+    }
     
-    return oss.str();
+    // Dropping one when the network thread is behind is fine: the next repeats its inputs
+    return m_outboundInputs.push(frames);
 }
 
 //----------------------------------------------------------------------------------------
-bool NetworkManager::deserializeGameState(const std::string& data, GameState& gameState) 
+bool NetworkManager::pollInputs(WireFormat::InputFrames& frames) 
 {
-    try {
-        std::istringstream iss(data);
-        std::string token;
+    const WireFormat::InputFrames* next = m_inboundInputs.front();
+    if (!next) {
+        return false;
+    }
+    frames = *next;
+    m_inboundInputs.pop();
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::run() 
+{
+    m_lastStatsReport = Clock::now();
+    
+    while (m_running.load(std::memory_order_acquire)) {
+        processCommands();
         
-//        std::cout << "data: " << data << std::endl;
-        // Parse spacecraft 1
-        if (std::getline(iss, token, ';') && token.substr(0, 4) == "SC1:") {
-            std::string scData = token.substr(4);
-            std::vector<std::string> parts;
-            std::istringstream scStream(scData);
-            std::string part;
-            // Split by comma
-            while (std::getline(scStream, part, ',')) {
-                parts.push_back(part);
-            }
-            // Should have 6 parts: x, y, orientation, vx, vy, thrust
-            if (parts.size() >= 6) {
-                Spacecraft& sc1 = gameState.getSpacecraft(1);
-                sc1.setPosition(sf::Vector2f(std::stof(parts[0]), std::stof(parts[1])));
-                sc1.setOrientation(std::stof(parts[2]));
-                sc1.setVelocity(sf::Vector2f(std::stof(parts[3]), std::stof(parts[4])));
-                sc1.setThrusting(std::stoi(parts[5]) == 1);
-            } else if (parts.size() == 5) {
-                // Backward compatibility: old format without thrust
-                Spacecraft& sc1 = gameState.getSpacecraft(1);
-                sc1.setPosition(sf::Vector2f(std::stof(parts[0]), std::stof(parts[1])));
-                sc1.setOrientation(std::stof(parts[2]));
-                sc1.setVelocity(sf::Vector2f(std::stof(parts[3]), std::stof(parts[4])));
-                sc1.setThrusting(false);  // Default to false for old format
-            }
+        if (m_statsEnabled && Clock::now() - m_lastStatsReport >= STATS_INTERVAL) {
+            reportStats();
         }
         
-        // Parse spacecraft 2
-        if (std::getline(iss, token, ';') && token.substr(0, 4) == "SC2:") {
-            std::string scData = token.substr(4);
-            std::vector<std::string> parts;
-            std::istringstream scStream(scData);
-            std::string part;
-            // Split by comma
-            while (std::getline(scStream, part, ',')) {
-                parts.push_back(part);
-            }
-            // Should have 6 parts: x, y, orientation, vx, vy, thrust
-            if (parts.size() >= 6) {
-                Spacecraft& sc2 = gameState.getSpacecraft(2);
-                sc2.setPosition(sf::Vector2f(std::stof(parts[0]), std::stof(parts[1])));
-                sc2.setOrientation(std::stof(parts[2]));
-                sc2.setVelocity(sf::Vector2f(std::stof(parts[3]), std::stof(parts[4])));
-                sc2.setThrusting(std::stoi(parts[5]) == 1);
-            } else if (parts.size() == 5) {
-                // Backward compatibility: old format without thrust
-                Spacecraft& sc2 = gameState.getSpacecraft(2);
-                sc2.setPosition(sf::Vector2f(std::stof(parts[0]), std::stof(parts[1])));
-                sc2.setOrientation(std::stof(parts[2]));
-                sc2.setVelocity(sf::Vector2f(std::stof(parts[3]), std::stof(parts[4])));
-                sc2.setThrusting(false);  // Default to false for old format
-            }
+        if (!m_transportOpen) {
+            std::this_thread::sleep_for(POLL_INTERVAL);
+            continue;
         }
         
-        // Parse projectiles
-        if (std::getline(iss, token, ';') && token.substr(0, 5) == "PROJ:") {
-            std::string projData = token.substr(5);
-            if (!projData.empty()) {
-                std::istringstream projStream(projData);
-                std::string projToken;
-                while (std::getline(projStream, projToken, '|')) {
-                    if (!projToken.empty()) {
-                        std::istringstream pStream(projToken);
-                        std::vector<std::string> parts;
-                        std::string part;
-                        while (std::getline(pStream, part, ',')) {
-                            parts.push_back(part);
-                        }
-                        if (parts.size() == 5) {
-                            float posX = std::stof(parts[0]);
-                            float posY = std::stof(parts[1]);
-                            float velX = std::stof(parts[2]);
-                            float velY = std::stof(parts[3]);
-                            int ownerId = std::stoi(parts[4]);
-                            sf::Vector2f pos(posX, posY);
-                            sf::Vector2f vel(velX, velY);
-                            Projectile proj(pos, vel, ownerId);
-                            gameState.addProjectile(proj);
-                        }
-                    }
-                }
+        try {
+            // Resends and acks first, so received messages are ready below
+            if (!m_transport->update()) {
+                m_connectionLost.store(true, std::memory_order_release);
             }
+            receiveHeartbeats();
+            sendHeartbeat();
+            sendQueuedEvents();
+            sendQueuedSnapshots();
+            sendQueuedInputs();
+            receiveEvents();
+            receiveMessages();
+            checkHeartbeat();
+            
+            // Sleep until a message arrives, but wake regularly to pick up outbound messages
+            m_transport->wait(POLL_INTERVAL);
+        } catch (const std::exception& e) {
+            std::cerr << "Network error: " << e.what() << std::endl;
+            m_connectionLost.store(true, std::memory_order_release);
+            std::this_thread::sleep_for(POLL_INTERVAL);
         }
-        
-        // Parse scores
-        if (std::getline(iss, token, ';') && token.substr(0, 6) == "SCORE:") {
-            std::string scoreData = token.substr(6);
-            std::istringstream scoreStream(scoreData);
-            std::string val;
-            if (std::getline(scoreStream, val, ',')) {
-                int score1 = std::stoi(val);
-                if (std::getline(scoreStream, val, ',')) {
-                    int score2 = std::stoi(val);
-                    gameState.setScore(1, score1);
-                    gameState.setScore(2, score2);
-                }
+    }
+    
+    closeTransport();
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::processCommands() 
+{
+    while (Command* command = m_commands.front()) {
+        if (command->type == Command::Type::Connect) {
+            NetworkEvent event;
+            if (openTransport(*command)) {
+                m_connectionLost.store(false, std::memory_order_release);
+                m_connected.store(true, std::memory_order_release);
+                event.type = NetworkEvent::Type::Connected;
+            } else {
+                // Flag the connection as lost so the game schedules another attempt
+                m_connected.store(false, std::memory_order_release);
+                m_connectionLost.store(true, std::memory_order_release);
+                event.type = NetworkEvent::Type::ConnectFailed;
+            }
+            m_events.push(event);
+        } else {
+            closeTransport();
+            
+            // Messages queued for the old connection are stale now
+            while (m_outbound.front()) {
+                m_outbound.pop();
+            }
+            while (m_outboundEvents.front()) {
+                m_outboundEvents.pop();
+            }
+            while (m_outboundInputs.front()) {
+                m_outboundInputs.pop();
             }
         }
-        
-        // Parse game over
-        if (std::getline(iss, token, ';') && token.substr(0, 9) == "GAMEOVER:") {
-            std::string gameOverStr = token.substr(9);
-            bool gameOver = (gameOverStr == "1");
-            gameState.setGameOver(gameOver);
+        m_commands.pop();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+bool NetworkManager::openTransport(const Command& command) 
+{
+    closeTransport();
+    
+    if (!m_transport) {
+        if (m_transportType == TransportType::Udp) {
+            m_transport = std::make_unique<UdpTransport>();
+        } else if (m_transportType == TransportType::Server) {
+            m_transport = std::make_unique<ServerTransport>(m_playerId);
+        } else {
+            m_transport = std::make_unique<ZmqTransport>(m_latencyBounded);
         }
-        
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to deserialize game state: " << e.what() << std::endl;
-        return false;
     }
+    
+    m_transportOpen = m_transport->open(command.peerIp, command.peerPort, command.localPort);
+    return m_transportOpen;
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::closeTransport() 
+{
+    if (m_transport) {
+        m_transport->close();
+    }
+    m_transportOpen = false;
+    resetSnapshots();
+    m_monitor.reset();
 }
 
 //----------------------------------------------------------------------------------------
-bool NetworkManager::sendGameState(const GameState& gameState) 
+void NetworkManager::sendQueuedSnapshots() 
 {
-    if (!m_connected || !m_sendSocket) {
+    while (const OutboundSnapshot* queued = m_outbound.front()) {
+        m_outboundWait.record(Clock::now() - queued->queuedAt);
+        sendSnapshot(queued->snapshot);
+        m_outbound.pop();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::sendQueuedInputs() 
+{
+    while (const WireFormat::InputFrames* queued = m_outboundInputs.front()) {
+        try {
+            WireFormat::encodeInputFrames(*queued, m_localTick.load(std::memory_order_relaxed), m_sendBuffer);
+            m_transport->sendState(m_sendBuffer.data(), m_sendBuffer.size());
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to send inputs: " << e.what() << std::endl;
+            m_connectionLost.store(true, std::memory_order_release);
+        }
+        m_outboundInputs.pop();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+bool NetworkManager::sendSnapshot(const Snapshot& queued) 
+{
+    if (!m_transportOpen) {
         return false;
     }
     
     try {
-        std::string data = serializeGameState(gameState);
-        zmq::message_t message(data.size());
-        memcpy(message.data(), data.c_str(), data.size());
+        // Record the snapshot, then encode it against what the peer last acknowledged
+        // (no per-message allocation once the buffers have grown)
+        m_sendSequence++;
+        Snapshot& snapshot = m_sentSnapshots.slot(m_sendSequence);
+        snapshot = queued;
+        snapshot.sequence = m_sendSequence;
+        const Snapshot* baseline = m_sentSnapshots.find(m_peerAck);  // nullptr if none or overwritten
+        WireFormat::encodeSnapshotDelta(baseline, snapshot, m_sendSession, m_receiveSequence,
+                                        m_localTick.load(std::memory_order_relaxed), m_sendBuffer);
+        m_sendTimes[m_sendSequence % SnapshotHistory::SIZE] = Clock::now();
         
-        // Use dontwait to avoid blocking
-        // With HWM set, messages will queue if the peer isn't ready yet
-        zmq::send_result_t result = m_sendSocket->send(message, zmq::send_flags::dontwait);
-        if (!result.has_value()) {
-            // Send failed - this can happen if:
-            // 1. The send buffer is full (HWM reached) - peer might be slow
-            // 2. The peer's PULL socket isn't bound yet - normal during initial connection
-            // Don't mark as connection lost during initial connection attempts
-            // The message will be queued once the peer is ready (if HWM allows)
-            return false;
-        }
-        return true;
+        // A failed send (peer slow or not up yet) is not a lost connection: the next
+        // snapshot supersedes this one
+        return m_transport->sendState(m_sendBuffer.data(), m_sendBuffer.size());
     } catch (const std::exception& e) {
         // Exceptions during send usually indicate a real problem
         std::cerr << "Failed to send game state: " << e.what() << std::endl;
-        m_connectionLost = true;
+        m_connectionLost.store(true, std::memory_order_release);
         return false;
     }
 }
 
 //----------------------------------------------------------------------------------------
-bool NetworkManager::receiveGameState(GameState& gameState) 
+void NetworkManager::receiveMessages() 
 {
-    if (!m_connected || !m_receiveSocket) {
-        std::cout << "No game state received" << std::endl;
-        return false;
-    }
-    
     try {
-        zmq::message_t message;
-        zmq::recv_result_t result = m_receiveSocket->recv(message, zmq::recv_flags::dontwait);
-        
-        if (!result.has_value()) {
-            // No message available (non-blocking)
-            return false;
+        // The transport drains its queue without decoding anything: each snapshot supersedes
+        // the previous one, so only the newest is needed
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+        std::size_t received = m_transport->receiveLatestState(data, size);
+        if (received == 0) {
+            return;  // No message available (non-blocking)
         }
+        m_monitor.onReceive(Clock::now());
         
-        std::string data(static_cast<char*>(message.data()), message.size());
-        bool success = deserializeGameState(data, gameState);
+        // Rollback inputs share the channel; the newest message repeats what the others carried
+        WireFormat::MessageType type;
+        if (WireFormat::peekMessageType(data, size, type) && type == WireFormat::MessageType::Input) {
+            WireFormat::InputFrames* frames = m_inboundInputs.prepare();
+            if (frames && WireFormat::decodeInputFrames(data, size, *frames)) {
+                m_inboundInputs.publish();
+            }
+            return;
+        }
+        m_skippedSnapshots.fetch_add(received - 1, std::memory_order_relaxed);
         
-        if (!success) {
-            m_connectionLost = true;
+        // Decode straight from the message buffer into the next inbound slot. The message is
+        // decoded even if the game thread has fallen behind, so acks and baselines stay current.
+        InboundState* slot = m_inbound.prepare();
+        GameState& target = slot ? slot->state : m_overflowState;
+        std::uint32_t overflowInputAck = 0;
+        std::uint32_t& targetInputAck = slot ? slot->inputAck : overflowInputAck;
+        std::uint32_t previousSequence = m_receiveSequence;
+        if (decodeMessage(data, size, target, targetInputAck) && slot) {
+            slot->queuedAt = Clock::now();
+            m_inbound.publish();
         }
         
-        return success;
+        // Sequence numbers skipped over by the snapshots that arrived never made it here
+        std::uint64_t lost = 0;
+        std::uint32_t advanced = m_receiveSequence - previousSequence;
+        if (previousSequence != 0 && m_receiveSequence > previousSequence && advanced > received) {
+            lost = advanced - received;
+        }
+        m_monitor.onSnapshots(received, lost);
     } catch (const std::exception& e) {
         std::cerr << "Failed to receive game state: " << e.what() << std::endl;
-        m_connectionLost = true;
+        m_connectionLost.store(true, std::memory_order_release);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::sendQueuedEvents() 
+{
+    try {
+        while (const OutboundEvent* queued = m_outboundEvents.front()) {
+            WireFormat::encodeGameEvent(queued->event, m_localTick.load(std::memory_order_relaxed), m_sendBuffer);
+            bool sent = false;
+            try {
+                sent = m_transport->sendReliable(m_sendBuffer.data(), m_sendBuffer.size());
+            } catch (const std::length_error& e) {
+                // Can never be sent - drop it rather than hold up the events behind it
+                std::cerr << "Dropped game event: " << e.what() << std::endl;
+                m_outboundEvents.pop();
+                continue;
+            }
+            if (!sent) {
+                return;  // Transport is full - keep the event and retry on the next pass
+            }
+            m_eventWait.record(Clock::now() - queued->queuedAt);
+            m_outboundEvents.pop();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to send game event: " << e.what() << std::endl;
+        m_connectionLost.store(true, std::memory_order_release);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::receiveEvents() 
+{
+    try {
+        // Only take an event from the transport when there is room to hand it to the game, so
+        // events back up in the transport rather than being dropped
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+        while (GameEvent* slot = m_inboundEvents.prepare()) {
+            if (!m_transport->receiveReliable(data, size)) {
+                return;
+            }
+            m_monitor.onReceive(Clock::now());
+            if (WireFormat::decodeGameEvent(data, size, *slot)) {
+                m_inboundEvents.publish();
+            } else {
+                std::cerr << "Ignoring malformed game event" << std::endl;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to receive game event: " << e.what() << std::endl;
+        m_connectionLost.store(true, std::memory_order_release);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::sendHeartbeat() 
+{
+    WireFormat::Heartbeat ping;
+    if (!m_monitor.preparePing(Clock::now(), ping)) {
+        return;
+    }
+    // A ping that cannot be sent is simply never answered, which is what the loss rate is for
+    WireFormat::encodeHeartbeat(ping, m_localTick.load(std::memory_order_relaxed), m_sendBuffer);
+    m_transport->sendHeartbeat(m_sendBuffer.data(), m_sendBuffer.size());
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::receiveHeartbeats() 
+{
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+    while (m_transport->receiveHeartbeat(data, size)) {
+        Clock::time_point now = Clock::now();
+        m_monitor.onReceive(now);
+        
+        WireFormat::MessageHeader header;
+        WireFormat::Heartbeat heartbeat;
+        if (!WireFormat::peekMessageHeader(data, size, header) || !WireFormat::decodeHeartbeat(data, size, heartbeat)) {
+            continue;
+        }
+        if (heartbeat.pong) {
+            m_monitor.onPong(heartbeat, header.tick, now);
+        } else {
+            // Answer right away so the peer's round trip does not include our loop
+            m_monitor.onPing(heartbeat, header.tick);
+            ConnectionMonitor::preparePong(Clock::now(), heartbeat);
+            WireFormat::encodeHeartbeat(heartbeat, m_localTick.load(std::memory_order_relaxed), m_sendBuffer);
+            m_transport->sendHeartbeat(m_sendBuffer.data(), m_sendBuffer.size());
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::checkHeartbeat() 
+{
+    if (m_monitor.update(Clock::now()) && !isConnectionLost()) {
+        std::cerr << "No messages from the peer for " << m_monitor.quality().silenceMs
+                  << " ms, connection lost" << std::endl;
+        m_connectionLost.store(true, std::memory_order_release);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+bool NetworkManager::decodeMessage(const std::uint8_t* data, std::size_t size, GameState& gameState,
+                                   std::uint32_t& inputAck) 
+{
+    inputAck = 0;
+    WireFormat::MessageHeader messageHeader;
+    if (!WireFormat::peekMessageHeader(data, size, messageHeader)
+        || messageHeader.type != WireFormat::MessageType::SnapshotDelta) {
+        // Unsequenced full state from an older build
+        bool success = WireFormat::decodeGameState(data, size, gameState);
+        if (!success) {
+            m_connectionLost.store(true, std::memory_order_release);
+        }
+        return success;
+    }
+    
+    BitReader reader(data, size);
+    WireFormat::SnapshotHeader header;
+    if (!WireFormat::decodeSnapshotHeader(reader, header)) {
+        m_connectionLost.store(true, std::memory_order_release);
+        return false;
+    }
+    
+    // A new session means the peer restarted and numbers its snapshots from 1 again; none
+    // of the old stream can serve as a baseline, so it has to start with a full snapshot.
+    // A session already replaced is a previous run's, arriving late: never go back to it.
+    if (std::find(m_retiredSessions.begin(), m_retiredSessions.end(), header.session) != m_retiredSessions.end()) {
+        return false;
+    }
+    bool restarted = header.session != m_peerSession;
+    if (restarted ? header.baseline != 0 : header.sequence <= m_receiveSequence) {
+        return false;  // Stale duplicate, or a delta we have no stream for
+    }
+    
+    // The peer only diffs against snapshots we acknowledged, and we only acknowledge
+    // snapshots we decoded, so skipping older queued messages never loses a baseline
+    const Snapshot* baseline = nullptr;
+    if (header.baseline != 0) {
+        baseline = m_receivedSnapshots.find(header.baseline);
+        if (!baseline || header.sequence - header.baseline >= SnapshotHistory::SIZE) {
+            // Baseline already overwritten - skip it, the peer moves on to our newer acks
+            return false;
+        }
+    }
+    
+    // Decode aside: a message we reject must not overwrite a baseline the peer still uses
+    Snapshot decoded;
+    if (!WireFormat::decodeSnapshotDelta(reader, baseline, decoded)) {
+        m_connectionLost.store(true, std::memory_order_release);
         return false;
     }
+    
+    // Accepted: only now does the header count
+    if (restarted) {
+        if (m_peerSession != 0) {
+            std::copy_backward(m_retiredSessions.begin(), m_retiredSessions.end() - 1, m_retiredSessions.end());
+            m_retiredSessions[0] = m_peerSession;
+        }
+        m_receivedSnapshots.clear();
+        m_peerSession = header.session;
+    }
+    Snapshot& snapshot = m_receivedSnapshots.slot(header.sequence);
+    snapshot = decoded;
+    snapshot.sequence = header.sequence;
+    m_receiveSequence = header.sequence;
+    if (header.ack > m_peerAck && m_sendSequence - header.ack < SnapshotHistory::SIZE) {
+        m_ackRoundTrip.record(Clock::now() - m_sendTimes[header.ack % SnapshotHistory::SIZE]);
+    }
+    m_peerAck = header.ack;
+    m_monitor.onSnapshotTick(messageHeader.tick, Clock::now());
+    
+    snapshot.apply(gameState);
+    inputAck = snapshot.inputAck;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::resetSnapshots() 
+{
+    m_sentSnapshots.clear();
+    m_receivedSnapshots.clear();
+    m_sendSession = WireFormat::newSession();
+    m_sendSequence = 0;
+    m_peerAck = 0;
+    m_peerSession = 0;
+    m_receiveSequence = 0;
+}
+
+//----------------------------------------------------------------------------------------
+void NetworkManager::reportStats() 
+{
+    m_lastStatsReport = Clock::now();
+    
+    auto print = [](const char* name, LatencyStat& stat) {
+        LatencyStat::Summary summary = stat.takeSummary();
+        std::cout << "  " << name << ": avg " << summary.averageMs << " ms, max " << summary.maxMs
+                  << " ms (" << summary.count << ")" << std::endl;
+    };
+    
+    std::cout << "Network queue times (" << (m_latencyBounded ? "latency-bounded" : "queued") << "):" << std::endl;
+    print("snapshot send queue", m_outboundWait);
+    print("snapshot receive queue", m_inboundWait);
+    print("event send queue", m_eventWait);
+    print("ack round trip", m_ackRoundTrip);
+    std::cout << "  skipped snapshots: " << m_skippedSnapshots.exchange(0, std::memory_order_relaxed) << std::endl;
+    
+    ConnectionQuality quality = m_monitor.quality();
+    std::cout << "  heartbeat: rtt " << quality.rttMs << " ms, jitter " << quality.jitterMs << " ms, loss "
+              << quality.lossRate * 100.0f << "% (" << quality.pingsLost << " of " << quality.pingsSent
+              << " pings), snapshots lost " << quality.snapshotsLost << " of "
+              << quality.snapshotsReceived + quality.snapshotsLost << std::endl;
+    if (quality.clockSynced) {
+        std::cout << "  clock: offset " << quality.clockOffsetMs << " ms, drift " << quality.clockDriftPpm
+                  << " ppm, snapshot delay " << quality.snapshotDelayMs << " ms, state age " << quality.stateAgeMs
+                  << " ms" << std::endl;
+    } else {
+        std::cout << "  clock: not synchronized yet" << std::endl;
+    }
 }
 
 //----------------------------------------------------------------------------------------
 bool NetworkManager::checkConnection() 
 {
-    if (!m_connected) {
+    if (!isConnected() || isConnectionLost()) {
         return false;
     }
-    
-    // Try to send a ping or check socket state
-    // For now, we'll rely on send/receive failures to detect disconnection
-    return !m_connectionLost;
+    return m_monitor.quality().peerAlive;
 }
 
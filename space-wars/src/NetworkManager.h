@@ -1,51 +1,209 @@
 #ifndef NETWORKMANAGER_H
 #define NETWORKMANAGER_H
 
+#include <array>
 #include <string>
 #include <memory>
-#include <zmq.hpp>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "ConnectionMonitor.h"
 #include "GameState.h"
+#include "GameEvent.h"
+#include "NetworkStats.h"
+#include "Snapshot.h"
+#include "SpscQueue.h"
+#include "Transport.h"
+#include "WireFormat.h"
 
+// Connection outcome reported by the network thread
+struct NetworkEvent {
+    enum class Type {
+        Connected,      // Sockets are bound/connected, snapshots can flow
+        ConnectFailed   // connect() could not set up the sockets
+    };
+    Type type = Type::Connected;
+};
+
+// Peer-to-peer game state transport
+// The Transport, encoding and decoding live on a dedicated network thread. The game thread
+// talks to it only through lock-free single-producer/single-consumer queues, so none of the
+// calls below block on the network: a slow socket, a reconnect or a large decode never stalls
+// a frame.
+//
+// Two channels run side by side. The state channel carries snapshots, where only the newest
+// matters, so it never queues a backlog (in ZeroMQ's latency-bounded mode its sockets
+// conflate). The event channel carries GameEvents and keeps every message, in order. A
+// heartbeat on its own channel measures round trip time, jitter and loss, and declares the
+// connection lost when the peer falls silent (see ConnectionMonitor).
 class NetworkManager {
 public:
     NetworkManager();
     ~NetworkManager();
     
+    // Setup - call before the first connect()
+    void setProjectileCapacity(std::size_t capacity);  // Of received states (allocates)
+    void setTransportType(TransportType transportType) { m_transportType = transportType; }
+    void setPlayerId(int playerId) { m_playerId = playerId; }  // Slot requested from a dedicated server
+    void setLatencyBounded(bool latencyBounded) { m_latencyBounded = latencyBounded; }  // ZeroMQ only
+    void setStatsEnabled(bool statsEnabled) { m_statsEnabled = statsEnabled; }
+    void setHeartbeatInterval(std::chrono::milliseconds interval) { m_monitor.setHeartbeatInterval(interval); }
+    void setConnectionTimeout(std::chrono::milliseconds timeout) { m_monitor.setTimeout(timeout); }
+    void setTickDuration(std::chrono::nanoseconds tickDuration) { m_monitor.setTickDuration(tickDuration); }  // Both peers'
+    
     // Connection management
     // For bidirectional communication, each player needs:
-    // - localPort: port to bind for receiving (PULL socket)
-    // - peerIp, peerPort: where to connect for sending (PUSH socket)
-    bool connect(const std::string& peerIp, int peerPort, int localPort);
+    // - localPort: port to bind for receiving
+    // - peerIp, peerPort: where the peer receives
+    // connect() queues the request and returns immediately; the result arrives as a NetworkEvent.
+    void connect(const std::string& peerIp, int peerPort, int localPort);
     void disconnect();
-    bool isConnected() const { return m_connected; }
+    bool isConnected() const { return m_connected.load(std::memory_order_acquire); }
+    
+    // Next connection event from the network thread, false if there is none
+    bool pollEvent(NetworkEvent& event);
+    
+    // Every message sent is stamped with the newest simulation tick set here (call once per tick)
+    void setLocalTick(std::uint32_t tick) { m_localTick.store(tick, std::memory_order_relaxed); }
     
     // Message sending/receiving
-    bool sendGameState(const GameState& gameState);
-    bool receiveGameState(GameState& gameState);  // Non-blocking, returns false if no message
+    // Game state is sent as sequenced snapshots, delta-encoded against the newest snapshot the
+    // peer has acknowledged (acks ride on the peer's own snapshots). Until the first ack
+    // arrives, or if the acknowledged snapshot is too old, a full snapshot is sent.
+    // inputAck is only set by an authoritative sender: the newest input of the peer it has simulated.
+    bool sendGameState(const GameState& gameState, std::uint32_t inputAck = 0);  // Queues a snapshot, false if the queue is full
+    std::size_t getQueuedSnapshots() const { return m_outbound.queued(); }  // Not yet taken by the network thread
+    // Latest state decoded by the network thread (older undelivered states are skipped)
+    // gameState should be preallocated and reused by the caller. Returns false if there is none.
+    bool receiveLatestGameState(GameState& gameState);
+    bool receiveLatestGameState(GameState& gameState, std::uint32_t& inputAck);  // Also the sender's input ack (0 if none)
+    
+    // Rollback mode: inputs are sent instead of snapshots, on the same unreliable channel
+    // Each message repeats the inputs the peer has not acknowledged, so losing one is harmless.
+    bool sendInputs(const WireFormat::InputFrames& frames);  // False if not connected or the queue is full
+    bool pollInputs(WireFormat::InputFrames& frames);        // Next received message, false if there is none
+    
+    // Gameplay events, delivered reliably and in order on the event channel
+    bool sendGameEvent(const GameEvent& event);  // False if not connected or the queue is full
+    bool pollGameEvent(GameEvent& event);        // Next received event, false if there is none
     
     // Connection status
-    bool checkConnection();  // Check if connection is still alive
-    bool isConnectionLost() const { return m_connectionLost; }
-    void resetConnectionStatus() { m_connectionLost = false; }
+    // The connection is flagged lost when the transport fails or when the peer, once heard,
+    // stays silent for the connection timeout
+    bool checkConnection();  // True while connected and the peer is heard from within the timeout
+    bool isConnectionLost() const { return m_connectionLost.load(std::memory_order_acquire); }
+    void resetConnectionStatus() { m_connectionLost.store(false, std::memory_order_release); }
     
+    // Round trip time, jitter, loss and clock synchronization of the current connection (any thread)
+    ConnectionQuality getConnectionQuality() const { return m_monitor.quality(); }
+
 private:
-    std::unique_ptr<zmq::context_t> m_context;
-    std::unique_ptr<zmq::socket_t> m_sendSocket;
-    std::unique_ptr<zmq::socket_t> m_receiveSocket;
-    
-    bool m_connected;
-    bool m_connectionLost;
-    int m_localPort;
-    std::string m_peerAddress;
-    
-    // Serialization
-    std::string serializeGameState(const GameState& gameState);
-    bool deserializeGameState(const std::string& data, GameState& gameState);
-    
-    // Helper to create socket address
-    std::string createAddress(const std::string& ip, int port);
-    std::string createLocalAddress(int port);
+    // Request from the game thread to the network thread
+    struct Command {
+        enum class Type { Connect, Disconnect };
+        Type type = Type::Connect;
+        std::string peerIp;
+        int peerPort = 0;
+        int localPort = 0;
+    };
+    
+    using Clock = std::chrono::steady_clock;
+    
+    // Queue elements stamped with the time they were queued, for the queue time statistics
+    struct OutboundSnapshot {
+        Snapshot snapshot;
+        Clock::time_point queuedAt;
+    };
+    struct InboundState {
+        GameState state;
+        std::uint32_t inputAck = 0;
+        Clock::time_point queuedAt;
+    };
+    struct OutboundEvent {
+        GameEvent event;
+        Clock::time_point queuedAt;
+    };
+    
+    // Network thread
+    void run();
+    void processCommands();
+    bool openTransport(const Command& command);
+    void closeTransport();
+    void sendQueuedSnapshots();
+    void sendQueuedInputs();
+    bool sendSnapshot(const Snapshot& queued);
+    void sendQueuedEvents();
+    void receiveMessages();
+    void receiveEvents();
+    void sendHeartbeat();
+    void receiveHeartbeats();
+    void checkHeartbeat();
+    bool decodeMessage(const std::uint8_t* data, std::size_t size, GameState& gameState, std::uint32_t& inputAck);
+    void resetSnapshots();
+    void reportStats();
+    
+    std::unique_ptr<Transport> m_transport;  // Network thread only, created on the first connect
+    bool m_transportOpen;                    // Network thread only
+    
+    // Setup, fixed once the network thread has started
+    TransportType m_transportType;
+    int m_playerId;
+    bool m_latencyBounded;
+    bool m_statsEnabled;
+    
+    // Shared state
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_connected;
+    std::atomic<bool> m_connectionLost;
+    std::atomic<std::uint32_t> m_localTick;
+    
+    // Queues between the game thread and the network thread
+    SpscQueue<Command, 8> m_commands;                   // Game -> network
+    SpscQueue<OutboundSnapshot, 8> m_outbound;          // Game -> network, snapshots to send
+    SpscQueue<InboundState, 4> m_inbound;               // Network -> game, decoded remote states
+    SpscQueue<NetworkEvent, 16> m_events;               // Network -> game
+    SpscQueue<OutboundEvent, 64> m_outboundEvents;      // Game -> network, GameEvents to send
+    SpscQueue<GameEvent, 64> m_inboundEvents;           // Network -> game, received GameEvents
+    SpscQueue<WireFormat::InputFrames, 8> m_outboundInputs;   // Game -> network, rollback inputs to send
+    SpscQueue<WireFormat::InputFrames, 16> m_inboundInputs;   // Network -> game, received rollback inputs
+    GameState m_overflowState;  // Decode target when the game has not consumed m_inbound
+    
+    // Queue time statistics (recorded on both threads, reported by the network thread)
+    LatencyStat m_outboundWait;   // Snapshot queued by the game until the network thread sends it
+    LatencyStat m_inboundWait;    // State decoded until the game picks it up
+    LatencyStat m_eventWait;      // GameEvent queued by the game until it is sent
+    LatencyStat m_ackRoundTrip;   // Snapshot sent until the peer acknowledges it (includes ZMQ queues)
+    std::atomic<std::uint64_t> m_skippedSnapshots;  // Superseded before they were used
+    Clock::time_point m_lastStatsReport;
+    
+    // Everything below is used by the network thread only
+    // Snapshot sequencing
+    SnapshotHistory m_sentSnapshots;      // What we sent, baselines for our deltas
+    SnapshotHistory m_receivedSnapshots;  // What we decoded, baselines for the peer's deltas
+    std::uint32_t m_sendSession;      // Names our snapshot numbering, new on every connection
+    std::uint32_t m_sendSequence;     // Sequence of the last snapshot we sent
+    std::uint32_t m_peerAck;          // Newest of our snapshots the peer has received
+    std::uint32_t m_peerSession;      // Session of the peer's snapshots we decode, 0 if none yet
+    std::uint32_t m_receiveSequence;  // Newest snapshot received from the peer
+    static constexpr std::size_t RETIRED_SESSIONS = 4;
+    std::array<std::uint32_t, RETIRED_SESSIONS> m_retiredSessions{};  // Peer sessions since replaced, newest first
+    std::array<Clock::time_point, SnapshotHistory::SIZE> m_sendTimes;  // When each sent snapshot left
+    
+    // Heartbeat and connection quality (quality() is read by the game thread)
+    ConnectionMonitor m_monitor;
+    
+    // Reusable buffer for encoding outgoing messages
+    std::vector<std::uint8_t> m_sendBuffer;
+    static constexpr std::size_t SEND_BUFFER_RESERVE = 4096;
+    
+    // How long the network thread waits for incoming messages between outbound checks
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{1};
+    
+    // How often the queue time statistics are printed (when enabled)
+    static constexpr std::chrono::seconds STATS_INTERVAL{5};
 };
 
 #endif // NETWORKMANAGER_H
-
@@ -0,0 +1,47 @@
+#ifndef NETWORKSTATS_H
+#define NETWORKSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Running average and maximum of a latency, safe to record from one thread and read from another
+// Used to report how long messages wait in the network queues.
+class LatencyStat {
+public:
+    struct Summary {
+        double averageMs = 0.0;
+        double maxMs = 0.0;
+        std::uint64_t count = 0;
+    };
+    
+    void record(std::chrono::steady_clock::duration duration)
+    {
+        std::int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+        m_totalUs.fetch_add(us, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        std::int64_t max = m_maxUs.load(std::memory_order_relaxed);
+        while (us > max && !m_maxUs.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+        }
+    }
+    
+    // Summary since the last call (resets the statistic)
+    Summary takeSummary()
+    {
+        Summary summary;
+        std::int64_t totalUs = m_totalUs.exchange(0, std::memory_order_relaxed);
+        summary.count = m_count.exchange(0, std::memory_order_relaxed);
+        summary.maxMs = static_cast<double>(m_maxUs.exchange(0, std::memory_order_relaxed)) / 1000.0;
+        if (summary.count > 0) {
+            summary.averageMs = static_cast<double>(totalUs) / 1000.0 / static_cast<double>(summary.count);
+        }
+        return summary;
+    }
+
+private:
+    std::atomic<std::int64_t> m_totalUs{0};
+    std::atomic<std::int64_t> m_maxUs{0};
+    std::atomic<std::uint64_t> m_count{0};
+};
+
+#endif // NETWORKSTATS_H
@@ -0,0 +1,38 @@
+#ifndef PLAYERINPUT_H
+#define PLAYERINPUT_H
+
+#include <cstdint>
+
+// Control input for one spacecraft for a single simulation step
+// Produced by InputHandler (local player) or received over the network (remote player)
+struct PlayerInput {
+    bool left = false;    // Rotate counter-clockwise
+    bool right = false;   // Rotate clockwise
+    bool thrust = false;  // Apply forward thrust
+    bool fire = false;    // Fire a projectile this step (edge, not hold)
+    
+    // Packed form for input-only replication (one bit per control)
+    static constexpr int BITS = 4;
+    static constexpr std::uint8_t LEFT = 0x01;
+    static constexpr std::uint8_t RIGHT = 0x02;
+    static constexpr std::uint8_t THRUST = 0x04;
+    static constexpr std::uint8_t FIRE = 0x08;
+    
+    std::uint8_t toBits() const
+    {
+        return static_cast<std::uint8_t>((left ? LEFT : 0) | (right ? RIGHT : 0) |
+                                         (thrust ? THRUST : 0) | (fire ? FIRE : 0));
+    }
+    
+    static PlayerInput fromBits(std::uint8_t bits)
+    {
+        PlayerInput input;
+        input.left = (bits & LEFT) != 0;
+        input.right = (bits & RIGHT) != 0;
+        input.thrust = (bits & THRUST) != 0;
+        input.fire = (bits & FIRE) != 0;
+        return input;
+    }
+};
+
+#endif // PLAYERINPUT_H
@@ -25,28 +25,3 @@ Projectile::Projectile(sf::Vector2f position, sf::Vector2f direction, int ownerP
         m_active = false;
     }
 }
-
-//----------------------------------------------------------------------------------------
-void Projectile::update(float deltaTime) 
-{
-    if (!m_active) return;
-    
-    // Update position based on velocity
-    m_position += m_velocity * deltaTime;
-    
-    // Check if projectile is off screen
-    if (isOffScreen()) {
-        m_active = false;
-    }
-}
-
-//----------------------------------------------------------------------------------------
-bool Projectile::isOffScreen() const 
-{
-    // Check if projectile has left the screen boundaries
-    return (m_position.x < 0.0f || 
-            m_position.x > Constants::WINDOW_WIDTH ||
-            m_position.y < 0.0f || 
-            m_position.y > Constants::WINDOW_HEIGHT);
-}
-
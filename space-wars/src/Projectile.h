@@ -1,17 +1,16 @@
 #ifndef PROJECTILE_H
 #define PROJECTILE_H
 
-#include <SFML/Graphics.hpp>
+#include <SFML/System/Vector2.hpp>
 #include "Constants.h"
 
+// Description of a single projectile, used to spawn it into a ProjectilePool
+// (the pool owns the simulated projectiles and moves them)
 class Projectile {
 public:
     Projectile();
     Projectile(sf::Vector2f position, sf::Vector2f direction, int ownerPlayerId);
     
-    void update(float deltaTime);
-    bool isOffScreen() const;
-    
     // Getters
     sf::Vector2f getPosition() const { return m_position; }
     sf::Vector2f getVelocity() const { return m_velocity; }
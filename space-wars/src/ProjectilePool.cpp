@@ -0,0 +1,205 @@
+#include "ProjectilePool.h"
+#include "Constants.h"
+#include "SimdKernels.h"
+
+//----------------------------------------------------------------------------------------
+ProjectilePool::ProjectilePool(std::size_t capacity)
+    : m_capacity(0)
+{
+    setCapacity(capacity);
+}
+
+//----------------------------------------------------------------------------------------
+ProjectilePool::ProjectilePool(const ProjectilePool& other)
+    : m_capacity(0)
+{
+    *this = other;
+}
+
+//----------------------------------------------------------------------------------------
+ProjectilePool& ProjectilePool::operator=(const ProjectilePool& other) 
+{
+    if (this == &other) {
+        return *this;
+    }
+    
+    // Keep our storage when it is large enough so copying snapshots never allocates
+    if (m_capacity < other.m_capacity) {
+        reserveArrays(other.m_capacity);
+    }
+    m_capacity = other.m_capacity;
+    
+    // Only the live projectiles' registry entries differ from an empty registry, so the
+    // copy costs O(size()) rather than O(capacity()): drop ours, add other's
+    if (m_registry.getCapacity() == other.m_registry.getCapacity()) {
+        m_registry.clearEntries(m_id.data(), m_id.size());
+    } else {
+        m_registry.setCapacity(other.m_registry.getCapacity());
+    }
+    m_registry.copyCursors(other.m_registry);
+    
+    m_positionX = other.m_positionX;
+    m_positionY = other.m_positionY;
+    m_velocityX = other.m_velocityX;
+    m_velocityY = other.m_velocityY;
+    m_owner = other.m_owner;
+    m_id = other.m_id;
+    m_active = other.m_active;
+    for (std::size_t index = 0; index < m_id.size(); ++index) {
+        m_registry.insert(m_id[index], index);
+    }
+    return *this;
+}
+
+//----------------------------------------------------------------------------------------
+void ProjectilePool::reserveArrays(std::size_t capacity) 
+{
+    m_positionX.reserve(capacity);
+    m_positionY.reserve(capacity);
+    m_velocityX.reserve(capacity);
+    m_velocityY.reserve(capacity);
+    m_owner.reserve(capacity);
+    m_id.reserve(capacity);
+    m_active.reserve(capacity);
+}
+
+//----------------------------------------------------------------------------------------
+void ProjectilePool::setCapacity(std::size_t capacity) 
+{
+    clear();
+    reserveArrays(capacity);
+    m_capacity = capacity;
+    m_registry.setCapacity(capacity);
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t ProjectilePool::add(const Projectile& projectile) 
+{
+    if (!projectile.isActive()) {
+        return Entity::INVALID;
+    }
+    return add(projectile.getPosition(), projectile.getVelocity(), projectile.getOwnerPlayerId());
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t ProjectilePool::add(sf::Vector2f position, sf::Vector2f velocity, int ownerPlayerId) 
+{
+    if (full()) {
+        return Entity::INVALID;  // Out of slots - drop the shot rather than allocate
+    }
+    
+    std::uint32_t id = m_registry.create(ownerPlayerId, size());
+    if (id == Entity::INVALID) {
+        return Entity::INVALID;
+    }
+    append(position, velocity, ownerPlayerId, id);
+    return id;
+}
+
+//----------------------------------------------------------------------------------------
+bool ProjectilePool::insert(sf::Vector2f position, sf::Vector2f velocity, std::uint32_t id) 
+{
+    if (!Entity::isProjectile(id)) {
+        return false;
+    }
+    
+    // The slot can still hold an older generation if the peer's despawn for it never
+    // arrived; the newer spawn supersedes it
+    std::uint32_t occupant = m_registry.occupant(id);
+    if (occupant == id) {
+        return false;
+    }
+    if (occupant != Entity::INVALID) {
+        remove(m_registry.find(occupant));
+    }
+    
+    if (full() || !m_registry.insert(id, size())) {
+        return false;
+    }
+    append(position, velocity, Entity::ownerPlayerId(id), id);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void ProjectilePool::append(sf::Vector2f position, sf::Vector2f velocity, int ownerPlayerId, std::uint32_t id) 
+{
+    m_positionX.push_back(position.x);
+    m_positionY.push_back(position.y);
+    m_velocityX.push_back(velocity.x);
+    m_velocityY.push_back(velocity.y);
+    m_owner.push_back(static_cast<std::uint8_t>(ownerPlayerId));
+    m_id.push_back(id);
+    m_active.push_back(1);
+}
+
+//----------------------------------------------------------------------------------------
+void ProjectilePool::remove(std::size_t index) 
+{
+    std::size_t last = size() - 1;
+    m_registry.release(m_id[index]);
+    if (index != last) {
+        m_registry.move(m_id[last], index);
+        m_positionX[index] = m_positionX[last];
+        m_positionY[index] = m_positionY[last];
+        m_velocityX[index] = m_velocityX[last];
+        m_velocityY[index] = m_velocityY[last];
+        m_owner[index] = m_owner[last];
+        m_id[index] = m_id[last];
+        m_active[index] = m_active[last];
+    }
+    
+    m_positionX.pop_back();
+    m_positionY.pop_back();
+    m_velocityX.pop_back();
+    m_velocityY.pop_back();
+    m_owner.pop_back();
+    m_id.pop_back();
+    m_active.pop_back();
+}
+
+//----------------------------------------------------------------------------------------
+void ProjectilePool::removeInactive() 
+{
+    removeIf([](const ProjectilePool& pool, std::size_t index) { return !pool.isActive(index); });
+}
+
+//----------------------------------------------------------------------------------------
+void ProjectilePool::clear() 
+{
+    for (std::uint32_t id : m_id) {
+        m_registry.release(id);
+    }
+    m_positionX.clear();
+    m_positionY.clear();
+    m_velocityX.clear();
+    m_velocityY.clear();
+    m_owner.clear();
+    m_id.clear();
+    m_active.clear();
+}
+
+//----------------------------------------------------------------------------------------
+void ProjectilePool::setPosition(std::size_t index, sf::Vector2f position) 
+{
+    m_positionX[index] = position.x;
+    m_positionY[index] = position.y;
+}
+
+//----------------------------------------------------------------------------------------
+void ProjectilePool::setVelocity(std::size_t index, sf::Vector2f velocity) 
+{
+    m_velocityX[index] = velocity.x;
+    m_velocityY[index] = velocity.y;
+}
+
+//----------------------------------------------------------------------------------------
+void ProjectilePool::update(float deltaTime) 
+{
+    // One batch pass over the contiguous arrays (SIMD where available)
+    // Spent projectiles keep moving until removeInactive() drops them, which is harmless
+    SimdKernels::integrateProjectiles(m_positionX.data(), m_positionY.data(),
+                                      m_velocityX.data(), m_velocityY.data(),
+                                      m_active.data(), size(), deltaTime,
+                                      static_cast<float>(Constants::WINDOW_WIDTH),
+                                      static_cast<float>(Constants::WINDOW_HEIGHT));
+}
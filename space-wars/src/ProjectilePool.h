@@ -0,0 +1,108 @@
+#ifndef PROJECTILEPOOL_H
+#define PROJECTILEPOOL_H
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "EntityRegistry.h"
+#include "Projectile.h"
+
+// Fixed-capacity projectile storage in structure-of-arrays layout
+// Live projectiles are packed densely in [0, size()); removal swaps the last projectile
+// into the freed slot, so the unused tail [size(), capacity()) acts as the free list.
+// Storage is allocated once (constructor / setCapacity) - adding and removing never allocates.
+// Indices are only stable until the next removal; use the projectile's handle (see
+// EntityRegistry.h) to track it across removals and across the network - find() maps a
+// handle back to its current index in O(1).
+class ProjectilePool {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+    static constexpr std::size_t NOT_FOUND = EntityRegistry::NOT_FOUND;
+    
+    explicit ProjectilePool(std::size_t capacity = DEFAULT_CAPACITY);
+    ProjectilePool(const ProjectilePool& other);
+    ProjectilePool& operator=(const ProjectilePool& other);
+    
+    // Capacity (allocates and clears the pool - call during setup only)
+    void setCapacity(std::size_t capacity);
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t size() const { return m_positionX.size(); }
+    bool empty() const { return m_positionX.empty(); }
+    bool full() const { return size() >= m_capacity; }
+    
+    // Add a projectile under a new handle, returns the handle or Entity::INVALID if the pool
+    // is full or the projectile is inactive
+    std::uint32_t add(const Projectile& projectile);
+    std::uint32_t add(sf::Vector2f position, sf::Vector2f velocity, int ownerPlayerId);
+    
+    // Add a projectile under a handle assigned by the peer that fired it. An older
+    // generation still holding the handle's slot is removed first. Returns false if the pool
+    // is full, the handle is malformed or the projectile is already present.
+    bool insert(sf::Vector2f position, sf::Vector2f velocity, std::uint32_t id);
+    
+    // Current index of the projectile with this handle, NOT_FOUND if it is gone
+    std::size_t find(std::uint32_t id) const { return m_registry.find(id); }
+    
+    // Remove the projectile at index (swap-remove: the last projectile moves into index)
+    void remove(std::size_t index);
+    
+    // Remove every projectile for which predicate(pool, index) returns true
+    template <typename Predicate>
+    void removeIf(Predicate predicate);
+    
+    void removeInactive();
+    void clear();
+    
+    // Move all projectiles and deactivate those that left the screen
+    void update(float deltaTime);
+    
+    // Element access (index < size())
+    sf::Vector2f getPosition(std::size_t index) const { return sf::Vector2f(m_positionX[index], m_positionY[index]); }
+    sf::Vector2f getVelocity(std::size_t index) const { return sf::Vector2f(m_velocityX[index], m_velocityY[index]); }
+    int getOwnerPlayerId(std::size_t index) const { return m_owner[index]; }
+    std::uint32_t getId(std::size_t index) const { return m_id[index]; }
+    bool isActive(std::size_t index) const { return m_active[index] != 0; }
+    void setPosition(std::size_t index, sf::Vector2f position);
+    void setVelocity(std::size_t index, sf::Vector2f velocity);
+    void setActive(std::size_t index, bool active) { m_active[index] = active ? 1 : 0; }
+    
+    // Raw arrays for batch processing (valid for [0, size()))
+    const float* positionsX() const { return m_positionX.data(); }
+    const float* positionsY() const { return m_positionY.data(); }
+    const float* velocitiesX() const { return m_velocityX.data(); }
+    const float* velocitiesY() const { return m_velocityY.data(); }
+    const std::uint8_t* owners() const { return m_owner.data(); }
+    const std::uint32_t* ids() const { return m_id.data(); }
+    const std::uint8_t* activeFlags() const { return m_active.data(); }
+    
+private:
+    void reserveArrays(std::size_t capacity);
+    void append(sf::Vector2f position, sf::Vector2f velocity, int ownerPlayerId, std::uint32_t id);
+    
+    std::size_t m_capacity;
+    std::vector<float> m_positionX;
+    std::vector<float> m_positionY;
+    std::vector<float> m_velocityX;
+    std::vector<float> m_velocityY;
+    std::vector<std::uint8_t> m_owner;   // Player who fired the projectile (1 or 2)
+    std::vector<std::uint32_t> m_id;     // Handle, owner in the low bits (see EntityRegistry.h)
+    std::vector<std::uint8_t> m_active;  // 0 once the projectile is spent, removed by removeInactive()
+    EntityRegistry m_registry;           // Handle -> index, kept in step with every add and remove
+};
+
+//----------------------------------------------------------------------------------------
+template <typename Predicate>
+void ProjectilePool::removeIf(Predicate predicate) 
+{
+    std::size_t index = 0;
+    while (index < size()) {
+        if (predicate(*this, index)) {
+            remove(index);  // Re-test index: it now holds the former last projectile
+        } else {
+            ++index;
+        }
+    }
+}
+
+#endif // PROJECTILEPOOL_H
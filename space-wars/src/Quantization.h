@@ -0,0 +1,81 @@
+#ifndef QUANTIZATION_H
+#define QUANTIZATION_H
+
+#include "Constants.h"
+#include <cmath>
+#include <cstdint>
+
+// Fixed-point grids for replicated state
+// The network encoder packs values as integers on these grids. The simulation itself runs at
+// full precision, so its results do not depend on the tick rate; values are snapped only
+// where they are captured for the wire (snapshots, spawn events), and decoding a snapped
+// value returns it unchanged.
+namespace Quantization {
+    // Positions: 1/64 pixel over the arena plus a margin (projectiles can sit just off screen)
+    constexpr float POSITION_SCALE = 64.0f;
+    constexpr float POSITION_MARGIN = 64.0f;
+    constexpr int POSITION_X_BITS = 17;  // (1024 + 2 * 64) * 64 = 73728 steps
+    constexpr int POSITION_Y_BITS = 16;  // (768 + 2 * 64) * 64 = 57344 steps
+    
+    // Orientation: 4096 steps per turn (0.088 degrees)
+    constexpr int ORIENTATION_BITS = 12;
+    constexpr float ORIENTATION_STEP = 360.0f / (1 << ORIENTATION_BITS);
+    
+    // Velocities: 1/32 pixel per second within a bounded range
+    // Spacecraft are limited to SPACECRAFT_MAX_VELOCITY under thrust, but gravity can pull them
+    // past it, so their range is twice that. Projectiles always fly at PROJECTILE_SPEED.
+    constexpr float VELOCITY_SCALE = 32.0f;
+    constexpr float SPACECRAFT_VELOCITY_LIMIT = 2.0f * Constants::SPACECRAFT_MAX_VELOCITY;
+    constexpr float PROJECTILE_VELOCITY_LIMIT = Constants::PROJECTILE_SPEED;
+    constexpr int SPACECRAFT_VELOCITY_BITS = 16;  // 1200 * 32 = 38400 steps
+    constexpr int PROJECTILE_VELOCITY_BITS = 15;  // 800 * 32 = 25600 steps
+    
+    static_assert((Constants::WINDOW_WIDTH + 2 * POSITION_MARGIN) * POSITION_SCALE < (1 << POSITION_X_BITS));
+    static_assert((Constants::WINDOW_HEIGHT + 2 * POSITION_MARGIN) * POSITION_SCALE < (1 << POSITION_Y_BITS));
+    static_assert(2.0f * SPACECRAFT_VELOCITY_LIMIT * VELOCITY_SCALE < (1 << SPACECRAFT_VELOCITY_BITS));
+    static_assert(2.0f * PROJECTILE_VELOCITY_LIMIT * VELOCITY_SCALE < (1 << PROJECTILE_VELOCITY_BITS));
+    
+    // Clamp value to [minimum, maximum] and map it to an integer step count from minimum
+    inline std::uint32_t encode(float value, float minimum, float maximum, float scale)
+    {
+        float clamped = std::fmin(std::fmax(value, minimum), maximum);
+        return static_cast<std::uint32_t>(std::lround((clamped - minimum) * scale));
+    }
+    
+    inline float decode(std::uint32_t steps, float minimum, float scale)
+    {
+        return static_cast<float>(steps) / scale + minimum;
+    }
+    
+    inline std::uint32_t encodePositionX(float x)
+    {
+        return encode(x, -POSITION_MARGIN, Constants::WINDOW_WIDTH + POSITION_MARGIN, POSITION_SCALE);
+    }
+    inline std::uint32_t encodePositionY(float y)
+    {
+        return encode(y, -POSITION_MARGIN, Constants::WINDOW_HEIGHT + POSITION_MARGIN, POSITION_SCALE);
+    }
+    inline float decodePosition(std::uint32_t steps) { return decode(steps, -POSITION_MARGIN, POSITION_SCALE); }
+    
+    // Orientation in degrees, wrapped into [0, 360)
+    inline std::uint32_t encodeOrientation(float degrees)
+    {
+        long steps = std::lround(degrees / ORIENTATION_STEP);
+        return static_cast<std::uint32_t>(steps) & ((1u << ORIENTATION_BITS) - 1);
+    }
+    inline float decodeOrientation(std::uint32_t steps) { return static_cast<float>(steps) * ORIENTATION_STEP; }
+    
+    inline std::uint32_t encodeVelocity(float velocity, float limit)
+    {
+        return encode(velocity, -limit, limit, VELOCITY_SCALE);
+    }
+    inline float decodeVelocity(std::uint32_t steps, float limit) { return decode(steps, -limit, VELOCITY_SCALE); }
+    
+    // Round-trip helpers: the value the peer will decode
+    inline float positionX(float x) { return decodePosition(encodePositionX(x)); }
+    inline float positionY(float y) { return decodePosition(encodePositionY(y)); }
+    inline float orientation(float degrees) { return decodeOrientation(encodeOrientation(degrees)); }
+    inline float velocity(float velocity, float limit) { return decodeVelocity(encodeVelocity(velocity, limit), limit); }
+}
+
+#endif // QUANTIZATION_H
@@ -10,6 +10,7 @@
 //----------------------------------------------------------------------------------------
 Renderer::Renderer()
     : m_fontLoaded(false)
+    , m_spectating(false)
     , m_explosionRadius(0.0f)
     , m_explosionTime(0.0f)
     , m_explosionActive(false) 
@@ -17,7 +18,7 @@ Renderer::Renderer()
     // Try to load a default font (SFML 3.0 may have built-in font support)
     // For now, we'll use SFML's default rendering which should work
     m_fontLoaded = false;  // We'll use SFML's default text rendering
-
+    
     // Font loading
     for (const auto& path : {
         #ifdef SFML_SYSTEM_WINDOWS
@@ -40,7 +41,7 @@ Renderer::Renderer()
             break;
         }
     }
-
+    
     m_player_1 = std::make_unique<Craft>(Constants::CRAFT_1);
     m_player_2 = std::make_unique<Craft>(Constants::CRAFT_2);
     m_thrust_1 = std::make_unique<Thrust>(1000, Constants::CRAFT_1);
@@ -49,21 +50,25 @@ Renderer::Renderer()
 }
 
 //----------------------------------------------------------------------------------------
-void Renderer::render(sf::RenderWindow& window, const GameState& gameState, 
-                      bool connectionLost, int localPlayerId,
-                      bool connected, bool bothPlayersConnected) 
+void Renderer::render(sf::RenderWindow& window, const GameState& previousState, const GameState& gameState, 
+                      float alpha, float tickDuration, bool connectionLost, int localPlayerId,
+                      bool connected, bool bothPlayersConnected, const ConnectionQuality& quality) 
 {
     // Restart the clock once per frame to measure elapsed time for all particle effects
     m_frameTime = m_clock.restart();
     
     // Draw spacecraft
-    drawSpacecraft(window, gameState.getSpacecraft(1));
-    drawSpacecraft(window, gameState.getSpacecraft(2));
+    drawSpacecraft(window, interpolateSpacecraft(previousState.getSpacecraft(1), gameState.getSpacecraft(1), alpha));
+    drawSpacecraft(window, interpolateSpacecraft(previousState.getSpacecraft(2), gameState.getSpacecraft(2), alpha));
     
     // Draw projectiles
-    for (const auto& projectile : gameState.getProjectiles()) {
-        if (projectile.isActive()) {
-            drawProjectile(window, projectile);
+    // Projectiles move in a straight line, so step back along the velocity instead of
+    // matching them up with the previous state
+    float rewind = (1.0f - alpha) * tickDuration;
+    const ProjectilePool& projectiles = gameState.getProjectiles();
+    for (std::size_t i = 0; i < projectiles.size(); ++i) {
+        if (projectiles.isActive(i)) {
+            drawProjectile(window, projectiles.getPosition(i) - projectiles.getVelocity(i) * rewind);
         }
     }
     
@@ -74,7 +79,7 @@ void Renderer::render(sf::RenderWindow& window, const GameState& gameState,
     
     // Draw UI
     drawScore(window, gameState.getScore(1), gameState.getScore(2));
-    drawConnectionStatus(window, connected, connectionLost, bothPlayersConnected, localPlayerId);
+    drawConnectionStatus(window, connected, connectionLost, bothPlayersConnected, localPlayerId, quality);
     
     // Draw game over message if game is over
     if (gameState.isGameOver()) {
@@ -147,10 +152,8 @@ void Renderer::drawThrustFlame(sf::RenderWindow& window, const Spacecraft& space
 }
 
 //----------------------------------------------------------------------------------------
-void Renderer::drawProjectile(sf::RenderWindow& window, const Projectile& projectile) 
+void Renderer::drawProjectile(sf::RenderWindow& window, sf::Vector2f position) 
 {
-    sf::Vector2f position = projectile.getPosition();
-    
     // Draw as a small circle/dot
     float radius = Constants::PROJECTILE_SIZE;
     sf::CircleShape dot(radius);  // SFML 3.0: constructor takes radius
@@ -197,7 +200,7 @@ void Renderer::drawScore(sf::RenderWindow& window, int score1, int score2)
 
 //----------------------------------------------------------------------------------------
 void Renderer::drawConnectionStatus(sf::RenderWindow& window, bool connected, bool connectionLost, 
-                                     bool bothPlayersConnected, int localPlayerId) 
+                                     bool bothPlayersConnected, int localPlayerId, const ConnectionQuality& quality) 
 {
     if (!m_fontLoaded) {
         // Skip if no font loaded
@@ -207,7 +210,11 @@ void Renderer::drawConnectionStatus(sf::RenderWindow& window, bool connected, bo
     std::string statusText;
     sf::Color statusColor;
     
-    if (connectionLost) {
+    if (m_spectating) {
+        // Spectators have no connection to measure; bothPlayersConnected means the stream is live
+        statusText = bothPlayersConnected ? "Spectating" : "Waiting for the match stream...";
+        statusColor = bothPlayersConnected ? sf::Color::Green : sf::Color::Yellow;
+    } else if (connectionLost) {
         statusText = "Connection Lost - Waiting for reconnection...";
         statusColor = sf::Color::Red;
     } else if (connected && !bothPlayersConnected) {
@@ -216,8 +223,15 @@ void Renderer::drawConnectionStatus(sf::RenderWindow& window, bool connected, bo
         statusText = "Waiting for Player " + std::to_string(otherPlayerId) + " to join...";
         statusColor = sf::Color::Yellow;
     } else if (connected && bothPlayersConnected) {
-        statusText = "Connected";
-        statusColor = sf::Color::Green;
+        // Round trip, jitter and loss measured by the heartbeat
+        statusText = "Connected - RTT " + std::to_string(static_cast<int>(std::lround(quality.rttMs)))
+            + " ms, jitter " + std::to_string(static_cast<int>(std::lround(quality.jitterMs)))
+            + " ms, loss " + std::to_string(static_cast<int>(std::lround(quality.lossRate * 100.0f))) + "%";
+        if (quality.clockSynced && quality.stateAgeMs > 0.0f) {
+            // How far behind the peer's newest state is, on the synchronized clock
+            statusText += ", state age " + std::to_string(static_cast<int>(std::lround(quality.stateAgeMs))) + " ms";
+        }
+        statusColor = quality.lossRate > 0.1f ? sf::Color::Yellow : sf::Color::Green;
     } else {
         statusText = "Not Connected";
         statusColor = sf::Color::Yellow;
@@ -264,6 +278,38 @@ void Renderer::drawGameOver(sf::RenderWindow& window, int winner)
     window.draw(text);
 }
 
+//----------------------------------------------------------------------------------------
+Spacecraft Renderer::interpolateSpacecraft(const Spacecraft& previous, const Spacecraft& current, float alpha) 
+{
+    // Nothing to blend from if the spacecraft was dead (respawn teleports it)
+    if (!previous.isAlive() || !current.isAlive()) {
+        return current;
+    }
+    
+    sf::Vector2f from = previous.getPosition();
+    sf::Vector2f to = current.getPosition();
+    
+    // Don't blend across a screen wrap - that would sweep the spacecraft across the whole screen
+    if (std::abs(to.x - from.x) > Constants::WINDOW_WIDTH / 2.0f ||
+        std::abs(to.y - from.y) > Constants::WINDOW_HEIGHT / 2.0f) {
+        return current;
+    }
+    
+    // Rotate the shortest way around
+    float fromAngle = previous.getOrientation();
+    float deltaAngle = current.getOrientation() - fromAngle;
+    if (deltaAngle > 180.0f) {
+        deltaAngle -= 360.0f;
+    } else if (deltaAngle < -180.0f) {
+        deltaAngle += 360.0f;
+    }
+    
+    Spacecraft interpolated = current;
+    interpolated.setPosition(from + (to - from) * alpha);
+    interpolated.setOrientation(fromAngle + deltaAngle * alpha);
+    return interpolated;
+}
+
 //----------------------------------------------------------------------------------------
 sf::Vector2f Renderer::rotatePoint(sf::Vector2f point, sf::Vector2f center, float angleDegrees) 
 {
@@ -7,6 +7,7 @@
 #include "Spacecraft.h"
 #include "Projectile.h"
 #include "GameState.h"
+#include "ConnectionMonitor.h"
 #include "Craft.hpp"
 #include "Thrust.hpp"
 #include "Explosion.hpp"
@@ -18,14 +19,19 @@ public:
     Renderer();
     
     // Main rendering function
-    void render(sf::RenderWindow& window, const GameState& gameState, 
-                bool connectionLost, int localPlayerId, 
-                bool connected, bool bothPlayersConnected);
+    // Entities are drawn interpolated between previousState and gameState by alpha (0-1),
+    // where the two states are one simulation step of tickDuration seconds apart
+    void render(sf::RenderWindow& window, const GameState& previousState, const GameState& gameState, 
+                float alpha, float tickDuration, bool connectionLost, int localPlayerId, 
+                bool connected, bool bothPlayersConnected, const ConnectionQuality& quality);
+    
+    // Spectator mode: the status line reports the stream instead of the connection to a peer
+    void setSpectating(bool spectating) { m_spectating = spectating; }
     
     // Explosion management
     void triggerExplosion(sf::Vector2f position);
     void updateExplosion(float deltaTime);
-    
+
 private:
     // Spacecraft rendering
     void drawSpacecraft(sf::RenderWindow& window, const Spacecraft& spacecraft);
@@ -34,7 +40,7 @@ private:
     void drawThrustFlame(sf::RenderWindow& window, const Spacecraft& spacecraft);
     
     // Projectile rendering
-    void drawProjectile(sf::RenderWindow& window, const Projectile& projectile);
+    void drawProjectile(sf::RenderWindow& window, sf::Vector2f position);
     
     // Explosion rendering
     void drawExplosion(sf::RenderWindow& window, sf::Vector2f position);
@@ -42,16 +48,18 @@ private:
     // UI rendering
     void drawScore(sf::RenderWindow& window, int score1, int score2);
     void drawConnectionStatus(sf::RenderWindow& window, bool connected, bool connectionLost, 
-                               bool bothPlayersConnected, int localPlayerId);
+                               bool bothPlayersConnected, int localPlayerId, const ConnectionQuality& quality);
     void drawGameOver(sf::RenderWindow& window, int winner);
     
     // Helper functions
+    static Spacecraft interpolateSpacecraft(const Spacecraft& previous, const Spacecraft& current, float alpha);
     sf::Vector2f rotatePoint(sf::Vector2f point, sf::Vector2f center, float angleDegrees);
     void drawLine(sf::RenderWindow& window, sf::Vector2f p1, sf::Vector2f p2, sf::Color color = sf::Color::White);
     
     // Font for text rendering
     sf::Font                m_font;
     bool                    m_fontLoaded;
+    bool                    m_spectating;
     
     // Explosion animation state (could be expanded for multiple explosions)
     float                   m_explosionRadius;
@@ -0,0 +1,157 @@
+#include "RollbackSession.h"
+#include "Simulation.h"
+#include <algorithm>
+
+//----------------------------------------------------------------------------------------
+RollbackSession::RollbackSession(Simulation& simulation) 
+    : m_simulation(simulation)
+    , m_localPlayerId(1)
+    , m_tickDuration(1.0f / 60.0f)
+    , m_maxRollback(DEFAULT_ROLLBACK)
+    , m_currentTick(0)
+    , m_remoteConfirmed(0)
+    , m_peerAck(0)
+    , m_rollbackTick(0)
+    , m_rollbackCount(0)
+    , m_resimulatedTicks(0)
+{
+}
+
+//----------------------------------------------------------------------------------------
+void RollbackSession::setProjectileCapacity(std::size_t capacity) 
+{
+    for (SavedState& saved : m_states) {
+        saved.state.setProjectileCapacity(capacity);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void RollbackSession::reset(int localPlayerId, float tickDuration, int maxRollback) 
+{
+    m_localPlayerId = localPlayerId;
+    m_tickDuration = tickDuration;
+    m_maxRollback = std::clamp(maxRollback, 1, MAX_ROLLBACK);
+    
+    // Identical starting point on both peers, including projectile handles and the clock
+    m_simulation.reset();
+    GameState& gameState = m_simulation.getGameState();
+    gameState.setProjectileCapacity(gameState.getProjectiles().capacity());
+    gameState.seedRandom(SEED);
+    gameState.setTime(0.0);
+    
+    m_currentTick = 0;
+    m_remoteConfirmed = 0;
+    m_peerAck = 0;
+    m_rollbackTick = 0;
+    m_localInputs = {};
+    m_remoteInputs = {};
+    for (SavedState& saved : m_states) {
+        saved.tick = 0;
+    }
+    m_rollbackCount = 0;
+    m_resimulatedTicks = 0;
+}
+
+//----------------------------------------------------------------------------------------
+bool RollbackSession::canAdvance() const 
+{
+    return m_currentTick - m_remoteConfirmed < static_cast<std::uint32_t>(m_maxRollback);
+}
+
+//----------------------------------------------------------------------------------------
+void RollbackSession::advance(const PlayerInput& localInput) 
+{
+    // Correct the past first so the new tick builds on it
+    if (m_rollbackTick != 0) {
+        rollback();
+    }
+    
+    m_currentTick++;
+    m_localInputs[m_currentTick % INPUT_HISTORY] = localInput.toBits();
+    simulateTick(m_currentTick);
+}
+
+//----------------------------------------------------------------------------------------
+void RollbackSession::addRemoteInputs(const WireFormat::InputFrames& frames) 
+{
+    if (frames.ack > m_peerAck && frames.ack <= m_currentTick) {
+        m_peerAck = frames.ack;
+    }
+    
+    for (std::size_t i = 0; i < frames.count; ++i) {
+        std::uint32_t tick = frames.firstTick + static_cast<std::uint32_t>(i);
+        if (tick <= m_remoteConfirmed) {
+            continue;  // Already have it
+        }
+        if (tick != m_remoteConfirmed + 1 || tick > m_currentTick + INPUT_HISTORY / 2) {
+            break;  // Gap (the peer resends from our ack) or too far ahead to store
+        }
+        
+        // Ticks already simulated ran with a prediction; re-simulate from the first wrong one
+        std::uint8_t& slot = m_remoteInputs[tick % INPUT_HISTORY];
+        if (tick <= m_currentTick && slot != frames.inputs[i] && m_rollbackTick == 0) {
+            m_rollbackTick = tick;
+        }
+        slot = frames.inputs[i];
+        m_remoteConfirmed = tick;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void RollbackSession::fillInputMessage(WireFormat::InputFrames& frames) const 
+{
+    std::uint32_t first = m_peerAck + 1;
+    if (m_currentTick >= WireFormat::InputFrames::MAX_FRAMES) {
+        first = std::max<std::uint32_t>(first, m_currentTick - WireFormat::InputFrames::MAX_FRAMES + 1);
+    }
+    
+    frames.firstTick = first;
+    frames.ack = m_remoteConfirmed;
+    frames.count = 0;
+    for (std::uint32_t tick = first; tick <= m_currentTick; ++tick) {
+        frames.inputs[frames.count++] = m_localInputs[tick % INPUT_HISTORY];
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void RollbackSession::simulateTick(std::uint32_t tick) 
+{
+    SavedState& saved = m_states[tick % STATE_HISTORY];
+    saved.tick = tick;
+    saved.state = m_simulation.getGameState();  // Storage is reused, no allocation
+    
+    // Past the confirmed tick, predict the last known input held on (a shot is a single
+    // tick's edge, so it is not repeated)
+    if (tick > m_remoteConfirmed) {
+        std::uint8_t predicted = 0;
+        if (m_remoteConfirmed != 0) {
+            predicted = static_cast<std::uint8_t>(m_remoteInputs[m_remoteConfirmed % INPUT_HISTORY] & ~PlayerInput::FIRE);
+        }
+        m_remoteInputs[tick % INPUT_HISTORY] = predicted;
+    }
+    
+    std::array<PlayerInput, 2> inputs;
+    int remotePlayerId = (m_localPlayerId == 1) ? 2 : 1;
+    inputs[m_localPlayerId - 1] = PlayerInput::fromBits(m_localInputs[tick % INPUT_HISTORY]);
+    inputs[remotePlayerId - 1] = PlayerInput::fromBits(m_remoteInputs[tick % INPUT_HISTORY]);
+    m_simulation.step(inputs, m_tickDuration);
+}
+
+//----------------------------------------------------------------------------------------
+void RollbackSession::rollback() 
+{
+    std::uint32_t from = m_rollbackTick;
+    m_rollbackTick = 0;
+    
+    const SavedState& saved = m_states[from % STATE_HISTORY];
+    if (saved.tick != from) {
+        return;  // Cannot happen while canAdvance() holds the window
+    }
+    m_simulation.getGameState() = saved.state;
+    
+    for (std::uint32_t tick = from; tick <= m_currentTick; ++tick) {
+        simulateTick(tick);
+    }
+    m_rollbackCount++;
+    m_resimulatedTicks += m_currentTick - from + 1;
+}
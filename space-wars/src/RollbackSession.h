@@ -0,0 +1,91 @@
+#ifndef ROLLBACKSESSION_H
+#define ROLLBACKSESSION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "GameState.h"
+#include "PlayerInput.h"
+#include "WireFormat.h"
+
+class Simulation;
+
+// Rollback netcode: peers exchange only their inputs and both run the full simulation
+// Each tick runs at once with the local input and a prediction of the remote one (its
+// last confirmed input, without firing). The state before every tick is saved. When a
+// remote input arrives that differs from what was predicted, the simulation goes back to
+// the state before that tick and re-simulates up to the present with the real input. The
+// session stops advancing while the remote inputs are more than the rollback window behind.
+// Both peers must start from the same state, seed and tick rate; reset() takes care of it.
+// Nothing is allocated once the saved states match the simulation's projectile capacity.
+class RollbackSession {
+public:
+    static constexpr int MAX_ROLLBACK = 15;          // Largest rollback window, in ticks
+    static constexpr int DEFAULT_ROLLBACK = 8;
+    static constexpr unsigned int SEED = 20240601;  // Shared random seed, both peers must use the same
+    
+    explicit RollbackSession(Simulation& simulation);
+    
+    // Allocate the saved states to match the simulation (call during setup only)
+    void setProjectileCapacity(std::size_t capacity);
+    
+    // Start a new match at tick 0: resets and seeds the simulation, forgets all inputs
+    void reset(int localPlayerId, float tickDuration, int maxRollback);
+    
+    // False while advancing would predict more than the rollback window; wait for the peer
+    bool canAdvance() const;
+    
+    // Simulate the next tick with the local input, after re-simulating any mispredicted ticks
+    // The simulation's hit and spawn events are those of the new tick only.
+    void advance(const PlayerInput& localInput);
+    
+    // Remote inputs from the peer (duplicates, gaps and stale messages are ignored)
+    void addRemoteInputs(const WireFormat::InputFrames& frames);
+    
+    // Our inputs the peer has not acknowledged yet, the newest MAX_FRAMES at most
+    void fillInputMessage(WireFormat::InputFrames& frames) const;
+    
+    std::uint32_t getCurrentTick() const { return m_currentTick; }         // Ticks simulated
+    std::uint32_t getConfirmedTick() const { return m_remoteConfirmed; }  // Newest tick with the real remote input
+    
+    // Statistics since reset()
+    std::uint64_t getRollbackCount() const { return m_rollbackCount; }
+    std::uint64_t getResimulatedTicks() const { return m_resimulatedTicks; }
+
+private:
+    static constexpr std::size_t INPUT_HISTORY = 64;  // Inputs per player, must exceed twice the window
+    static constexpr std::size_t STATE_HISTORY = 16;  // Saved states, must exceed the window
+    
+    static_assert(STATE_HISTORY > static_cast<std::size_t>(MAX_ROLLBACK), "A rollback must find its saved state");
+    static_assert(INPUT_HISTORY > 2 * static_cast<std::size_t>(MAX_ROLLBACK) + 1,
+                  "Remote inputs may run a window ahead of our tick and rollbacks reach a window back");
+    static_assert(WireFormat::InputFrames::MAX_FRAMES > 2 * static_cast<std::size_t>(MAX_ROLLBACK),
+                  "Peers are at most two windows apart, so every message must reach the peer's confirmed tick");
+    
+    struct SavedState {
+        std::uint32_t tick = 0;  // State before this tick was simulated
+        GameState state;
+    };
+    
+    void simulateTick(std::uint32_t tick);
+    void rollback();
+    
+    Simulation& m_simulation;
+    int m_localPlayerId;
+    float m_tickDuration;
+    int m_maxRollback;
+    
+    std::uint32_t m_currentTick;      // Newest simulated tick, 0 before the first
+    std::uint32_t m_remoteConfirmed;  // Real remote inputs are known up to this tick
+    std::uint32_t m_peerAck;          // The peer has our inputs up to this tick
+    std::uint32_t m_rollbackTick;     // Oldest mispredicted tick to re-simulate from, 0 if none
+    
+    std::array<std::uint8_t, INPUT_HISTORY> m_localInputs{};   // Indexed by tick % INPUT_HISTORY
+    std::array<std::uint8_t, INPUT_HISTORY> m_remoteInputs{};  // Real, or the prediction a tick ran with
+    std::array<SavedState, STATE_HISTORY> m_states;            // Indexed by tick % STATE_HISTORY
+    
+    std::uint64_t m_rollbackCount;
+    std::uint64_t m_resimulatedTicks;
+};
+
+#endif // ROLLBACKSESSION_H
@@ -0,0 +1,65 @@
+#include "SendScheduler.h"
+#include <algorithm>
+
+//----------------------------------------------------------------------------------------
+SendScheduler::SendScheduler() 
+{
+    reset();
+}
+
+//----------------------------------------------------------------------------------------
+void SendScheduler::reset() 
+{
+    m_rate = MAX_RATE;
+    m_sendTimer = 0.0f;
+    m_adjustTimer = 0.0f;
+    m_sinceLastSend = 0.0f;
+    m_lastHash = 0;
+    m_hasHash = false;
+    m_repeatsLeft = 0;
+    m_urgent = true;
+}
+
+//----------------------------------------------------------------------------------------
+bool SendScheduler::update(float deltaTime, std::uint64_t stateHash, const ConnectionQuality& quality,
+                           std::size_t queuedSnapshots) 
+{
+    m_sendTimer += deltaTime;
+    m_sinceLastSend += deltaTime;
+    m_adjustTimer += deltaTime;
+    if (m_adjustTimer >= ADJUST_INTERVAL) {
+        m_adjustTimer = 0.0f;
+        adjustRate(quality, queuedSnapshots);
+    }
+    
+    float interval = 1.0f / m_rate;
+    bool changed = !m_hasHash || stateHash != m_lastHash;
+    bool due = m_sendTimer >= interval && (changed || m_repeatsLeft > 0);
+    if (!m_urgent && !due && m_sinceLastSend < KEEPALIVE_INTERVAL) {
+        return false;
+    }
+    
+    m_repeatsLeft = changed ? REPEAT_COUNT : std::max(0, m_repeatsLeft - 1);
+    m_lastHash = stateHash;
+    m_hasHash = true;
+    m_urgent = false;
+    m_sinceLastSend = 0.0f;
+    
+    // Keep the remainder so the rate holds at frame granularity, but never bank more than
+    // one interval (an idle stretch must not turn into a burst)
+    m_sendTimer = std::min(std::max(0.0f, m_sendTimer - interval), interval);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void SendScheduler::adjustRate(const ConnectionQuality& quality, std::size_t queuedSnapshots) 
+{
+    bool congested = quality.lossRate > LOSS_THRESHOLD
+        || quality.rttMs > RTT_THRESHOLD_MS
+        || queuedSnapshots >= QUEUE_THRESHOLD;
+    if (congested) {
+        m_rate = std::max(MIN_RATE, m_rate * RATE_DECREASE);
+    } else {
+        m_rate = std::min(MAX_RATE, m_rate + RATE_STEP);
+    }
+}
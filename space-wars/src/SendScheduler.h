@@ -0,0 +1,59 @@
+#ifndef SENDSCHEDULER_H
+#define SENDSCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "ConnectionMonitor.h"
+
+// Decides when the game sends its next snapshot
+// While the replicated state changes, snapshots go out at an adaptive rate between MIN_RATE
+// and MAX_RATE: it drops by a quarter when the heartbeat reports loss or a long round trip,
+// or snapshots back up in the outbound queue, and climbs back by RATE_STEP per adjustment
+// while the connection is clean (additive increase, multiplicative decrease, as in TCP).
+// While the state stays the same (by Snapshot::contentHash) nothing is sent beyond a few
+// repeats of the last change - any single snapshot may be lost - and a keep-alive every
+// KEEPALIVE_INTERVAL. Gameplay events (shots, hits) call requestUrgent() so the next frame
+// sends without waiting for the rate.
+class SendScheduler {
+public:
+    static constexpr float MIN_RATE = 10.0f;  // Snapshots per second
+    static constexpr float MAX_RATE = 30.0f;  // Enough for the interpolated remote spacecraft
+    
+    SendScheduler();
+    
+    // New connection: send on the next frame, starting from the maximum rate
+    void reset();
+    
+    // Send on the next frame regardless of rate or state changes
+    void requestUrgent() { m_urgent = true; }
+    
+    // Advance by deltaTime seconds; true if a snapshot of the state with stateHash should be
+    // sent now. Call once per frame while connected.
+    bool update(float deltaTime, std::uint64_t stateHash, const ConnectionQuality& quality,
+                std::size_t queuedSnapshots);
+    
+    float getRate() const { return m_rate; }
+
+private:
+    void adjustRate(const ConnectionQuality& quality, std::size_t queuedSnapshots);
+    
+    float m_rate;          // Current snapshots per second while the state changes
+    float m_sendTimer;     // Time credit toward the next rate-limited send
+    float m_adjustTimer;   // Since the last rate adjustment
+    float m_sinceLastSend;
+    std::uint64_t m_lastHash;  // Of the last snapshot sent
+    bool m_hasHash;
+    int m_repeatsLeft;     // Unchanged snapshots still to send after the last change
+    bool m_urgent;
+    
+    static constexpr float ADJUST_INTERVAL = 0.5f;   // Seconds between rate adjustments
+    static constexpr float RATE_STEP = 5.0f;         // Additive increase per adjustment
+    static constexpr float RATE_DECREASE = 0.75f;    // Multiplicative decrease when congested
+    static constexpr float LOSS_THRESHOLD = 0.05f;   // Heartbeat loss rate counted as congestion
+    static constexpr float RTT_THRESHOLD_MS = 150.0f;
+    static constexpr std::size_t QUEUE_THRESHOLD = 2;  // Snapshots waiting for the network thread
+    static constexpr float KEEPALIVE_INTERVAL = 0.5f;  // Longest gap between snapshots
+    static constexpr int REPEAT_COUNT = 3;
+};
+
+#endif // SENDSCHEDULER_H
@@ -0,0 +1,86 @@
+#include "GameServer.h"
+#include <algorithm>
+#include <csignal>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+    GameServer* g_server = nullptr;  // For the signal handler
+    
+    constexpr int DEFAULT_PORT = 5555;
+    constexpr int DEFAULT_TICK_RATE = 60;
+    constexpr int DEFAULT_MATCHES = 512;
+    constexpr int MAX_MATCHES = 16384;
+    constexpr std::size_t MAX_PROJECTILES = 1024;
+    
+    void handleSignal(int)
+    {
+        if (g_server) {
+            g_server->stop();
+        }
+    }
+    
+    bool parseArgument(const char* text, int minimum, int maximum, int& value)
+    {
+        try {
+            std::size_t used = 0;
+            value = std::stoi(text, &used);
+            return used == std::string(text).size() && value >= minimum && value <= maximum;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+} // namespace
+
+// Dedicated server: SpaceWarsServer [port] [tick_rate] [max_matches] [threads] [spectator_port]
+// Clients use transport=server with client_ip/client_port pointing here and the same tick_rate.
+// threads is the number of tick workers; by default one per core, less the one doing I/O.
+// With a spectator_port, every match is published there (0, the default, publishes nothing).
+int main(int argc, char* argv[]) 
+{
+    int port = DEFAULT_PORT;
+    int tickRate = DEFAULT_TICK_RATE;
+    int matchCount = DEFAULT_MATCHES;
+    int workerCount = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+    int spectatorPort = 0;
+    if (argc > 6 || (argc > 1 && !parseArgument(argv[1], 1, 65535, port))
+        || (argc > 2 && !parseArgument(argv[2], 10, 240, tickRate))
+        || (argc > 3 && !parseArgument(argv[3], 1, MAX_MATCHES, matchCount))
+        || (argc > 4 && !parseArgument(argv[4], 1, 256, workerCount))
+        || (argc > 5 && !parseArgument(argv[5], 0, 65535, spectatorPort))) {
+        std::cerr << "Usage: " << argv[0] << " [port (default " << DEFAULT_PORT << ")] [tick_rate 10-240 (default "
+                  << DEFAULT_TICK_RATE << ")] [max_matches 1-" << MAX_MATCHES << " (default " << DEFAULT_MATCHES
+                  << ")] [threads 1-256 (default " << workerCount << ")] [spectator_port (default 0, none)]"
+                  << std::endl;
+        return 1;
+    }
+    
+    try {
+        GameServer server(tickRate, static_cast<std::size_t>(matchCount), static_cast<std::size_t>(workerCount),
+                          MAX_PROJECTILES);
+        if (!server.open(port, spectatorPort)) {
+            return 1;
+        }
+        
+        g_server = &server;
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+        
+        std::cout << "Space Wars server listening on port " << port << " at " << tickRate
+                  << " ticks per second, up to " << matchCount << " matches on " << workerCount << " threads"
+                  << std::endl;
+        if (spectatorPort != 0) {
+            std::cout << "Publishing matches to spectators on port " << spectatorPort << std::endl;
+        }
+        server.run();
+        
+        g_server = nullptr;
+        std::cout << "Server stopped" << std::endl;
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,159 @@
+#include "ServerTransport.h"
+#include "WireFormat.h"
+#include <iostream>
+#include <vector>
+
+//----------------------------------------------------------------------------------------
+ServerTransport::ServerTransport(int playerId)
+    : m_playerId(playerId)
+    , m_statesReceived(0)
+{
+    try {
+        m_context = std::make_unique<zmq::context_t>(1);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create ZeroMQ context: " << e.what() << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+ServerTransport::~ServerTransport() 
+{
+    // Sockets must be closed before the context is destroyed
+    close();
+}
+
+//----------------------------------------------------------------------------------------
+bool ServerTransport::open(const std::string& peerIp, int peerPort, int localPort) 
+{
+    (void)localPort;  // Nothing is bound: the server answers on our connection
+    if (!m_context) {
+        return false;
+    }
+    
+    try {
+        close();
+        
+        m_socket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_DEALER);
+        m_socket->set(zmq::sockopt::linger, 0);
+        m_socket->connect("tcp://" + peerIp + ":" + std::to_string(peerPort));
+        
+        // Queued until the connection is up, so a server started after us still gets it.
+        // Stamped tick 0: nothing has been simulated before joining.
+        std::vector<std::uint8_t> buffer;
+        WireFormat::Join join;
+        join.playerId = static_cast<std::uint8_t>(m_playerId);
+        WireFormat::encodeJoin(join, 0, buffer);
+        if (!send(buffer.data(), buffer.size())) {
+            std::cerr << "Failed to send join request to the server" << std::endl;
+            close();
+            return false;
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to connect to the server: " << e.what() << std::endl;
+        close();
+        return false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void ServerTransport::close() 
+{
+    m_socket.reset();
+    m_statesReceived = 0;
+    m_events.clear();
+    m_heartbeats.clear();
+}
+
+//----------------------------------------------------------------------------------------
+bool ServerTransport::update() 
+{
+    while (!m_events.full() && m_socket->recv(m_incomingMessage, zmq::recv_flags::dontwait).has_value()) {
+        WireFormat::MessageType type;
+        const std::uint8_t* data = static_cast<const std::uint8_t*>(m_incomingMessage.data());
+        if (!WireFormat::peekMessageType(data, m_incomingMessage.size(), type)) {
+            continue;  // Not from a current server
+        }
+        
+        if (type == WireFormat::MessageType::SnapshotDelta) {
+            m_latestState.swap(m_incomingMessage);
+            m_statesReceived++;
+        } else if (type == WireFormat::MessageType::GameEvent) {
+            m_events.push().swap(m_incomingMessage);
+        } else if (type == WireFormat::MessageType::Heartbeat && !m_heartbeats.full()) {
+            m_heartbeats.push().swap(m_incomingMessage);
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void ServerTransport::wait(std::chrono::milliseconds timeout) 
+{
+    zmq::pollitem_t items[] = {
+        { m_socket->handle(), 0, ZMQ_POLLIN, 0 }
+    };
+    zmq::poll(items, 1, timeout);
+}
+
+//----------------------------------------------------------------------------------------
+bool ServerTransport::send(const std::uint8_t* data, std::size_t size) 
+{
+    // Fails only if the high water mark is reached; the caller treats it like a lost message
+    return m_socket->send(zmq::buffer(data, size), zmq::send_flags::dontwait).has_value();
+}
+
+//----------------------------------------------------------------------------------------
+bool ServerTransport::sendState(const std::uint8_t* data, std::size_t size) 
+{
+    return send(data, size);
+}
+
+//----------------------------------------------------------------------------------------
+std::size_t ServerTransport::receiveLatestState(const std::uint8_t*& data, std::size_t& size) 
+{
+    std::size_t received = m_statesReceived;
+    if (received > 0) {
+        data = static_cast<const std::uint8_t*>(m_latestState.data());
+        size = m_latestState.size();
+        m_statesReceived = 0;
+    }
+    return received;
+}
+
+//----------------------------------------------------------------------------------------
+bool ServerTransport::sendReliable(const std::uint8_t* data, std::size_t size) 
+{
+    return send(data, size);
+}
+
+//----------------------------------------------------------------------------------------
+bool ServerTransport::receiveReliable(const std::uint8_t*& data, std::size_t& size) 
+{
+    if (m_events.count == 0) {
+        return false;
+    }
+    // Its slot is only reused by the next update()
+    zmq::message_t& message = m_events.pop();
+    data = static_cast<const std::uint8_t*>(message.data());
+    size = message.size();
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool ServerTransport::sendHeartbeat(const std::uint8_t* data, std::size_t size) 
+{
+    return send(data, size);
+}
+
+//----------------------------------------------------------------------------------------
+bool ServerTransport::receiveHeartbeat(const std::uint8_t*& data, std::size_t& size) 
+{
+    if (m_heartbeats.count == 0) {
+        return false;
+    }
+    zmq::message_t& message = m_heartbeats.pop();
+    data = static_cast<const std::uint8_t*>(message.data());
+    size = message.size();
+    return true;
+}
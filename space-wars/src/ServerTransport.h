@@ -0,0 +1,76 @@
+#ifndef SERVERTRANSPORT_H
+#define SERVERTRANSPORT_H
+
+#include "Transport.h"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <zmq.hpp>
+
+// Transport to a dedicated server (SpaceWarsServer) over one ZeroMQ DEALER socket (TCP)
+// open() connects to the server at peerIp:peerPort (localPort is unused) and asks for the
+// player slot given to the constructor. All three channels share the socket, so update()
+// sorts what arrives by message type: the newest snapshot is kept, events and heartbeats are
+// buffered in small rings. While the event ring is full nothing more is read, so events back
+// up in ZeroMQ rather than being dropped.
+class ServerTransport : public Transport {
+public:
+    explicit ServerTransport(int playerId);
+    ~ServerTransport() override;
+    
+    bool open(const std::string& peerIp, int peerPort, int localPort) override;
+    void close() override;
+    bool update() override;
+    void wait(std::chrono::milliseconds timeout) override;
+    
+    bool sendState(const std::uint8_t* data, std::size_t size) override;
+    std::size_t receiveLatestState(const std::uint8_t*& data, std::size_t& size) override;
+    bool sendReliable(const std::uint8_t* data, std::size_t size) override;
+    bool receiveReliable(const std::uint8_t*& data, std::size_t& size) override;
+    bool sendHeartbeat(const std::uint8_t* data, std::size_t size) override;
+    bool receiveHeartbeat(const std::uint8_t*& data, std::size_t& size) override;
+
+private:
+    // Received messages waiting for the network thread, swapped in so their storage is recycled
+    template <std::size_t N>
+    struct MessageRing {
+        std::array<zmq::message_t, N> messages;
+        std::size_t head = 0;  // Next to read
+        std::size_t count = 0;
+        
+        bool full() const { return count == N; }
+        void clear() { head = 0; count = 0; }
+        
+        // Slot for the next message (the ring must not be full)
+        zmq::message_t& push()
+        {
+            zmq::message_t& slot = messages[(head + count) % N];
+            count++;
+            return slot;
+        }
+        
+        // Oldest message (the ring must not be empty); left in its slot until a later push
+        zmq::message_t& pop()
+        {
+            zmq::message_t& front = messages[head];
+            head = (head + 1) % N;
+            count--;
+            return front;
+        }
+    };
+    
+    bool send(const std::uint8_t* data, std::size_t size);
+    
+    int m_playerId;
+    
+    std::unique_ptr<zmq::context_t> m_context;
+    std::unique_ptr<zmq::socket_t> m_socket;
+    
+    zmq::message_t m_incomingMessage;
+    zmq::message_t m_latestState;
+    std::size_t m_statesReceived;  // Since the last receiveLatestState()
+    MessageRing<16> m_events;
+    MessageRing<8> m_heartbeats;  // More are dropped, as on the other transports
+};
+
+#endif // SERVERTRANSPORT_H
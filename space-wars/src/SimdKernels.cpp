@@ -0,0 +1,275 @@
+#include "SimdKernels.h"
+#include <array>
+#include <cstring>
+
+// x86 SIMD paths are compiled with per-function target attributes and selected at runtime,
+// so one binary runs everywhere and still uses AVX2 where available
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SPACEWARS_SIMD_X86 1
+#define SPACEWARS_TARGET_SSE2 __attribute__((target("sse2")))
+#define SPACEWARS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace {
+
+//----------------------------------------------------------------------------------------
+void overlapMaskScalar(const float* ax, const float* ay, const float* bx, const float* by,
+                       float radiusSquared, std::uint8_t* hits, std::size_t begin, std::size_t count) 
+{
+    for (std::size_t i = begin; i < count; ++i) {
+        float dx = ax[i] - bx[i];
+        float dy = ay[i] - by[i];
+        hits[i] = static_cast<std::uint8_t>(dx * dx + dy * dy < radiusSquared);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void integrateScalar(float* x, float* y, const float* vx, const float* vy, std::uint8_t* active,
+                     std::size_t begin, std::size_t count, float deltaTime, float width, float height) 
+{
+    for (std::size_t i = begin; i < count; ++i) {
+        float newX = x[i] + vx[i] * deltaTime;
+        float newY = y[i] + vy[i] * deltaTime;
+        x[i] = newX;
+        y[i] = newY;
+        bool onScreen = (newX >= 0.0f) & (newX <= width) & (newY >= 0.0f) & (newY <= height);
+        active[i] &= static_cast<std::uint8_t>(onScreen);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void overlapMaskScalarAll(const float* ax, const float* ay, const float* bx, const float* by,
+                          float radiusSquared, std::uint8_t* hits, std::size_t count) 
+{
+    overlapMaskScalar(ax, ay, bx, by, radiusSquared, hits, 0, count);
+}
+
+//----------------------------------------------------------------------------------------
+void integrateScalarAll(float* x, float* y, const float* vx, const float* vy, std::uint8_t* active,
+                        std::size_t count, float deltaTime, float width, float height) 
+{
+    integrateScalar(x, y, vx, vy, active, 0, count, deltaTime, width, height);
+}
+
+#if defined(SPACEWARS_SIMD_X86)
+
+// Expands a compare bitmask (one bit per lane) into one 0/1 byte per lane
+constexpr std::array<std::uint64_t, 256> MASK_TO_BYTES = [] {
+    std::array<std::uint64_t, 256> table{};
+    for (std::size_t mask = 0; mask < 256; ++mask) {
+        for (std::size_t lane = 0; lane < 8; ++lane) {
+            if (mask & (1u << lane)) {
+                table[mask] |= std::uint64_t{1} << (lane * 8);
+            }
+        }
+    }
+    return table;
+}();
+
+//----------------------------------------------------------------------------------------
+inline void storeMaskBytes(std::uint8_t* bytes, int mask, std::size_t lanes) 
+{
+    std::uint64_t expanded = MASK_TO_BYTES[static_cast<std::size_t>(mask)];
+    std::memcpy(bytes, &expanded, lanes);
+}
+
+//----------------------------------------------------------------------------------------
+inline void andMaskBytes(std::uint8_t* bytes, int mask, std::size_t lanes) 
+{
+    std::uint64_t current = 0;
+    std::memcpy(&current, bytes, lanes);
+    current &= MASK_TO_BYTES[static_cast<std::size_t>(mask)];
+    std::memcpy(bytes, &current, lanes);
+}
+
+//----------------------------------------------------------------------------------------
+SPACEWARS_TARGET_SSE2
+void overlapMaskSse2(const float* ax, const float* ay, const float* bx, const float* by,
+                     float radiusSquared, std::uint8_t* hits, std::size_t count) 
+{
+    const __m128 r2 = _mm_set1_ps(radiusSquared);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(ax + i), _mm_loadu_ps(bx + i));
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ay + i), _mm_loadu_ps(by + i));
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        storeMaskBytes(hits + i, _mm_movemask_ps(_mm_cmplt_ps(d2, r2)), 4);
+    }
+    overlapMaskScalar(ax, ay, bx, by, radiusSquared, hits, i, count);
+}
+
+//----------------------------------------------------------------------------------------
+SPACEWARS_TARGET_AVX2
+void overlapMaskAvx2(const float* ax, const float* ay, const float* bx, const float* by,
+                     float radiusSquared, std::uint8_t* hits, std::size_t count) 
+{
+    const __m256 r2 = _mm256_set1_ps(radiusSquared);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(ax + i), _mm256_loadu_ps(bx + i));
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(ay + i), _mm256_loadu_ps(by + i));
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        storeMaskBytes(hits + i, _mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LT_OQ)), 8);
+    }
+    overlapMaskScalar(ax, ay, bx, by, radiusSquared, hits, i, count);
+}
+
+//----------------------------------------------------------------------------------------
+SPACEWARS_TARGET_SSE2
+void integrateSse2(float* x, float* y, const float* vx, const float* vy, std::uint8_t* active,
+                   std::size_t count, float deltaTime, float width, float height) 
+{
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxX = _mm_set1_ps(width);
+    const __m128 maxY = _mm_set1_ps(height);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 newX = _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), dt));
+        __m128 newY = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(vy + i), dt));
+        _mm_storeu_ps(x + i, newX);
+        _mm_storeu_ps(y + i, newY);
+        
+        // Off-screen test as compare masks instead of four branches
+        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(newX, zero), _mm_cmple_ps(newX, maxX)),
+                                   _mm_and_ps(_mm_cmpge_ps(newY, zero), _mm_cmple_ps(newY, maxY)));
+        andMaskBytes(active + i, _mm_movemask_ps(inside), 4);
+    }
+    integrateScalar(x, y, vx, vy, active, i, count, deltaTime, width, height);
+}
+
+//----------------------------------------------------------------------------------------
+SPACEWARS_TARGET_AVX2
+void integrateAvx2(float* x, float* y, const float* vx, const float* vy, std::uint8_t* active,
+                   std::size_t count, float deltaTime, float width, float height) 
+{
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 maxX = _mm256_set1_ps(width);
+    const __m256 maxY = _mm256_set1_ps(height);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 newX = _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), dt));
+        __m256 newY = _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), dt));
+        _mm256_storeu_ps(x + i, newX);
+        _mm256_storeu_ps(y + i, newY);
+        
+        // Off-screen test as compare masks instead of four branches
+        __m256 inside = _mm256_and_ps(
+            _mm256_and_ps(_mm256_cmp_ps(newX, zero, _CMP_GE_OQ), _mm256_cmp_ps(newX, maxX, _CMP_LE_OQ)),
+            _mm256_and_ps(_mm256_cmp_ps(newY, zero, _CMP_GE_OQ), _mm256_cmp_ps(newY, maxY, _CMP_LE_OQ)));
+        andMaskBytes(active + i, _mm256_movemask_ps(inside), 8);
+    }
+    integrateScalar(x, y, vx, vy, active, i, count, deltaTime, width, height);
+}
+
+#endif // SPACEWARS_SIMD_X86
+
+// Kernel table for one instruction set
+struct KernelTable {
+    SimdKernels::InstructionSet instructionSet;
+    const char* name;
+    void (*overlapMask)(const float*, const float*, const float*, const float*, float, std::uint8_t*, std::size_t);
+    void (*integrateProjectiles)(float*, float*, const float*, const float*, std::uint8_t*, std::size_t,
+                                 float, float, float);
+};
+
+constexpr KernelTable SCALAR_KERNELS = {
+    SimdKernels::InstructionSet::Scalar, "scalar", overlapMaskScalarAll, integrateScalarAll
+};
+#if defined(SPACEWARS_SIMD_X86)
+constexpr KernelTable SSE2_KERNELS = {
+    SimdKernels::InstructionSet::SSE2, "SSE2", overlapMaskSse2, integrateSse2
+};
+constexpr KernelTable AVX2_KERNELS = {
+    SimdKernels::InstructionSet::AVX2, "AVX2", overlapMaskAvx2, integrateAvx2
+};
+#endif
+
+//----------------------------------------------------------------------------------------
+const KernelTable* tableFor(SimdKernels::InstructionSet instructionSet) 
+{
+    switch (instructionSet) {
+#if defined(SPACEWARS_SIMD_X86)
+        case SimdKernels::InstructionSet::AVX2:
+            return &AVX2_KERNELS;
+        case SimdKernels::InstructionSet::SSE2:
+            return &SSE2_KERNELS;
+#endif
+        default:
+            return &SCALAR_KERNELS;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+const KernelTable*& activeKernels() 
+{
+    // Picked once, on first use: the best instruction set this CPU supports
+    static const KernelTable* kernels = [] {
+        if (SimdKernels::isSupported(SimdKernels::InstructionSet::AVX2)) {
+            return tableFor(SimdKernels::InstructionSet::AVX2);
+        }
+        if (SimdKernels::isSupported(SimdKernels::InstructionSet::SSE2)) {
+            return tableFor(SimdKernels::InstructionSet::SSE2);
+        }
+        return tableFor(SimdKernels::InstructionSet::Scalar);
+    }();
+    return kernels;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+void SimdKernels::overlapMask(const float* ax, const float* ay, const float* bx, const float* by,
+                              float radiusSquared, std::uint8_t* hits, std::size_t count) 
+{
+    activeKernels()->overlapMask(ax, ay, bx, by, radiusSquared, hits, count);
+}
+
+//----------------------------------------------------------------------------------------
+void SimdKernels::integrateProjectiles(float* x, float* y, const float* vx, const float* vy,
+                                       std::uint8_t* active, std::size_t count,
+                                       float deltaTime, float width, float height) 
+{
+    activeKernels()->integrateProjectiles(x, y, vx, vy, active, count, deltaTime, width, height);
+}
+
+//----------------------------------------------------------------------------------------
+SimdKernels::InstructionSet SimdKernels::getInstructionSet() 
+{
+    return activeKernels()->instructionSet;
+}
+
+//----------------------------------------------------------------------------------------
+const char* SimdKernels::getInstructionSetName() 
+{
+    return activeKernels()->name;
+}
+
+//----------------------------------------------------------------------------------------
+bool SimdKernels::isSupported(InstructionSet instructionSet) 
+{
+    switch (instructionSet) {
+        case InstructionSet::Scalar:
+            return true;
+#if defined(SPACEWARS_SIMD_X86)
+        case InstructionSet::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case InstructionSet::AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+bool SimdKernels::setInstructionSet(InstructionSet instructionSet) 
+{
+    if (!isSupported(instructionSet)) {
+        return false;
+    }
+    activeKernels() = tableFor(instructionSet);
+    return true;
+}
@@ -0,0 +1,38 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Batch math kernels for the simulation hot loops
+// Each kernel has an AVX2, SSE2 and scalar implementation that produce identical results.
+// The fastest implementation the CPU supports is selected at runtime on first use.
+namespace SimdKernels {
+    enum class InstructionSet {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+    
+    // hits[i] = 1 if the squared distance between (ax[i], ay[i]) and (bx[i], by[i]) is less
+    // than radiusSquared, otherwise 0
+    void overlapMask(const float* ax, const float* ay, const float* bx, const float* by,
+                     float radiusSquared, std::uint8_t* hits, std::size_t count);
+    
+    // Move count projectiles by velocity * deltaTime and clear active[i] for every projectile
+    // that ends up outside [0, width] x [0, height]
+    void integrateProjectiles(float* x, float* y, const float* vx, const float* vy,
+                              std::uint8_t* active, std::size_t count,
+                              float deltaTime, float width, float height);
+    
+    // Instruction set in use
+    InstructionSet getInstructionSet();
+    const char* getInstructionSetName();
+    
+    // Check / force an instruction set (for benchmarks and comparisons)
+    // setInstructionSet returns false and changes nothing if the CPU doesn't support it
+    bool isSupported(InstructionSet instructionSet);
+    bool setInstructionSet(InstructionSet instructionSet);
+}
+
+#endif // SIMDKERNELS_H
@@ -0,0 +1,355 @@
+#include "Simulation.h"
+#include "Quantization.h"
+#include "Constants.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+//----------------------------------------------------------------------------------------
+Simulation::Simulation(unsigned int seed)
+    : m_grid(static_cast<float>(Constants::WINDOW_WIDTH), static_cast<float>(Constants::WINDOW_HEIGHT))
+    , m_controlled{true, true}
+    , m_authoritative(true)
+{
+    m_gameState.seedRandom(seed);
+    m_hitEvents.reserve(2);
+    m_spawnEvents.reserve(2);
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::setPlayerControlled(int playerId, bool controlled) 
+{
+    m_controlled[playerId == 1 ? 0 : 1] = controlled;
+}
+
+//----------------------------------------------------------------------------------------
+bool Simulation::isPlayerControlled(int playerId) const 
+{
+    return m_controlled[playerId == 1 ? 0 : 1];
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::reset() 
+{
+    m_gameState.reset();
+    m_hitEvents.clear();
+    m_spawnEvents.clear();
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::step(const std::array<PlayerInput, 2>& inputs, float deltaTime) 
+{
+    m_hitEvents.clear();
+    m_spawnEvents.clear();
+    
+    // Update spacecraft (dead spacecraft neither move nor accept input)
+    for (int playerId = 1; playerId <= 2; ++playerId) {
+        Spacecraft& spacecraft = m_gameState.getSpacecraft(playerId);
+        if (!spacecraft.isAlive()) {
+            continue;
+        }
+        
+        if (isPlayerControlled(playerId)) {
+            applyInput(playerId, inputs[playerId - 1], deltaTime);
+        } else {
+            spacecraft.update(deltaTime);
+        }
+    }
+    
+    // Update projectiles
+    m_gameState.updateProjectiles(deltaTime);
+    m_gameState.removeInactiveProjectiles();
+    
+    if (m_authoritative) {
+        // Check collisions
+        checkCollisions();
+        
+        // Update respawn timers
+        updateRespawnTimers(deltaTime);
+    }
+    
+    m_gameState.advanceTime(deltaTime);
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::applyInput(int playerId, const PlayerInput& input, float deltaTime) 
+{
+    moveSpacecraft(m_gameState.getSpacecraft(playerId), input, deltaTime);
+    
+    // Handle firing (input.fire is already edge-triggered by the input source)
+    if (input.fire) {
+        fireProjectile(playerId);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::moveSpacecraft(Spacecraft& spacecraft, const PlayerInput& input, float deltaTime) 
+{
+    // Rotate left
+    if (input.left) {
+        spacecraft.rotateLeft(deltaTime);
+    }
+    
+    // Rotate right
+    if (input.right) {
+        spacecraft.rotateRight(deltaTime);
+    }
+    
+    // Apply thrust
+    if (input.thrust) {
+        spacecraft.applyThrust(deltaTime);
+        spacecraft.setThrusting(true);
+    } else {
+        spacecraft.setThrusting(false);
+    }
+    
+    // Update spacecraft
+    spacecraft.update(deltaTime);
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::fireProjectile(int playerId) 
+{
+    const Spacecraft& spacecraft = m_gameState.getSpacecraft(playerId);
+    
+    // Allow multiple projectiles - just add a new one without removing existing ones
+    // Calculate projectile direction from spacecraft orientation. The orientation and start
+    // position are snapped onto the wire grids so a SpawnEvent reproduces the shot exactly.
+    float orientation = Quantization::orientation(spacecraft.getOrientation());
+    sf::Vector2f direction = firingDirection(orientation);
+    
+    // Calculate projectile starting position (front of spacecraft)
+    float spacecraftSize = 15.0f;
+    sf::Vector2f startPosition = spacecraft.getPosition() + direction * spacecraftSize;
+    startPosition = sf::Vector2f(Quantization::positionX(startPosition.x), Quantization::positionY(startPosition.y));
+    
+    // Create and add projectile
+    Projectile projectile(startPosition, direction, playerId);
+    std::uint32_t projectileId = m_gameState.addProjectile(projectile);
+    if (projectileId == Entity::INVALID) {
+        return;  // Pool full
+    }
+    
+    m_spawnEvents.push_back(SpawnEvent{projectileId, playerId, startPosition, orientation, m_gameState.getTime()});
+}
+
+//----------------------------------------------------------------------------------------
+sf::Vector2f Simulation::firingDirection(float orientation) 
+{
+    float angleRad = orientation * M_PI / 180.0f;
+    return sf::Vector2f(std::cos(angleRad), std::sin(angleRad));
+}
+
+//----------------------------------------------------------------------------------------
+bool Simulation::spawnProjectile(const SpawnEvent& spawn, float age) 
+{
+    ProjectilePool& projectiles = m_gameState.getProjectiles();
+    if (Entity::ownerPlayerId(spawn.projectileId) != spawn.ownerPlayerId
+        || projectiles.find(spawn.projectileId) != ProjectilePool::NOT_FOUND) {
+        return false;  // Malformed or already spawned
+    }
+    
+    // Same velocity the firing simulation computed, on the same grid
+    Projectile projectile(spawn.origin, firingDirection(spawn.orientation), spawn.ownerPlayerId);
+    sf::Vector2f velocity(Quantization::velocity(projectile.getVelocity().x, Quantization::PROJECTILE_VELOCITY_LIMIT),
+                          Quantization::velocity(projectile.getVelocity().y, Quantization::PROJECTILE_VELOCITY_LIMIT));
+    sf::Vector2f position = spawn.origin + velocity * age;
+    position = sf::Vector2f(Quantization::positionX(position.x), Quantization::positionY(position.y));
+    return projectiles.insert(position, velocity, spawn.projectileId);
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::checkCollisions() 
+{
+    // Broadphase: bin projectiles and spacecraft into the grid, then gather the
+    // projectiles near each living spacecraft as candidate pairs
+    m_grid.build(m_gameState);
+    m_narrowphase.clear();
+    
+    for (int playerId = 1; playerId <= 2; ++playerId) {
+        const Spacecraft& spacecraft = m_gameState.getSpacecraft(playerId);
+        // Don't check collision with dead spacecraft
+        if (!spacecraft.isAlive()) {
+            continue;
+        }
+        
+        sf::Vector2f scPos = spacecraft.getPosition();
+        m_grid.forEachCandidate(scPos, Constants::SPACECRAFT_SIZE + Constants::PROJECTILE_SIZE,
+                                [&](const SpatialGrid::Entry& entry) {
+            // Projectiles can't hit the spacecraft that fired them
+            if (entry.type == SpatialGrid::EntityType::Projectile && entry.ownerPlayerId != playerId) {
+                m_narrowphase.addCandidate(entry.index, sf::Vector2f(entry.x, entry.y),
+                                           entry.ownerPlayerId, playerId, scPos);
+            }
+        });
+    }
+    
+    // Narrowphase: batch distance test producing every contact of this step in a stable order
+    // (projectiles don't wrap, so plain distances are compared)
+    m_narrowphase.findContacts(Constants::SPACECRAFT_SIZE + Constants::PROJECTILE_SIZE, m_contacts);
+    
+    // Resolve contacts in order - a spacecraft can only be destroyed once per step, but hits
+    // on both spacecraft in the same step are all applied
+    for (const Contact& contact : m_contacts) {
+        if (m_gameState.getSpacecraft(contact.victimId).isAlive()) {
+            handleHit(contact);
+        }
+    }
+    
+    // Drop the projectiles that hit (deferred so contact indices stay valid while resolving)
+    m_gameState.removeInactiveProjectiles();
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::handleHit(const Contact& contact) 
+{
+    int projectileOwnerId = contact.shooterId;
+    int hitSpacecraftId = contact.victimId;
+    
+    // Spend only the specific projectile that hit (not all projectiles from that player)
+    ProjectilePool& projectiles = m_gameState.getProjectiles();
+    projectiles.setActive(contact.projectileIndex, false);
+    std::uint32_t projectileId = projectiles.getId(contact.projectileIndex);
+    
+    sf::Vector2f destructionPos = m_gameState.getSpacecraft(hitSpacecraftId).getPosition();
+    destroySpacecraft(projectileOwnerId, hitSpacecraftId, destructionPos);
+    
+    // Report the hit so the presentation layer and the network can react
+    m_hitEvents.push_back(HitEvent{projectileOwnerId, hitSpacecraftId, destructionPos, projectileId});
+}
+
+//----------------------------------------------------------------------------------------
+bool Simulation::applyHit(const HitEvent& hit) 
+{
+    if (hit.projectileId != 0) {
+        m_gameState.removeProjectile(hit.projectileId);
+    }
+    if (!m_gameState.getSpacecraft(hit.victimId).isAlive()) {
+        return false;
+    }
+    destroySpacecraft(hit.shooterId, hit.victimId, m_gameState.getSpacecraft(hit.victimId).getPosition());
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::destroySpacecraft(int shooterId, int victimId, sf::Vector2f destructionPos) 
+{
+    // Increment score for the player who fired
+    m_gameState.incrementScore(shooterId);
+    
+    // Mark spacecraft as dead
+    Spacecraft& hitSpacecraft = m_gameState.getSpacecraft(victimId);
+    hitSpacecraft.setAlive(false);
+    hitSpacecraft.setVelocity(sf::Vector2f(0.0f, 0.0f));  // Stop movement
+    hitSpacecraft.setThrusting(false);  // Stop thrust animation
+    
+    // Start respawn timer
+    RespawnState& respawn = m_gameState.getRespawnState(victimId);
+    respawn.timer = 0.0f;  // Start timer at 0
+    respawn.avoidPosition = destructionPos;  // Store destruction position
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::updateRespawnTimers(float deltaTime) 
+{
+    for (int playerId = 1; playerId <= 2; ++playerId) {
+        RespawnState& respawn = m_gameState.getRespawnState(playerId);
+        if (respawn.timer >= 0.0f) {
+            respawn.timer += deltaTime;
+            if (respawn.timer >= RESPAWN_DELAY) {
+                respawnSpacecraft(playerId, respawn.avoidPosition);
+                respawn.timer = -1.0f;  // Reset timer (negative = inactive)
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void Simulation::respawnSpacecraft(int playerId, sf::Vector2f avoidPosition) 
+{
+    Spacecraft& spacecraft = m_gameState.getSpacecraft(playerId);
+    std::minstd_rand& random = m_gameState.getRandom();
+    
+    // Initial spawn positions (to avoid respawning at these)
+    sf::Vector2f initialPos1(100.0f, Constants::WINDOW_HEIGHT / 2.0f);
+    sf::Vector2f initialPos2(Constants::WINDOW_WIDTH - 100.0f, Constants::WINDOW_HEIGHT / 2.0f);
+    sf::Vector2f initialPos = (playerId == 1) ? initialPos1 : initialPos2;
+    
+    // Minimum distance to avoid respawning too close to avoided positions
+    constexpr float MIN_DISTANCE = 150.0f;
+    
+    // Try to find a valid random position (max attempts to avoid infinite loop)
+    float x, y;
+    int attempts = 0;
+    constexpr int MAX_ATTEMPTS = 100;
+    
+    do {
+        // Generate random position within screen bounds
+        // Leave some margin from edges (50 pixels)
+        x = 50.0f + static_cast<float>(random() % (Constants::WINDOW_WIDTH - 100));
+        y = 50.0f + static_cast<float>(random() % (Constants::WINDOW_HEIGHT - 100));
+        
+        attempts++;
+        
+        // Check distance from initial spawn position
+        float distToInitial = std::sqrt(
+            (x - initialPos.x) * (x - initialPos.x) +
+            (y - initialPos.y) * (y - initialPos.y)
+        );
+        
+        // Check distance from destruction position
+        float distToDestruction = std::sqrt(
+            (x - avoidPosition.x) * (x - avoidPosition.x) +
+            (y - avoidPosition.y) * (y - avoidPosition.y)
+        );
+        
+        // If position is far enough from both and not in immediate danger, use it
+        if (distToInitial >= MIN_DISTANCE && distToDestruction >= MIN_DISTANCE &&
+            isSafeSpawnPosition(playerId, sf::Vector2f(x, y))) {
+            break;
+        }
+        
+    } while (attempts < MAX_ATTEMPTS);
+    
+    // If we couldn't find a good position after max attempts, use a fallback
+    // Position on the opposite side from initial spawn
+    if (attempts >= MAX_ATTEMPTS) {
+        if (playerId == 1) {
+            // Player 1: try right side
+            x = Constants::WINDOW_WIDTH - 150.0f;
+            y = Constants::WINDOW_HEIGHT / 2.0f;
+        } else {
+            // Player 2: try left side
+            x = 150.0f;
+            y = Constants::WINDOW_HEIGHT / 2.0f;
+        }
+    }
+    
+    // Random orientation
+    float orientation = static_cast<float>(random() % 360);
+    
+    // Reset spacecraft at random position
+    spacecraft.reset(sf::Vector2f(x, y), orientation);
+}
+
+//----------------------------------------------------------------------------------------
+bool Simulation::isSafeSpawnPosition(int playerId, sf::Vector2f position) const 
+{
+    // Keep clear of the other spacecraft and of enemy projectiles (uses the grid from this step)
+    constexpr float MIN_SPACECRAFT_DISTANCE = 150.0f;
+    constexpr float MIN_PROJECTILE_DISTANCE = 60.0f;
+    
+    bool safe = true;
+    m_grid.forEachWithin(position, MIN_SPACECRAFT_DISTANCE, [&](const SpatialGrid::Entry& entry, float distanceSquared) {
+        if (entry.ownerPlayerId == playerId) {
+            return;
+        }
+        if (entry.type == SpatialGrid::EntityType::Spacecraft ||
+            distanceSquared < MIN_PROJECTILE_DISTANCE * MIN_PROJECTILE_DISTANCE) {
+            safe = false;
+        }
+    });
+    return safe;
+}
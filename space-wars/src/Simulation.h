@@ -0,0 +1,111 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GameState.h"
+#include "PlayerInput.h"
+#include "SpatialGrid.h"
+#include "Narrowphase.h"
+
+// A projectile hit resolved during the last simulation step
+struct HitEvent {
+    int shooterId;  // Player who fired the projectile
+    int victimId;   // Player whose spacecraft was destroyed
+    sf::Vector2f position;  // Where the spacecraft was destroyed
+    std::uint32_t projectileId;  // Handle of the projectile that hit (already removed)
+};
+
+// A projectile fired during the last simulation step
+// Projectiles fly in a straight line at constant speed, so this is enough for another
+// simulation to reproduce it (see spawnProjectile).
+struct SpawnEvent {
+    std::uint32_t projectileId;  // Handle assigned by the firing simulation (see EntityRegistry.h)
+    int ownerPlayerId;
+    sf::Vector2f origin;  // Position when fired
+    float orientation;    // Firing direction in degrees (the spacecraft's orientation)
+    double time;          // Simulated time when fired (GameState::getTime at the start of the step)
+};
+
+// Headless game simulation
+// Owns the GameState and advances it by discrete steps. Has no window, font or
+// rendering dependency so matches can run without a display (servers, bots, benchmarks).
+class Simulation {
+public:
+    explicit Simulation(unsigned int seed = 1);
+    
+    // Advance the match by deltaTime seconds
+    // inputs[0] drives player 1 and inputs[1] drives player 2; input for a player that is
+    // not controlled by this simulation is ignored (its spacecraft only integrates physics)
+    void step(const std::array<PlayerInput, 2>& inputs, float deltaTime);
+    
+    // Select which spacecraft are driven by step() inputs
+    // A spacecraft whose state is replicated from the network should not be controlled
+    void setPlayerControlled(int playerId, bool controlled);  // playerId is 1 or 2
+    bool isPlayerControlled(int playerId) const;
+    
+    // A simulation that is not authoritative only moves things: hits and respawns are left
+    // to the server that owns the match (and arrive as events and snapshots)
+    void setAuthoritative(bool authoritative) { m_authoritative = authoritative; }
+    bool isAuthoritative() const { return m_authoritative; }
+    
+    // Hits resolved and projectiles fired during the last call to step()
+    const std::vector<HitEvent>& getHitEvents() const { return m_hitEvents; }
+    const std::vector<SpawnEvent>& getSpawnEvents() const { return m_spawnEvents; }
+    
+    // Apply a hit resolved elsewhere (reported by the peer that owns the victim)
+    // Removes the projectile if it is still flying, then scores the hit and destroys the
+    // spacecraft like a local hit. Returns false, scoring nothing, if that spacecraft is
+    // already destroyed. Not added to getHitEvents().
+    bool applyHit(const HitEvent& hit);
+    
+    // Add a projectile fired elsewhere, moved forward by age seconds along its path
+    // Returns false if the pool is full or a projectile with that ID already exists.
+    bool spawnProjectile(const SpawnEvent& spawn, float age);
+    
+    // All projectile/spacecraft contacts found during the last call to step(), in resolution order
+    const std::vector<Contact>& getContacts() const { return m_contacts; }
+    
+    // State access
+    GameState& getGameState() { return m_gameState; }
+    const GameState& getGameState() const { return m_gameState; }
+    
+    // Broadphase grid as built during the last step (for AI and other proximity queries)
+    const SpatialGrid& getSpatialGrid() const { return m_grid; }
+    
+    // Reset the match to its initial state
+    void reset();
+    
+    // Movement part of one step for a controlled spacecraft: rotation, thrust and physics
+    // (no firing). Exactly what step() does to the spacecraft, so client prediction can
+    // replay inputs on its own.
+    static void moveSpacecraft(Spacecraft& spacecraft, const PlayerInput& input, float deltaTime);
+    
+private:
+    // Per-step stages
+    void applyInput(int playerId, const PlayerInput& input, float deltaTime);
+    void fireProjectile(int playerId);
+    static sf::Vector2f firingDirection(float orientation);
+    void checkCollisions();
+    void handleHit(const Contact& contact);
+    void destroySpacecraft(int shooterId, int victimId, sf::Vector2f destructionPos);
+    void updateRespawnTimers(float deltaTime);
+    void respawnSpacecraft(int playerId, sf::Vector2f avoidPosition);
+    bool isSafeSpawnPosition(int playerId, sf::Vector2f position) const;
+    
+    GameState m_gameState;
+    SpatialGrid m_grid;
+    Narrowphase m_narrowphase;
+    std::vector<Contact> m_contacts;
+    std::array<bool, 2> m_controlled;
+    bool m_authoritative;
+    std::vector<HitEvent> m_hitEvents;
+    std::vector<SpawnEvent> m_spawnEvents;
+    
+    static constexpr float RESPAWN_DELAY = 1.5f;  // Delay before respawning in seconds
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,99 @@
+#include "Snapshot.h"
+#include "GameState.h"
+#include "Quantization.h"
+#include <cmath>
+
+//----------------------------------------------------------------------------------------
+void Snapshot::capture(const GameState& gameState) 
+{
+    using namespace Quantization;
+    
+    // Recorded as the peer will decode it, so our baselines match the peer's exactly
+    timeMs = static_cast<std::uint32_t>(std::llround(gameState.getTime() * 1000.0));
+    
+    for (int playerId = 1; playerId <= 2; ++playerId) {
+        const Spacecraft& spacecraft = gameState.getSpacecraft(playerId);
+        ShipSnapshot& ship = ships[playerId - 1];
+        ship.x = positionX(spacecraft.getPosition().x);
+        ship.y = positionY(spacecraft.getPosition().y);
+        ship.orientation = orientation(spacecraft.getOrientation());
+        ship.velocityX = velocity(spacecraft.getVelocity().x, SPACECRAFT_VELOCITY_LIMIT);
+        ship.velocityY = velocity(spacecraft.getVelocity().y, SPACECRAFT_VELOCITY_LIMIT);
+        ship.flags = static_cast<std::uint8_t>((spacecraft.isThrusting() ? ShipSnapshot::SHIP_THRUSTING : 0) |
+                                               (spacecraft.isAlive() ? ShipSnapshot::SHIP_ALIVE : 0));
+        scores[playerId - 1] = static_cast<std::uint8_t>(gameState.getScore(playerId));
+    }
+    gameOver = gameState.isGameOver();
+}
+
+//----------------------------------------------------------------------------------------
+void Snapshot::apply(GameState& gameState) const 
+{
+    for (int playerId = 1; playerId <= 2; ++playerId) {
+        const ShipSnapshot& ship = ships[playerId - 1];
+        Spacecraft& spacecraft = gameState.getSpacecraft(playerId);
+        spacecraft.setPosition(sf::Vector2f(ship.x, ship.y));
+        spacecraft.setOrientation(ship.orientation);
+        spacecraft.setVelocity(sf::Vector2f(ship.velocityX, ship.velocityY));
+        spacecraft.setThrusting((ship.flags & ShipSnapshot::SHIP_THRUSTING) != 0);
+        spacecraft.setAlive((ship.flags & ShipSnapshot::SHIP_ALIVE) != 0);
+        gameState.setScore(playerId, scores[playerId - 1]);
+    }
+    gameState.setGameOver(gameOver);
+    gameState.setTime(static_cast<double>(timeMs) / 1000.0);
+}
+
+//----------------------------------------------------------------------------------------
+std::uint64_t Snapshot::contentHash() const 
+{
+    using namespace Quantization;
+    
+    // FNV-1a over the quantized fields
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](std::uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash = (hash ^ ((value >> shift) & 0xFF)) * 1099511628211ull;
+        }
+    };
+    for (const ShipSnapshot& ship : ships) {
+        mix(encodePositionX(ship.x));
+        mix(encodePositionY(ship.y));
+        mix(encodeOrientation(ship.orientation));
+        mix(encodeVelocity(ship.velocityX, SPACECRAFT_VELOCITY_LIMIT));
+        mix(encodeVelocity(ship.velocityY, SPACECRAFT_VELOCITY_LIMIT));
+        mix(ship.flags);
+    }
+    mix(scores[0]);
+    mix(scores[1]);
+    mix(gameOver ? 1 : 0);
+    return hash;
+}
+
+//----------------------------------------------------------------------------------------
+void Snapshot::clear() 
+{
+    sequence = 0;
+    timeMs = 0;
+    ships = {};
+    scores = {0, 0};
+    gameOver = false;
+    inputAck = 0;
+}
+
+//----------------------------------------------------------------------------------------
+const Snapshot* SnapshotHistory::find(std::uint32_t sequence) const 
+{
+    const Snapshot& snapshot = m_snapshots[sequence % SIZE];
+    if (sequence == 0 || snapshot.sequence != sequence) {
+        return nullptr;
+    }
+    return &snapshot;
+}
+
+//----------------------------------------------------------------------------------------
+void SnapshotHistory::clear() 
+{
+    for (Snapshot& snapshot : m_snapshots) {
+        snapshot.clear();
+    }
+}
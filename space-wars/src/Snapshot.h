@@ -0,0 +1,66 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+class GameState;
+
+// Replicated state of one spacecraft
+struct ShipSnapshot {
+    float x = 0.0f;
+    float y = 0.0f;
+    float orientation = 0.0f;
+    float velocityX = 0.0f;
+    float velocityY = 0.0f;
+    std::uint8_t flags = 0;  // SHIP_THRUSTING | SHIP_ALIVE
+    
+    static constexpr std::uint8_t SHIP_THRUSTING = 0x01;
+    static constexpr std::uint8_t SHIP_ALIVE = 0x02;
+};
+
+// The replicated part of a GameState at one point in time
+// Projectiles are not included: they are replicated by spawn and despawn events.
+struct Snapshot {
+    std::uint32_t sequence = 0;  // 0 means empty (no state received yet)
+    std::uint32_t timeMs = 0;    // Simulated time of the sender
+    std::array<ShipSnapshot, 2> ships;
+    std::array<std::uint8_t, 2> scores = {0, 0};
+    bool gameOver = false;
+    std::uint32_t inputAck = 0;  // Newest input of the receiving player the sender has simulated, 0 if the sender is not authoritative
+    
+    // Record gameState
+    void capture(const GameState& gameState);
+    
+    // Write the snapshot into gameState (its time becomes timeMs, projectiles are untouched)
+    void apply(GameState& gameState) const;
+    
+    // Hash of the replicated content on the wire grids (sequence and time excluded), so two
+    // snapshots the peer would decode identically hash the same
+    std::uint64_t contentHash() const;
+    
+    void clear();
+};
+
+// Ring of recent snapshots indexed by sequence number
+// Used on both ends of a delta-compressed stream: the sender keeps what it sent so it can
+// diff against whatever the peer acknowledges, the receiver keeps what it decoded so it
+// has the baseline the next delta refers to.
+class SnapshotHistory {
+public:
+    static constexpr std::size_t SIZE = 64;
+    
+    // Slot that will hold snapshot sequence (overwrites the snapshot SIZE sequences older)
+    Snapshot& slot(std::uint32_t sequence) { return m_snapshots[sequence % SIZE]; }
+    
+    // Stored snapshot with this sequence, or nullptr if it was never stored or was overwritten
+    const Snapshot* find(std::uint32_t sequence) const;
+    
+    void clear();
+
+private:
+    std::array<Snapshot, SIZE> m_snapshots;
+};
+
+#endif // SNAPSHOT_H
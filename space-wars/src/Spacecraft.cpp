@@ -122,10 +122,11 @@ void Spacecraft::applyGravitationalForce(float deltaTime)
 }
 
 //----------------------------------------------------------------------------------------
-void Spacecraft::applyFriction(float /*deltaTime*/) 
+void Spacecraft::applyFriction(float deltaTime) 
 {
     // Apply friction to gradually slow down
-    m_velocity *= Constants::SPACECRAFT_FRICTION;
+    // Scale the per-frame multiplier by elapsed time so the result does not depend on step size
+    m_velocity *= std::pow(Constants::SPACECRAFT_FRICTION, deltaTime * Constants::SPACECRAFT_FRICTION_RATE);
     
     // Stop very small velocities to prevent jitter
     if (std::abs(m_velocity.x) < 0.1f) m_velocity.x = 0.0f;
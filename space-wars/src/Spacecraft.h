@@ -1,7 +1,7 @@
 #ifndef SPACECRAFT_H
 #define SPACECRAFT_H
 
-#include <SFML/Graphics.hpp>
+#include <SFML/System/Vector2.hpp>
 #include "Constants.h"
 
 class Spacecraft {
@@ -0,0 +1,117 @@
+#include "SpatialGrid.h"
+#include "GameState.h"
+#include <algorithm>
+
+//----------------------------------------------------------------------------------------
+SpatialGrid::SpatialGrid(float width, float height, float cellSize)
+    : m_width(width)
+    , m_height(height)
+    , m_cellSize(cellSize)
+    , m_inverseCellSize(1.0f / cellSize)
+    , m_columns(std::max(1, static_cast<int>(std::ceil(width / cellSize))))
+    , m_rows(std::max(1, static_cast<int>(std::ceil(height / cellSize))))
+{
+    m_cellStart.assign(static_cast<std::size_t>(m_columns * m_rows + 1), 0);
+}
+
+//----------------------------------------------------------------------------------------
+int SpatialGrid::wrapIndex(int index, int count) 
+{
+    index %= count;
+    return (index < 0) ? index + count : index;
+}
+
+//----------------------------------------------------------------------------------------
+int SpatialGrid::cellIndex(float x, float y) const 
+{
+    // Positions on the far edge (x == width) belong to the last column, not a new one
+    int column = std::clamp(static_cast<int>(x * m_inverseCellSize), 0, m_columns - 1);
+    int row = std::clamp(static_cast<int>(y * m_inverseCellSize), 0, m_rows - 1);
+    return row * m_columns + column;
+}
+
+//----------------------------------------------------------------------------------------
+sf::Vector2f SpatialGrid::wrappedDelta(sf::Vector2f from, sf::Vector2f to) const 
+{
+    sf::Vector2f delta = to - from;
+    if (delta.x > m_width / 2.0f) {
+        delta.x -= m_width;
+    } else if (delta.x < -m_width / 2.0f) {
+        delta.x += m_width;
+    }
+    if (delta.y > m_height / 2.0f) {
+        delta.y -= m_height;
+    } else if (delta.y < -m_height / 2.0f) {
+        delta.y += m_height;
+    }
+    return delta;
+}
+
+//----------------------------------------------------------------------------------------
+void SpatialGrid::begin() 
+{
+    m_pending.clear();
+    m_pendingCell.clear();
+}
+
+//----------------------------------------------------------------------------------------
+void SpatialGrid::insert(sf::Vector2f position, std::uint32_t index, EntityType type, int ownerPlayerId) 
+{
+    m_pending.push_back(Entry{position.x, position.y, index, type, static_cast<std::uint8_t>(ownerPlayerId)});
+    m_pendingCell.push_back(static_cast<std::uint32_t>(cellIndex(position.x, position.y)));
+}
+
+//----------------------------------------------------------------------------------------
+void SpatialGrid::finish() 
+{
+    const std::size_t cellCount = m_cellStart.size() - 1;
+    
+    // Count entries per cell (shifted by one so the prefix sum yields start offsets)
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+    for (std::uint32_t cell : m_pendingCell) {
+        m_cellStart[cell + 1]++;
+    }
+    for (std::size_t cell = 0; cell < cellCount; ++cell) {
+        m_cellStart[cell + 1] += m_cellStart[cell];
+    }
+    
+    // Scatter entries into their cell ranges (stable: keeps insertion order within a cell)
+    m_entries.resize(m_pending.size());
+    std::vector<std::uint32_t>& cursor = m_pendingCell;
+    for (std::size_t i = 0; i < m_pending.size(); ++i) {
+        std::uint32_t cell = cursor[i];
+        cursor[i] = m_cellStart[cell]++;  // Reuse the cell buffer to hold each entry's slot
+    }
+    for (std::size_t i = 0; i < m_pending.size(); ++i) {
+        m_entries[cursor[i]] = m_pending[i];
+    }
+    
+    // Scattering advanced every start offset to the next cell's start - shift back by one
+    for (std::size_t cell = cellCount; cell > 0; --cell) {
+        m_cellStart[cell] = m_cellStart[cell - 1];
+    }
+    m_cellStart[0] = 0;
+}
+
+//----------------------------------------------------------------------------------------
+void SpatialGrid::build(const GameState& gameState) 
+{
+    begin();
+    
+    const ProjectilePool& projectiles = gameState.getProjectiles();
+    for (std::size_t i = 0; i < projectiles.size(); ++i) {
+        if (projectiles.isActive(i)) {
+            insert(projectiles.getPosition(i), static_cast<std::uint32_t>(i), EntityType::Projectile,
+                   projectiles.getOwnerPlayerId(i));
+        }
+    }
+    
+    for (int playerId = 1; playerId <= 2; ++playerId) {
+        const Spacecraft& spacecraft = gameState.getSpacecraft(playerId);
+        if (spacecraft.isAlive()) {
+            insert(spacecraft.getPosition(), static_cast<std::uint32_t>(playerId), EntityType::Spacecraft, playerId);
+        }
+    }
+    
+    finish();
+}
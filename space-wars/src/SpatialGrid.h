@@ -0,0 +1,122 @@
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <SFML/System/Vector2.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GameState;
+
+// Uniform grid over the (wrapping) arena used as a collision broadphase
+// Entities are binned by cell with a counting sort, so each cell's entries are contiguous.
+// The grid is rebuilt from scratch every step; after the first few builds its buffers are
+// large enough and rebuilding no longer allocates. Queries wrap around the screen edges
+// the same way Spacecraft::wrapAroundScreen does.
+class SpatialGrid {
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 64.0f;
+    
+    enum class EntityType : std::uint8_t {
+        Projectile,
+        Spacecraft
+    };
+    
+    struct Entry {
+        float x;
+        float y;
+        std::uint32_t index;  // ProjectilePool index, or player ID for spacecraft
+        EntityType type;
+        std::uint8_t ownerPlayerId;  // Firing player for projectiles, player ID for spacecraft
+    };
+    
+    SpatialGrid(float width, float height, float cellSize = DEFAULT_CELL_SIZE);
+    
+    // Bin all active projectiles and living spacecraft of a game state
+    void build(const GameState& gameState);
+    
+    // Incremental build for arbitrary entities: begin(), insert()..., finish()
+    void begin();
+    void insert(sf::Vector2f position, std::uint32_t index, EntityType type, int ownerPlayerId);
+    void finish();
+    
+    // Call f(const Entry&) for every entry in the cells overlapped by the circle (broadphase:
+    // may include entries farther than radius). Radius must be less than half the arena.
+    template <typename Callback>
+    void forEachCandidate(sf::Vector2f center, float radius, Callback&& f) const;
+    
+    // Call f(const Entry&, distanceSquared) for every entry whose wrapped distance from center
+    // is less than radius
+    template <typename Callback>
+    void forEachWithin(sf::Vector2f center, float radius, Callback&& f) const;
+    
+    // Shortest offset from one point to another on the wrapping arena
+    sf::Vector2f wrappedDelta(sf::Vector2f from, sf::Vector2f to) const;
+    
+    std::size_t size() const { return m_entries.size(); }
+    int getColumns() const { return m_columns; }
+    int getRows() const { return m_rows; }
+    
+private:
+    int cellIndex(float x, float y) const;
+    static int wrapIndex(int index, int count);
+    
+    float m_width;
+    float m_height;
+    float m_cellSize;
+    float m_inverseCellSize;
+    int m_columns;
+    int m_rows;
+    
+    std::vector<Entry> m_pending;          // Entries in insertion order (before finish)
+    std::vector<std::uint32_t> m_pendingCell;  // Cell of each pending entry
+    std::vector<Entry> m_entries;          // Entries sorted by cell
+    std::vector<std::uint32_t> m_cellStart;    // m_entries range of cell c is [start[c], start[c + 1])
+};
+
+//----------------------------------------------------------------------------------------
+template <typename Callback>
+void SpatialGrid::forEachCandidate(sf::Vector2f center, float radius, Callback&& f) const 
+{
+    int minColumn = static_cast<int>(std::floor((center.x - radius) * m_inverseCellSize));
+    int maxColumn = static_cast<int>(std::floor((center.x + radius) * m_inverseCellSize));
+    int minRow = static_cast<int>(std::floor((center.y - radius) * m_inverseCellSize));
+    int maxRow = static_cast<int>(std::floor((center.y + radius) * m_inverseCellSize));
+    
+    // Never visit a cell twice when the query covers the whole arena
+    if (maxColumn - minColumn >= m_columns) {
+        minColumn = 0;
+        maxColumn = m_columns - 1;
+    }
+    if (maxRow - minRow >= m_rows) {
+        minRow = 0;
+        maxRow = m_rows - 1;
+    }
+    
+    for (int row = minRow; row <= maxRow; ++row) {
+        int rowOffset = wrapIndex(row, m_rows) * m_columns;
+        for (int column = minColumn; column <= maxColumn; ++column) {
+            int cell = rowOffset + wrapIndex(column, m_columns);
+            for (std::uint32_t i = m_cellStart[cell]; i < m_cellStart[cell + 1]; ++i) {
+                f(m_entries[i]);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+template <typename Callback>
+void SpatialGrid::forEachWithin(sf::Vector2f center, float radius, Callback&& f) const 
+{
+    float radiusSquared = radius * radius;
+    forEachCandidate(center, radius, [&](const Entry& entry) {
+        sf::Vector2f delta = wrappedDelta(center, sf::Vector2f(entry.x, entry.y));
+        float distanceSquared = delta.x * delta.x + delta.y * delta.y;
+        if (distanceSquared < radiusSquared) {
+            f(entry, distanceSquared);
+        }
+    });
+}
+
+#endif // SPATIALGRID_H
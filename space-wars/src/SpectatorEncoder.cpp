@@ -0,0 +1,112 @@
+#include "SpectatorEncoder.h"
+#include "GameEvent.h"
+#include "WireFormat.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// A delta names its keyframe by distance, which the wire format limits like any baseline
+static_assert(SpectatorEncoder::KEYFRAME_INTERVAL < static_cast<int>(SnapshotHistory::SIZE),
+              "Deltas must be able to refer back to their keyframe");
+
+//----------------------------------------------------------------------------------------
+SpectatorEncoder::SpectatorEncoder(SpectatorSink& sink)
+    : m_sink(sink)
+    , m_session(WireFormat::newSession())
+    , m_sequence(0)
+    , m_tick(0)
+    , m_ticksUntilSend(0)
+    , m_snapshotsUntilKeyframe(0)
+{
+}
+
+//----------------------------------------------------------------------------------------
+void SpectatorEncoder::setProjectileCapacity(std::size_t capacity) 
+{
+    m_published.reserve(capacity);
+    m_currentIds.reserve(capacity);
+}
+
+//----------------------------------------------------------------------------------------
+void SpectatorEncoder::publish(const GameState& gameState, std::uint32_t tick) 
+{
+    if (--m_ticksUntilSend > 0) {
+        return;
+    }
+    m_ticksUntilSend = SEND_INTERVAL;
+    m_tick = tick;
+    
+    bool keyframe = --m_snapshotsUntilKeyframe <= 0;
+    m_snapshot.capture(gameState);
+    m_snapshot.sequence = ++m_sequence;
+    if (keyframe) {
+        m_snapshotsUntilKeyframe = KEYFRAME_INTERVAL;
+        WireFormat::encodeSnapshotDelta(nullptr, m_snapshot, m_session, 0, m_tick, m_buffer);
+        m_keyframe = m_snapshot;
+    } else {
+        WireFormat::encodeSnapshotDelta(&m_keyframe, m_snapshot, m_session, 0, m_tick, m_buffer);
+    }
+    send();
+    
+    publishProjectiles(gameState, keyframe);
+}
+
+//----------------------------------------------------------------------------------------
+void SpectatorEncoder::publishProjectiles(const GameState& gameState, bool keyframe) 
+{
+    const ProjectilePool& projectiles = gameState.getProjectiles();
+    m_currentIds.assign(projectiles.ids(), projectiles.ids() + projectiles.size());
+    std::sort(m_currentIds.begin(), m_currentIds.end());
+    
+    // Both lists are sorted, so one pass finds the projectiles fired and the ones gone (spent
+    // or off screen) since the last snapshot. A keyframe repeats every projectile for viewers
+    // that just joined; the others already have them and ignore the repeats.
+    auto published = m_published.begin();
+    for (std::uint32_t id : m_currentIds) {
+        while (published != m_published.end() && *published < id) {
+            sendProjectileEvent(projectiles, *published++, false);
+        }
+        bool isNew = published == m_published.end() || *published != id;
+        if (!isNew) {
+            ++published;
+        }
+        if (isNew || keyframe) {
+            sendProjectileEvent(projectiles, id, true);
+        }
+    }
+    while (published != m_published.end()) {
+        sendProjectileEvent(projectiles, *published++, false);
+    }
+    m_published.swap(m_currentIds);
+}
+
+//----------------------------------------------------------------------------------------
+void SpectatorEncoder::sendProjectileEvent(const ProjectilePool& projectiles, std::uint32_t id, bool spawn) 
+{
+    GameEvent event;
+    event.shooterId = static_cast<std::uint8_t>(Entity::ownerPlayerId(id));
+    event.projectileId = id;
+    if (spawn) {
+        // Fired from where it is now: it flies straight at constant speed, so this places it
+        // exactly on the viewer's side at the snapshot's time
+        std::size_t index = projectiles.find(id);
+        sf::Vector2f velocity = projectiles.getVelocity(index);
+        event.type = GameEvent::Type::ProjectileSpawn;
+        event.timeMs = m_snapshot.timeMs;
+        event.position = projectiles.getPosition(index);
+        event.orientation = static_cast<float>(std::atan2(velocity.y, velocity.x) * 180.0 / M_PI);
+    } else {
+        event.type = GameEvent::Type::ProjectileDespawn;
+    }
+    WireFormat::encodeGameEvent(event, m_tick, m_buffer);
+    send();
+}
+
+//----------------------------------------------------------------------------------------
+void SpectatorEncoder::send() 
+{
+    m_sink.sendSpectatorMessage(m_buffer.data(), m_buffer.size());
+}
@@ -0,0 +1,69 @@
+#ifndef SPECTATORENCODER_H
+#define SPECTATORENCODER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GameState.h"
+#include "Snapshot.h"
+
+// Where the messages of a spectator stream go, one call per encoded message
+class SpectatorSink {
+public:
+    virtual ~SpectatorSink() = default;
+    virtual void sendSpectatorMessage(const std::uint8_t* data, std::size_t size) = 0;
+};
+
+// Encodes a match as a spectator stream, without any I/O of its own
+// Every SEND_INTERVAL ticks the state goes out as a SnapshotDelta: a full keyframe every
+// KEYFRAME_INTERVAL snapshots, otherwise a delta against the last keyframe (so any delta
+// decodes on its own once a viewer has that keyframe). Projectiles follow as ProjectileSpawn
+// and ProjectileDespawn events, found by comparing the pool with what was published before;
+// each keyframe is followed by spawns of every live projectile. Each message is encoded once
+// and handed to the sink: a player's PUB socket (SpectatorPublisher) or a hosted match's
+// outbox, which the server publishes for all its matches (HostedMatch).
+class SpectatorEncoder {
+public:
+    explicit SpectatorEncoder(SpectatorSink& sink);
+    
+    // Published ID lists hold this many projectiles (allocates - call during setup only)
+    void setProjectileCapacity(std::size_t capacity);
+    
+    // Call once per simulation tick, after the step; messages are stamped with tick
+    void publish(const GameState& gameState, std::uint32_t tick);
+    
+    static constexpr int SEND_INTERVAL = 2;       // Ticks between snapshots (30 per second at 60 ticks)
+    static constexpr int KEYFRAME_INTERVAL = 30;  // Snapshots between keyframes (a second at 60 ticks)
+
+private:
+    void publishProjectiles(const GameState& gameState, bool keyframe);
+    void sendProjectileEvent(const ProjectilePool& projectiles, std::uint32_t id, bool spawn);
+    void send();
+    
+    SpectatorSink& m_sink;
+    Snapshot m_keyframe;  // Baseline of the deltas
+    Snapshot m_snapshot;  // Being published (reused)
+    std::uint32_t m_session;
+    std::uint32_t m_sequence;
+    std::uint32_t m_tick;  // Being published
+    int m_ticksUntilSend;
+    int m_snapshotsUntilKeyframe;
+    std::vector<std::uint32_t> m_published;   // Projectile IDs in the stream, sorted
+    std::vector<std::uint32_t> m_currentIds;  // Projectile IDs now, sorted (reused)
+    std::vector<std::uint8_t> m_buffer;
+};
+
+// A server publishes all its matches on one PUB socket, each message preceded by a frame
+// naming the match: its index, big-endian and of fixed width, so no match's topic is a
+// prefix of another's and a viewer subscribes to exactly one match
+using SpectatorTopic = std::array<std::uint8_t, 4>;
+
+inline SpectatorTopic spectatorTopic(std::size_t matchIndex) 
+{
+    std::uint32_t index = static_cast<std::uint32_t>(matchIndex);
+    return {static_cast<std::uint8_t>(index >> 24), static_cast<std::uint8_t>(index >> 16),
+            static_cast<std::uint8_t>(index >> 8), static_cast<std::uint8_t>(index)};
+}
+
+#endif // SPECTATORENCODER_H
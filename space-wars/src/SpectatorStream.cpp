@@ -0,0 +1,150 @@
+#include "SpectatorStream.h"
+#include "WireFormat.h"
+#include <iostream>
+#include <string_view>
+
+//----------------------------------------------------------------------------------------
+SpectatorPublisher::SpectatorPublisher()
+    : m_encoder(*this)
+{
+    try {
+        m_context = std::make_unique<zmq::context_t>(1);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create ZeroMQ context: " << e.what() << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+SpectatorPublisher::~SpectatorPublisher() 
+{
+    // Close the socket before the context
+    m_socket.reset();
+}
+
+//----------------------------------------------------------------------------------------
+bool SpectatorPublisher::open(int port) 
+{
+    if (!m_context) {
+        return false;
+    }
+    
+    try {
+        m_socket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PUB);
+        m_socket->set(zmq::sockopt::linger, 0);
+        m_socket->set(zmq::sockopt::sndhwm, HIGH_WATER_MARK);
+        m_socket->bind("tcp://*:" + std::to_string(port));
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to open spectator stream on port " << port << ": " << e.what() << std::endl;
+        m_socket.reset();
+        return false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void SpectatorPublisher::publish(const GameState& gameState, std::uint32_t tick) 
+{
+    if (m_socket) {
+        m_encoder.publish(gameState, tick);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void SpectatorPublisher::sendSpectatorMessage(const std::uint8_t* data, std::size_t size) 
+{
+    // Never blocks: a PUB socket drops the message for any viewer whose queue is full
+    m_socket->send(zmq::buffer(data, size), zmq::send_flags::dontwait);
+}
+
+//----------------------------------------------------------------------------------------
+SpectatorFeed::SpectatorFeed()
+    : m_topicFrames(false)
+    , m_keyframeSession(0)
+{
+    try {
+        m_context = std::make_unique<zmq::context_t>(1);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create ZeroMQ context: " << e.what() << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+SpectatorFeed::~SpectatorFeed() 
+{
+    // Close the socket before the context
+    m_socket.reset();
+}
+
+//----------------------------------------------------------------------------------------
+bool SpectatorFeed::open(const std::string& ip, int port, int match) 
+{
+    if (!m_context) {
+        return false;
+    }
+    
+    try {
+        m_socket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_SUB);
+        m_socket->set(zmq::sockopt::linger, 0);
+        m_topicFrames = match >= 0;
+        if (m_topicFrames) {
+            SpectatorTopic topic = spectatorTopic(static_cast<std::size_t>(match));
+            m_socket->set(zmq::sockopt::subscribe, std::string_view(reinterpret_cast<const char*>(topic.data()), topic.size()));
+        } else {
+            m_socket->set(zmq::sockopt::subscribe, "");
+        }
+        m_socket->connect("tcp://" + ip + ":" + std::to_string(port));
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to subscribe to the spectator stream: " << e.what() << std::endl;
+        m_socket.reset();
+        return false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+SpectatorFeed::Item SpectatorFeed::poll() 
+{
+    if (!m_socket) {
+        return Item::None;
+    }
+    
+    while (m_socket->recv(m_message, zmq::recv_flags::dontwait).has_value()) {
+        // The topic frame of a server's stream comes first; the message follows with it
+        if (m_topicFrames && (!m_message.more() || !m_socket->recv(m_message, zmq::recv_flags::dontwait).has_value())) {
+            continue;
+        }
+        const std::uint8_t* data = static_cast<const std::uint8_t*>(m_message.data());
+        WireFormat::MessageType type;
+        if (!WireFormat::peekMessageType(data, m_message.size(), type)) {
+            continue;
+        }
+        
+        if (type == WireFormat::MessageType::SnapshotDelta) {
+            BitReader reader(data, m_message.size());
+            WireFormat::SnapshotHeader header;
+            if (!WireFormat::decodeSnapshotHeader(reader, header)) {
+                continue;
+            }
+            if (header.baseline == 0) {
+                m_snapshot.sequence = header.sequence;
+                if (WireFormat::decodeSnapshotDelta(reader, nullptr, m_snapshot)) {
+                    m_keyframe = m_snapshot;
+                    m_keyframeSession = header.session;
+                    return Item::Keyframe;
+                }
+            } else if (isSynced() && header.session == m_keyframeSession && header.baseline == m_keyframe.sequence) {
+                m_snapshot.sequence = header.sequence;
+                if (WireFormat::decodeSnapshotDelta(reader, &m_keyframe, m_snapshot)) {
+                    return Item::Delta;
+                }
+            }
+        } else if (type == WireFormat::MessageType::GameEvent && isSynced()) {
+            if (WireFormat::decodeGameEvent(data, m_message.size(), m_event)
+                && (m_event.type == GameEvent::Type::ProjectileSpawn
+                    || m_event.type == GameEvent::Type::ProjectileDespawn)) {
+                return Item::Event;
+            }
+        }
+    }
+    return Item::None;
+}
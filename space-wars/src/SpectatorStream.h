@@ -0,0 +1,86 @@
+#ifndef SPECTATORSTREAM_H
+#define SPECTATORSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <zmq.hpp>
+#include "GameEvent.h"
+#include "GameState.h"
+#include "Snapshot.h"
+#include "SpectatorEncoder.h"
+
+// Spectator stream of a player's match, published on a ZeroMQ PUB socket (TCP)
+// The match is encoded by a SpectatorEncoder (see there for what the stream carries). Each
+// message is handed to ZeroMQ, which copies it to every subscriber on its own I/O thread, so
+// the cost on the match does not grow with the number of viewers. A viewer that falls behind
+// by more than HIGH_WATER_MARK messages has the excess dropped and catches up at the next
+// keyframe.
+class SpectatorPublisher : private SpectatorSink {
+public:
+    SpectatorPublisher();
+    ~SpectatorPublisher();
+    
+    // Published ID lists hold this many projectiles (allocates - call during setup only)
+    void setProjectileCapacity(std::size_t capacity) { m_encoder.setProjectileCapacity(capacity); }
+    
+    // Bind the PUB socket on all interfaces; false (after reporting why) on failure
+    bool open(int port);
+    bool isOpen() const { return m_socket != nullptr; }
+    
+    // Call once per simulation tick, after the step; messages are stamped with tick
+    void publish(const GameState& gameState, std::uint32_t tick);
+    
+    static constexpr int HIGH_WATER_MARK = 1000;  // Messages queued per viewer
+
+private:
+    void sendSpectatorMessage(const std::uint8_t* data, std::size_t size) override;
+    
+    std::unique_ptr<zmq::context_t> m_context;
+    std::unique_ptr<zmq::socket_t> m_socket;
+    SpectatorEncoder m_encoder;
+};
+
+// Viewer's end of a spectator stream (ZeroMQ SUB socket)
+// Nothing is passed on until the first keyframe arrives; from then on poll() returns the
+// snapshots and projectile events in the order they were published. A delta whose keyframe
+// was missed, or that belongs to an earlier run of the publisher, is skipped until the next
+// keyframe. All calls are made from one thread.
+class SpectatorFeed {
+public:
+    enum class Item {
+        None,      // Nothing more received
+        Keyframe,  // getSnapshot() holds a full snapshot
+        Delta,     // getSnapshot() holds a snapshot decoded against the last keyframe
+        Event      // getEvent() holds a ProjectileSpawn or ProjectileDespawn
+    };
+    
+    SpectatorFeed();
+    ~SpectatorFeed();
+    
+    // Subscribe to the stream published at ip:port (connects in the background): a player's,
+    // or with match set (0 or more) that match's on a dedicated server (see spectatorTopic())
+    bool open(const std::string& ip, int port, int match = -1);
+    bool isOpen() const { return m_socket != nullptr; }
+    bool isSynced() const { return m_keyframe.sequence != 0; }  // A keyframe has arrived
+    
+    // Next received item, Item::None once everything received so far has been returned
+    Item poll();
+    
+    const Snapshot& getSnapshot() const { return m_snapshot; }
+    const GameEvent& getEvent() const { return m_event; }
+
+private:
+    std::unique_ptr<zmq::context_t> m_context;
+    std::unique_ptr<zmq::socket_t> m_socket;
+    zmq::message_t m_message;  // Reused
+    bool m_topicFrames;        // Each message is preceded by its match's topic (server stream)
+    std::uint32_t m_keyframeSession;
+    Snapshot m_keyframe;
+    Snapshot m_snapshot;
+    GameEvent m_event;
+};
+
+#endif // SPECTATORSTREAM_H
@@ -0,0 +1,81 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Lock-free single-producer/single-consumer ring buffer
+// Elements live in a fixed array and are filled and read in place, so elements that own
+// storage (projectile pools, snapshot vectors) keep it from one use to the next and passing
+// them between threads never allocates. Exactly one thread may call the producer functions
+// and exactly one other thread the consumer functions.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer: slot to fill, or nullptr if the queue is full; publish() makes it visible
+    T* prepare()
+    {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= Capacity) {
+            return nullptr;
+        }
+        return &m_slots[tail & (Capacity - 1)];
+    }
+    
+    void publish()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    // Producer: copy value in, returns false if the queue is full
+    bool push(const T& value)
+    {
+        T* slot = prepare();
+        if (!slot) {
+            return false;
+        }
+        *slot = value;
+        publish();
+        return true;
+    }
+    
+    // Producer: number of elements the consumer has not taken yet
+    std::size_t queued() const
+    {
+        return m_tail.load(std::memory_order_relaxed) - m_head.load(std::memory_order_acquire);
+    }
+    
+    // Consumer: oldest element, or nullptr if the queue is empty; pop() releases it
+    T* front()
+    {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &m_slots[head & (Capacity - 1)];
+    }
+    
+    void pop()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    // Consumer: number of elements ready to read
+    std::size_t available() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_relaxed);
+    }
+    
+    // Element storage, for setup before either thread uses the queue
+    std::array<T, Capacity>& slots() { return m_slots; }
+
+private:
+    std::array<T, Capacity> m_slots;
+    alignas(64) std::atomic<std::size_t> m_head{0};  // Next element to read (written by consumer)
+    alignas(64) std::atomic<std::size_t> m_tail{0};  // Next slot to fill (written by producer)
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,60 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Available transport backends (selected with "transport" in config.txt)
+enum class TransportType {
+    Udp,    // Datagrams: state never waits behind a lost packet
+    Zmq,    // ZeroMQ PUSH/PULL over TCP
+    Server  // Client of a dedicated server (ZeroMQ DEALER to its ROUTER)
+};
+
+// Moves encoded messages between two peers on three channels
+// The state channel is unreliable and latest-wins: messages may be lost, and older messages
+// arriving late are dropped. The event channel is reliable and ordered. The heartbeat channel
+// is unreliable but delivers every small message that arrives, so pings and pongs measure the
+// path as it is (never resent, never superseded). Message contents are opaque to the
+// transport. All calls are made from the network thread.
+class Transport {
+public:
+    virtual ~Transport() = default;
+    
+    // Bind localPort for receiving and address the peer; false (after reporting why) on failure
+    virtual bool open(const std::string& peerIp, int peerPort, int localPort) = 0;
+    virtual void close() = 0;
+    
+    // Read sockets, resend and acknowledge; false if the connection has failed
+    virtual bool update() = 0;
+    
+    // Block until something may have arrived, or timeout
+    virtual void wait(std::chrono::milliseconds timeout) = 0;
+    
+    // State channel
+    // sendState returns false if the message was not sent (superseded by the next one anyway).
+    // receiveLatestState points data at the newest state received since the last call and
+    // returns how many arrived (0 if none; all but the newest are skipped). data stays valid
+    // until the next call to update() or receiveLatestState().
+    virtual bool sendState(const std::uint8_t* data, std::size_t size) = 0;
+    virtual std::size_t receiveLatestState(const std::uint8_t*& data, std::size_t& size) = 0;
+    
+    // Event channel
+    // sendReliable returns false if the transport cannot take the message yet; retry it later
+    // (before any newer one) to keep the order. It throws std::length_error for a message too
+    // large to ever be sent, which is then lost. receiveReliable returns the next message in
+    // order, valid until the next transport call.
+    virtual bool sendReliable(const std::uint8_t* data, std::size_t size) = 0;
+    virtual bool receiveReliable(const std::uint8_t*& data, std::size_t& size) = 0;
+    
+    // Heartbeat channel
+    // sendHeartbeat returns false if the message was not sent. receiveHeartbeat returns the
+    // next message received (a few are buffered; more are dropped), valid until the next
+    // transport call.
+    virtual bool sendHeartbeat(const std::uint8_t* data, std::size_t size) = 0;
+    virtual bool receiveHeartbeat(const std::uint8_t*& data, std::size_t& size) = 0;
+};
+
+#endif // TRANSPORT_H
@@ -0,0 +1,499 @@
+#include "UdpTransport.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+//----------------------------------------------------------------------------------------
+void writeU32(std::vector<std::uint8_t>& buffer, std::uint32_t value) 
+{
+    for (int shift = 0; shift < 32; shift += 8) {
+        buffer.push_back(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t readU32(const std::uint8_t* data) 
+{
+    return static_cast<std::uint32_t>(data[0])
+        | (static_cast<std::uint32_t>(data[1]) << 8)
+        | (static_cast<std::uint32_t>(data[2]) << 16)
+        | (static_cast<std::uint32_t>(data[3]) << 24);
+}
+
+//----------------------------------------------------------------------------------------
+// True if sequence a comes after b (sequence numbers wrap around)
+bool isNewer(std::uint32_t a, std::uint32_t b) 
+{
+    return static_cast<std::int32_t>(a - b) > 0;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+UdpTransport::UdpTransport()
+    : m_socket(-1)
+    , m_peerAddress{}
+    , m_session(0)
+    , m_peerSession(0)
+    , m_peerKnowsSession(false)
+    , m_stateSequence(0)
+    , m_peerStateSequence(0)
+    , m_statesReceived(0)
+    , m_nextReliableSequence(1)
+    , m_oldestUnacked(1)
+    , m_nextDelivery(1)
+    , m_receivedThrough(0)
+    , m_ackPending(false)
+    , m_heartbeatHead(0)
+    , m_heartbeatCount(0)
+{
+    m_packet.resize(MAX_DATAGRAM_SIZE);
+}
+
+//----------------------------------------------------------------------------------------
+UdpTransport::~UdpTransport() 
+{
+    close();
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::open(const std::string& peerIp, int peerPort, int localPort) 
+{
+    close();
+    
+    // Resolve the peer (accepts host names as well as dotted addresses)
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* resolved = nullptr;
+    int error = ::getaddrinfo(peerIp.c_str(), nullptr, &hints, &resolved);
+    if (error != 0 || !resolved) {
+        std::cerr << "Failed to resolve " << peerIp << ": " << ::gai_strerror(error) << std::endl;
+        return false;
+    }
+    m_peerAddress = *reinterpret_cast<const sockaddr_in*>(resolved->ai_addr);
+    m_peerAddress.sin_port = htons(static_cast<std::uint16_t>(peerPort));
+    ::freeaddrinfo(resolved);
+    
+    // Non-blocking socket bound on all interfaces, like the ZeroMQ tcp://*:port binding
+    m_socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_socket < 0) {
+        std::cerr << "Failed to create UDP socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    int flags = ::fcntl(m_socket, F_GETFL, 0);
+    if (flags < 0 || ::fcntl(m_socket, F_SETFL, flags | O_NONBLOCK) < 0) {
+        std::cerr << "Failed to make UDP socket non-blocking: " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    
+    sockaddr_in localAddress{};
+    localAddress.sin_family = AF_INET;
+    localAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+    localAddress.sin_port = htons(static_cast<std::uint16_t>(localPort));
+    if (::bind(m_socket, reinterpret_cast<const sockaddr*>(&localAddress), sizeof(localAddress)) < 0) {
+        std::cerr << "Failed to bind UDP port " << localPort << ": " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    
+    // Fresh session: the peer restarts its view of our sequence numbers
+    std::random_device random;
+    do {
+        m_session = random();
+    } while (m_session == 0);
+    
+    // The peer may still be running its previous session: nothing is stale yet
+    m_retiredSessions.fill(0);
+    m_stateSequence = 0;
+    restartReliableStream();
+    resetPeer(0);
+    sendHello(true);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::close() 
+{
+    if (m_socket >= 0) {
+        ::close(m_socket);
+        m_socket = -1;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::resetPeer(std::uint32_t session) 
+{
+    m_peerSession = session;
+    m_peerKnowsSession = false;
+    m_peerStateSequence = 0;
+    m_statesReceived = 0;
+    m_nextDelivery = 1;
+    m_receivedThrough = 0;
+    m_ackPending = false;
+    m_heartbeatCount = 0;
+    for (ReceivedMessage& received : m_received) {
+        received.present = false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::restartReliableStream() 
+{
+    m_nextReliableSequence = 1;
+    m_oldestUnacked = 1;
+    for (PendingMessage& pending : m_pending) {
+        pending.acked = true;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::writeHeader(std::vector<std::uint8_t>& packet, PacketType type, std::uint32_t session,
+                               std::uint32_t sequence) 
+{
+    packet.clear();
+    packet.push_back(static_cast<std::uint8_t>(type));
+    writeU32(packet, session);
+    writeU32(packet, sequence);
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::sendPacket(const std::vector<std::uint8_t>& packet) 
+{
+    // Send failures (full socket buffer, ICMP unreachable while the peer starts) are not
+    // fatal: state is resent every tick and reliable messages until they are acknowledged
+    ssize_t sent = ::sendto(m_socket, packet.data(), packet.size(), 0,
+                            reinterpret_cast<const sockaddr*>(&m_peerAddress), sizeof(m_peerAddress));
+    return sent == static_cast<ssize_t>(packet.size());
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::update() 
+{
+    if (m_socket < 0) {
+        return false;
+    }
+    
+    // Drain every datagram that has arrived
+    while (true) {
+        sockaddr_in from{};
+        socklen_t fromLength = sizeof(from);
+        ssize_t received = ::recvfrom(m_socket, m_packet.data(), m_packet.size(), 0,
+                                      reinterpret_cast<sockaddr*>(&from), &fromLength);
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            if (errno == EINTR || errno == ECONNREFUSED) {
+                continue;  // Peer not up yet (reported by ICMP) - keep going
+            }
+            std::cerr << "Failed to receive on UDP socket: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        
+        // Only the configured peer is listened to
+        if (from.sin_addr.s_addr != m_peerAddress.sin_addr.s_addr || from.sin_port != m_peerAddress.sin_port) {
+            continue;
+        }
+        handlePacket(m_packet.data(), static_cast<std::size_t>(received));
+    }
+    
+    if (m_ackPending) {
+        sendAck();
+    }
+    if (!m_peerKnowsSession && Clock::now() - m_lastHello >= RESEND_INTERVAL) {
+        sendHello(true);
+    }
+    return resendPending();
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::handlePacket(const std::uint8_t* data, std::size_t size) 
+{
+    if (size < HEADER_SIZE) {
+        return;
+    }
+    PacketType type = static_cast<PacketType>(data[0]);
+    std::uint32_t session = readU32(data + 1);
+    std::uint32_t sequence = readU32(data + 5);
+    const std::uint8_t* payload = data + HEADER_SIZE;
+    std::size_t payloadSize = size - HEADER_SIZE;
+    
+    if (type == PacketType::Ack) {
+        // Acks name the session of the stream they acknowledge (ours) and their sender's, so
+        // one from the peer's previous run never acknowledges our restarted stream
+        if (session == m_session && payloadSize >= 4 + SESSION_SIZE && readU32(payload + 4) == m_peerSession) {
+            m_peerKnowsSession = true;
+            handleAck(sequence, readU32(payload));
+        }
+        return;
+    }
+    if (type == PacketType::Hello) {
+        handleHello(session, payload, payloadSize);
+        return;
+    }
+    
+    // Only the session the handshake established is listened to: a datagram from any other
+    // (a previous run of the peer, or a new one whose Hello has not arrived yet) is dropped
+    if (session != m_peerSession || session == 0) {
+        return;
+    }
+    
+    if (type == PacketType::State) {
+        // Latest wins: anything not newer than what we have is dropped
+        if (isNewer(sequence, m_peerStateSequence)) {
+            m_peerStateSequence = sequence;
+            m_latestState.assign(payload, payload + payloadSize);
+            m_statesReceived++;
+        }
+    } else if (type == PacketType::Heartbeat) {
+        // Dropped when the queue is full: the next heartbeat is never far behind
+        if (m_heartbeatCount < HEARTBEAT_QUEUE_SIZE) {
+            m_heartbeats[(m_heartbeatHead + m_heartbeatCount) % HEARTBEAT_QUEUE_SIZE].assign(payload, payload + payloadSize);
+            m_heartbeatCount++;
+        }
+    } else if (payloadSize >= SESSION_SIZE) {
+        // Addressed to an earlier run of ours: stale, and its sequence means nothing now
+        std::uint32_t receiver = readU32(payload);
+        if (receiver == m_session) {
+            m_peerKnowsSession = true;
+        }
+        if (receiver == 0 || receiver == m_session) {
+            handleReliable(sequence, payload + SESSION_SIZE, payloadSize - SESSION_SIZE);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::handleHello(std::uint32_t session, const std::uint8_t* payload, std::size_t size) 
+{
+    if (size < HELLO_SIZE || session == 0 || isRetiredSession(session)) {
+        return;
+    }
+    
+    if (session != m_peerSession) {
+        // Peer (re)started. Its first contact leaves our reliable stream alone, but a restart
+        // means it no longer has any of it, so it starts over too. The session it replaces is
+        // never adopted again, whatever arrives late from it.
+        if (m_peerSession != 0) {
+            restartReliableStream();
+            std::copy_backward(m_retiredSessions.begin(), m_retiredSessions.end() - 1, m_retiredSessions.end());
+            m_retiredSessions[0] = m_peerSession;
+        }
+        resetPeer(session);
+    }
+    
+    if (readU32(payload) == m_session) {
+        m_peerKnowsSession = true;
+    }
+    if (payload[SESSION_SIZE] != 0) {
+        sendHello(!m_peerKnowsSession);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::sendHello(bool replyWanted) 
+{
+    writeHeader(m_sendPacket, PacketType::Hello, m_session, 0);
+    writeU32(m_sendPacket, m_peerSession);
+    m_sendPacket.push_back(replyWanted ? 1 : 0);
+    sendPacket(m_sendPacket);
+    m_lastHello = Clock::now();
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::isRetiredSession(std::uint32_t session) const 
+{
+    return std::find(m_retiredSessions.begin(), m_retiredSessions.end(), session) != m_retiredSessions.end();
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::handleReliable(std::uint32_t sequence, const std::uint8_t* payload, std::size_t size) 
+{
+    // Acknowledge even duplicates: our previous ack may have been lost
+    m_ackPending = true;
+    
+    if (!isNewer(sequence, m_receivedThrough) || sequence - m_nextDelivery >= WINDOW_SIZE) {
+        return;  // Already have it, or no room until earlier messages are delivered
+    }
+    ReceivedMessage& slot = m_received[sequence % WINDOW_SIZE];
+    if (slot.present && slot.sequence == sequence) {
+        return;
+    }
+    slot.sequence = sequence;
+    slot.payload.assign(payload, payload + size);
+    slot.present = true;
+    
+    // Extend the contiguous run
+    while (true) {
+        const ReceivedMessage& next = m_received[(m_receivedThrough + 1) % WINDOW_SIZE];
+        if (!next.present || next.sequence != m_receivedThrough + 1) {
+            break;
+        }
+        m_receivedThrough++;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::sendAck() 
+{
+    // Cumulative ack, plus bit i set if sequence m_receivedThrough + 2 + i has also arrived
+    std::uint32_t mask = 0;
+    for (std::uint32_t bit = 0; bit < 32; ++bit) {
+        std::uint32_t sequence = m_receivedThrough + 2 + bit;
+        const ReceivedMessage& slot = m_received[sequence % WINDOW_SIZE];
+        if (sequence - m_nextDelivery < WINDOW_SIZE && slot.present && slot.sequence == sequence) {
+            mask |= 1u << bit;
+        }
+    }
+    
+    writeHeader(m_sendPacket, PacketType::Ack, m_peerSession, m_receivedThrough);
+    writeU32(m_sendPacket, mask);
+    writeU32(m_sendPacket, m_session);
+    sendPacket(m_sendPacket);
+    m_ackPending = false;
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::handleAck(std::uint32_t sequence, std::uint32_t mask) 
+{
+    for (std::uint32_t pending = m_oldestUnacked; pending != m_nextReliableSequence; ++pending) {
+        std::uint32_t distance = pending - sequence;
+        bool acked = !isNewer(pending, sequence)
+            || (distance >= 2 && distance - 2 < 32 && (mask & (1u << (distance - 2))) != 0);
+        if (acked) {
+            m_pending[pending % WINDOW_SIZE].acked = true;
+        }
+    }
+    
+    while (m_oldestUnacked != m_nextReliableSequence && m_pending[m_oldestUnacked % WINDOW_SIZE].acked) {
+        m_oldestUnacked++;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::resendPending() 
+{
+    Clock::time_point now = Clock::now();
+    for (std::uint32_t sequence = m_oldestUnacked; sequence != m_nextReliableSequence; ++sequence) {
+        PendingMessage& pending = m_pending[sequence % WINDOW_SIZE];
+        if (pending.acked || now - pending.lastSent < RESEND_INTERVAL) {
+            continue;
+        }
+        if (pending.sendCount >= MAX_SENDS) {
+            std::cerr << "Reliable message not acknowledged after " << MAX_SENDS << " attempts" << std::endl;
+            return false;
+        }
+        sendPacket(pending.packet);
+        pending.lastSent = now;
+        pending.sendCount++;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+void UdpTransport::wait(std::chrono::milliseconds timeout) 
+{
+    pollfd descriptor{};
+    descriptor.fd = m_socket;
+    descriptor.events = POLLIN;
+    ::poll(&descriptor, 1, static_cast<int>(timeout.count()));
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::sendState(const std::uint8_t* data, std::size_t size) 
+{
+    if (m_socket < 0 || HEADER_SIZE + size > MAX_DATAGRAM_SIZE) {
+        return false;
+    }
+    writeHeader(m_sendPacket, PacketType::State, m_session, ++m_stateSequence);
+    m_sendPacket.insert(m_sendPacket.end(), data, data + size);
+    return sendPacket(m_sendPacket);
+}
+
+//----------------------------------------------------------------------------------------
+std::size_t UdpTransport::receiveLatestState(const std::uint8_t*& data, std::size_t& size) 
+{
+    std::size_t received = m_statesReceived;
+    if (received > 0) {
+        data = m_latestState.data();
+        size = m_latestState.size();
+        m_statesReceived = 0;
+    }
+    return received;
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::sendReliable(const std::uint8_t* data, std::size_t size) 
+{
+    if (HEADER_SIZE + SESSION_SIZE + size > MAX_DATAGRAM_SIZE) {
+        // Retrying would never help, and would hold up every later message
+        throw std::length_error("reliable message of " + std::to_string(size) + " bytes does not fit a datagram");
+    }
+    if (m_socket < 0 || m_nextReliableSequence - m_oldestUnacked >= WINDOW_SIZE) {
+        return false;  // Window full - wait for acks
+    }
+    
+    std::uint32_t sequence = m_nextReliableSequence++;
+    PendingMessage& pending = m_pending[sequence % WINDOW_SIZE];
+    writeHeader(pending.packet, PacketType::Reliable, m_session, sequence);
+    writeU32(pending.packet, m_peerSession);
+    pending.packet.insert(pending.packet.end(), data, data + size);
+    pending.acked = false;
+    pending.sendCount = 1;
+    pending.lastSent = Clock::now();
+    sendPacket(pending.packet);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::receiveReliable(const std::uint8_t*& data, std::size_t& size) 
+{
+    if (isNewer(m_nextDelivery, m_receivedThrough)) {
+        return false;  // Next message in order has not arrived yet
+    }
+    ReceivedMessage& slot = m_received[m_nextDelivery % WINDOW_SIZE];
+    data = slot.payload.data();
+    size = slot.payload.size();
+    slot.present = false;
+    m_nextDelivery++;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::sendHeartbeat(const std::uint8_t* data, std::size_t size) 
+{
+    if (m_socket < 0 || HEADER_SIZE + size > MAX_DATAGRAM_SIZE) {
+        return false;
+    }
+    writeHeader(m_sendPacket, PacketType::Heartbeat, m_session, 0);
+    m_sendPacket.insert(m_sendPacket.end(), data, data + size);
+    return sendPacket(m_sendPacket);
+}
+
+//----------------------------------------------------------------------------------------
+bool UdpTransport::receiveHeartbeat(const std::uint8_t*& data, std::size_t& size) 
+{
+    if (m_heartbeatCount == 0) {
+        return false;
+    }
+    const std::vector<std::uint8_t>& heartbeat = m_heartbeats[m_heartbeatHead];
+    data = heartbeat.data();
+    size = heartbeat.size();
+    m_heartbeatHead = (m_heartbeatHead + 1) % HEARTBEAT_QUEUE_SIZE;
+    m_heartbeatCount--;
+    return true;
+}
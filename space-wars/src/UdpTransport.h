@@ -0,0 +1,133 @@
+#ifndef UDPTRANSPORT_H
+#define UDPTRANSPORT_H
+
+#include "Transport.h"
+#include <array>
+#include <vector>
+#include <netinet/in.h>
+
+// Transport over a single UDP socket bound to localPort
+// State messages are sent as plain sequenced datagrams: a lost one is simply replaced by the
+// next, and one arriving after a newer one is dropped, so a loss never delays later states.
+// Event messages go through a small reliable channel on the same socket: each datagram
+// carries a sequence number, the receiver acknowledges what it has (cumulative ack plus a
+// bitmask of the following sequences), the sender resends whatever stays unacknowledged, and
+// the receiver delivers in sequence order. Heartbeats are plain datagrams, queued on arrival.
+//
+// Every datagram starts with a header naming its type and the sender's session, a random
+// number chosen on each open(). Sessions are introduced by a handshake: each side sends a
+// Hello naming its session and the peer session it knows until the peer shows it knows ours.
+// Only a Hello can change the peer session; everything else from another session, such as a
+// late or reordered datagram of the peer's previous run, is ignored, and so is a Hello from
+// a session it already replaced. A new session means the peer restarted, so its sequence
+// numbers start over - and so do ours: our reliable stream begins again at 1, and messages
+// still unacknowledged are dropped, since the run of the peer they were meant for is gone.
+// Reliable messages and acks also name the session they are addressed to, so neither a late
+// message from our old stream nor a late ack from the peer's previous run is taken for part
+// of the new stream.
+class UdpTransport : public Transport {
+public:
+    UdpTransport();
+    ~UdpTransport() override;
+    
+    bool open(const std::string& peerIp, int peerPort, int localPort) override;
+    void close() override;
+    bool update() override;
+    void wait(std::chrono::milliseconds timeout) override;
+    
+    bool sendState(const std::uint8_t* data, std::size_t size) override;
+    std::size_t receiveLatestState(const std::uint8_t*& data, std::size_t& size) override;
+    bool sendReliable(const std::uint8_t* data, std::size_t size) override;
+    bool receiveReliable(const std::uint8_t*& data, std::size_t& size) override;
+    bool sendHeartbeat(const std::uint8_t* data, std::size_t size) override;
+    bool receiveHeartbeat(const std::uint8_t*& data, std::size_t& size) override;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    enum class PacketType : std::uint8_t {
+        State = 1,     // header, payload
+        Reliable = 2,  // header, receiver's session (0 if not known yet), payload
+        Ack = 3,       // header (session = the acknowledged stream's), 32-bit mask of the following ones, acking session
+        Heartbeat = 4,  // header (sequence unused), payload
+        Hello = 5       // header (sequence unused), receiver's session (0 if not known yet), reply wanted
+    };
+    
+    // Reliable message awaiting acknowledgement
+    struct PendingMessage {
+        std::vector<std::uint8_t> packet;  // Complete datagram, ready to resend
+        Clock::time_point lastSent;
+        int sendCount = 0;
+        bool acked = true;
+    };
+    
+    // Reliable message received but not yet delivered
+    struct ReceivedMessage {
+        std::uint32_t sequence = 0;
+        std::vector<std::uint8_t> payload;
+        bool present = false;
+    };
+    
+    bool sendPacket(const std::vector<std::uint8_t>& packet);
+    void writeHeader(std::vector<std::uint8_t>& packet, PacketType type, std::uint32_t session,
+                     std::uint32_t sequence);
+    void handlePacket(const std::uint8_t* data, std::size_t size);
+    void handleReliable(std::uint32_t sequence, const std::uint8_t* payload, std::size_t size);
+    void handleAck(std::uint32_t sequence, std::uint32_t mask);
+    bool resendPending();
+    void sendAck();
+    void resetPeer(std::uint32_t session);
+    void restartReliableStream();
+    void handleHello(std::uint32_t session, const std::uint8_t* payload, std::size_t size);
+    void sendHello(bool replyWanted);
+    bool isRetiredSession(std::uint32_t session) const;
+    
+    int m_socket;  // -1 when closed
+    sockaddr_in m_peerAddress;
+    std::uint32_t m_session;      // Ours
+    std::uint32_t m_peerSession;  // 0 until the peer's first Hello
+    bool m_peerKnowsSession;      // The peer has shown it knows ours (stops our Hellos)
+    Clock::time_point m_lastHello;
+    
+    // Peer sessions replaced by a newer one, most recent first: their datagrams are stale
+    static constexpr std::size_t RETIRED_SESSIONS = 4;
+    std::array<std::uint32_t, RETIRED_SESSIONS> m_retiredSessions{};
+    
+    // State channel
+    std::uint32_t m_stateSequence;        // Last state we sent
+    std::uint32_t m_peerStateSequence;    // Newest state received
+    std::size_t m_statesReceived;         // Since the last receiveLatestState()
+    std::vector<std::uint8_t> m_latestState;  // Newest state datagram
+    
+    // Reliable channel, both directions windowed by sequence number
+    static constexpr std::uint32_t WINDOW_SIZE = 64;
+    std::array<PendingMessage, WINDOW_SIZE> m_pending;
+    std::uint32_t m_nextReliableSequence;  // Sequence of the next message we send
+    std::uint32_t m_oldestUnacked;         // Oldest sequence we may still have to resend
+    std::array<ReceivedMessage, WINDOW_SIZE> m_received;
+    std::uint32_t m_nextDelivery;      // Next sequence to hand to receiveReliable()
+    std::uint32_t m_receivedThrough;   // Every sequence up to this one has arrived
+    bool m_ackPending;                 // Reliable packets arrived since our last ack
+    
+    // Heartbeat channel: received payloads waiting for receiveHeartbeat(), oldest first
+    static constexpr std::size_t HEARTBEAT_QUEUE_SIZE = 8;
+    std::array<std::vector<std::uint8_t>, HEARTBEAT_QUEUE_SIZE> m_heartbeats;
+    std::size_t m_heartbeatHead;
+    std::size_t m_heartbeatCount;
+    
+    // Scratch datagrams (reused, so steady-state traffic does not allocate)
+    std::vector<std::uint8_t> m_packet;
+    std::vector<std::uint8_t> m_sendPacket;
+    
+    // Resend an unacknowledged message (or our Hello) after RESEND_INTERVAL; give up on the
+    // connection after MAX_SENDS attempts (about 5 seconds)
+    static constexpr std::chrono::milliseconds RESEND_INTERVAL{100};
+    static constexpr int MAX_SENDS = 50;
+    
+    static constexpr std::size_t HEADER_SIZE = 9;  // type, session, sequence
+    static constexpr std::size_t SESSION_SIZE = 4;
+    static constexpr std::size_t HELLO_SIZE = SESSION_SIZE + 1;
+    static constexpr std::size_t MAX_DATAGRAM_SIZE = 65507;  // Largest UDP payload over IPv4
+};
+
+#endif // UDPTRANSPORT_H
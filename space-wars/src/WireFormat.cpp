@@ -0,0 +1,740 @@
+#include "WireFormat.h"
+#include "GameState.h"
+#include "Snapshot.h"
+#include "Quantization.h"
+#include "GameEvent.h"
+#include "PlayerInput.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+//----------------------------------------------------------------------------------------
+void BitWriter::write(std::uint32_t value, int bits) 
+{
+    m_scratch |= static_cast<std::uint64_t>(value) << m_scratchBits;
+    m_scratchBits += bits;
+    while (m_scratchBits >= 8) {
+        m_buffer.push_back(static_cast<std::uint8_t>(m_scratch));
+        m_scratch >>= 8;
+        m_scratchBits -= 8;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void BitWriter::flush() 
+{
+    if (m_scratchBits > 0) {
+        m_buffer.push_back(static_cast<std::uint8_t>(m_scratch));
+        m_scratch = 0;
+        m_scratchBits = 0;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t BitReader::read(int bits) 
+{
+    while (m_scratchBits < bits) {
+        if (m_position >= m_size) {
+            m_ok = false;
+            return 0;
+        }
+        m_scratch |= static_cast<std::uint64_t>(m_data[m_position++]) << m_scratchBits;
+        m_scratchBits += 8;
+    }
+    std::uint32_t value = static_cast<std::uint32_t>(m_scratch & ((std::uint64_t(1) << bits) - 1));
+    m_scratch >>= bits;
+    m_scratchBits -= bits;
+    return value;
+}
+
+//----------------------------------------------------------------------------------------
+bool ByteReader::require(std::size_t bytes) 
+{
+    if (!m_ok || m_size - m_position < bytes) {
+        m_ok = false;
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+std::uint8_t ByteReader::readU8() 
+{
+    if (!require(1)) {
+        return 0;
+    }
+    return m_data[m_position++];
+}
+
+//----------------------------------------------------------------------------------------
+std::uint16_t ByteReader::readU16() 
+{
+    if (!require(2)) {
+        return 0;
+    }
+    std::uint16_t value = static_cast<std::uint16_t>(m_data[m_position] | (m_data[m_position + 1] << 8));
+    m_position += 2;
+    return value;
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t ByteReader::readU32() 
+{
+    if (!require(4)) {
+        return 0;
+    }
+    std::uint32_t value = static_cast<std::uint32_t>(m_data[m_position])
+                        | (static_cast<std::uint32_t>(m_data[m_position + 1]) << 8)
+                        | (static_cast<std::uint32_t>(m_data[m_position + 2]) << 16)
+                        | (static_cast<std::uint32_t>(m_data[m_position + 3]) << 24);
+    m_position += 4;
+    return value;
+}
+
+//----------------------------------------------------------------------------------------
+float ByteReader::readF32() 
+{
+    std::uint32_t bits = readU32();
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+namespace {
+
+// Spacecraft flag bits
+constexpr std::uint8_t FLAG_THRUSTING = 0x01;
+constexpr std::uint8_t FLAG_ALIVE = 0x02;
+
+// Unpacked projectile: position and velocity as floats, then the owner
+constexpr std::size_t UNPACKED_PROJECTILE_BYTES = 4 * sizeof(float) + 1;
+
+//----------------------------------------------------------------------------------------
+void decodeSpacecraft(ByteReader& reader, Spacecraft& spacecraft) 
+{
+    float x = reader.readF32();
+    float y = reader.readF32();
+    float orientation = reader.readF32();
+    float vx = reader.readF32();
+    float vy = reader.readF32();
+    std::uint8_t flags = reader.readU8();
+    
+    spacecraft.setPosition(sf::Vector2f(x, y));
+    spacecraft.setOrientation(orientation);
+    spacecraft.setVelocity(sf::Vector2f(vx, vy));
+    spacecraft.setThrusting((flags & FLAG_THRUSTING) != 0);
+    spacecraft.setAlive((flags & FLAG_ALIVE) != 0);
+}
+
+//----------------------------------------------------------------------------------------
+bool decodeBinary(const std::uint8_t* data, std::size_t size, GameState& gameState) 
+{
+    ByteReader reader(data, size);
+    reader.readU8();  // Version (already checked)
+    if (static_cast<WireFormat::MessageType>(reader.readU8()) != WireFormat::MessageType::GameState) {
+        return false;
+    }
+    
+    // Decode aside and check the whole message is there before gameState is touched
+    Spacecraft spacecraft1 = gameState.getSpacecraft(1);
+    Spacecraft spacecraft2 = gameState.getSpacecraft(2);
+    decodeSpacecraft(reader, spacecraft1);
+    decodeSpacecraft(reader, spacecraft2);
+    
+    int score1 = reader.readU8();
+    int score2 = reader.readU8();
+    bool gameOver = reader.readU8() != 0;
+    
+    std::uint16_t projectileCount = reader.readU16();
+    if (!reader.ok() || reader.remaining() < projectileCount * UNPACKED_PROJECTILE_BYTES) {
+        return false;  // Truncated message
+    }
+    
+    gameState.getSpacecraft(1) = spacecraft1;
+    gameState.getSpacecraft(2) = spacecraft2;
+    gameState.setScore(1, score1);
+    gameState.setScore(2, score2);
+    gameState.setGameOver(gameOver);
+    
+    ProjectilePool& projectiles = gameState.getProjectiles();
+    projectiles.clear();
+    for (std::uint16_t i = 0; i < projectileCount; ++i) {
+        float x = reader.readF32();
+        float y = reader.readF32();
+        float vx = reader.readF32();
+        float vy = reader.readF32();
+        int ownerId = reader.readU8();
+        projectiles.add(sf::Vector2f(x, y), sf::Vector2f(vx, vy), ownerId);  // Dropped if the pool is full
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Decoder for the original text format (compatibility with older builds only - allocates)
+bool decodeLegacyText(const std::string& data, GameState& gameState) 
+{
+    try {
+        std::istringstream iss(data);
+        std::string token;
+        
+        // Parse spacecraft 1
+        if (std::getline(iss, token, ';') && token.substr(0, 4) == "SC1:") {
+            std::string scData = token.substr(4);
+            std::vector<std::string> parts;
+            std::istringstream scStream(scData);
+            std::string part;
+            // Split by comma
+            while (std::getline(scStream, part, ',')) {
+                parts.push_back(part);
+            }
+            // Should have 6 parts: x, y, orientation, vx, vy, thrust
+            if (parts.size() >= 6) {
+                Spacecraft& sc1 = gameState.getSpacecraft(1);
+                sc1.setPosition(sf::Vector2f(std::stof(parts[0]), std::stof(parts[1])));
+                sc1.setOrientation(std::stof(parts[2]));
+                sc1.setVelocity(sf::Vector2f(std::stof(parts[3]), std::stof(parts[4])));
+                sc1.setThrusting(std::stoi(parts[5]) == 1);
+            } else if (parts.size() == 5) {
+                // Backward compatibility: old format without thrust
+                Spacecraft& sc1 = gameState.getSpacecraft(1);
+                sc1.setPosition(sf::Vector2f(std::stof(parts[0]), std::stof(parts[1])));
+                sc1.setOrientation(std::stof(parts[2]));
+                sc1.setVelocity(sf::Vector2f(std::stof(parts[3]), std::stof(parts[4])));
+                sc1.setThrusting(false);  // Default to false for old format
+            }
+        }
+        
+        // Parse spacecraft 2
+        if (std::getline(iss, token, ';') && token.substr(0, 4) == "SC2:") {
+            std::string scData = token.substr(4);
+            std::vector<std::string> parts;
+            std::istringstream scStream(scData);
+            std::string part;
+            // Split by comma
+            while (std::getline(scStream, part, ',')) {
+                parts.push_back(part);
+            }
+            // Should have 6 parts: x, y, orientation, vx, vy, thrust
+            if (parts.size() >= 6) {
+                Spacecraft& sc2 = gameState.getSpacecraft(2);
+                sc2.setPosition(sf::Vector2f(std::stof(parts[0]), std::stof(parts[1])));
+                sc2.setOrientation(std::stof(parts[2]));
+                sc2.setVelocity(sf::Vector2f(std::stof(parts[3]), std::stof(parts[4])));
+                sc2.setThrusting(std::stoi(parts[5]) == 1);
+            } else if (parts.size() == 5) {
+                // Backward compatibility: old format without thrust
+                Spacecraft& sc2 = gameState.getSpacecraft(2);
+                sc2.setPosition(sf::Vector2f(std::stof(parts[0]), std::stof(parts[1])));
+                sc2.setOrientation(std::stof(parts[2]));
+                sc2.setVelocity(sf::Vector2f(std::stof(parts[3]), std::stof(parts[4])));
+                sc2.setThrusting(false);  // Default to false for old format
+            }
+        }
+        
+        // Parse projectiles
+        if (std::getline(iss, token, ';') && token.substr(0, 5) == "PROJ:") {
+            std::string projData = token.substr(5);
+            if (!projData.empty()) {
+                std::istringstream projStream(projData);
+                std::string projToken;
+                while (std::getline(projStream, projToken, '|')) {
+                    if (!projToken.empty()) {
+                        std::istringstream pStream(projToken);
+                        std::vector<std::string> parts;
+                        std::string part;
+                        while (std::getline(pStream, part, ',')) {
+                            parts.push_back(part);
+                        }
+                        if (parts.size() == 5) {
+                            float posX = std::stof(parts[0]);
+                            float posY = std::stof(parts[1]);
+                            float velX = std::stof(parts[2]);
+                            float velY = std::stof(parts[3]);
+                            int ownerId = std::stoi(parts[4]);
+                            sf::Vector2f pos(posX, posY);
+                            sf::Vector2f vel(velX, velY);
+                            Projectile proj(pos, vel, ownerId);
+                            gameState.addProjectile(proj);
+                        }
+                    }
+                }
+            }
+        }
+        
+        // Parse scores
+        if (std::getline(iss, token, ';') && token.substr(0, 6) == "SCORE:") {
+            std::string scoreData = token.substr(6);
+            std::istringstream scoreStream(scoreData);
+            std::string val;
+            if (std::getline(scoreStream, val, ',')) {
+                int score1 = std::stoi(val);
+                if (std::getline(scoreStream, val, ',')) {
+                    int score2 = std::stoi(val);
+                    gameState.setScore(1, score1);
+                    gameState.setScore(2, score2);
+                }
+            }
+        }
+        
+        // Parse game over
+        if (std::getline(iss, token, ';') && token.substr(0, 9) == "GAMEOVER:") {
+            std::string gameOverStr = token.substr(9);
+            bool gameOver = (gameOverStr == "1");
+            gameState.setGameOver(gameOver);
+        }
+        
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to decode text game state: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// SnapshotDelta change mask
+constexpr std::uint32_t CHANGED_SHIP1 = 0x01;
+constexpr std::uint32_t CHANGED_SHIP2 = 0x02;
+constexpr std::uint32_t CHANGED_SCORE = 0x04;
+constexpr std::uint32_t CHANGED_INPUT_ACK = 0x08;
+constexpr int CHANGED_BITS = 4;
+
+// SnapshotDelta per-spacecraft field mask
+constexpr std::uint32_t FIELD_POSITION = 0x01;
+constexpr std::uint32_t FIELD_ORIENTATION = 0x02;
+constexpr std::uint32_t FIELD_VELOCITY = 0x04;
+constexpr std::uint32_t FIELD_FLAGS = 0x08;
+constexpr std::uint32_t FIELD_ALL = 0x0F;
+constexpr int FIELD_BITS = 4;
+
+// Remaining field widths
+constexpr int TICK_BITS = 32;
+constexpr int SESSION_BITS = 32;
+constexpr int SEQUENCE_BITS = 32;
+constexpr int BASELINE_DISTANCE_BITS = 6;
+constexpr int TIME_BITS = 32;
+constexpr int SHIP_FLAG_BITS = 2;
+constexpr int SCORE_BITS = 8;
+constexpr int PROJECTILE_ID_BITS = 32;
+constexpr int OWNER_BITS = 2;
+constexpr int EVENT_TYPE_BITS = 8;
+constexpr int INPUT_COUNT_BITS = 6;
+
+static_assert(SnapshotHistory::SIZE <= (1u << BASELINE_DISTANCE_BITS),
+              "Baseline distance must be able to reach the oldest stored snapshot");
+static_assert(WireFormat::InputFrames::MAX_FRAMES < (1u << INPUT_COUNT_BITS),
+              "Input count must be able to hold a full message");
+
+//----------------------------------------------------------------------------------------
+void writeHeader(BitWriter& writer, WireFormat::MessageType type, std::uint32_t tick) 
+{
+    writer.write(WireFormat::VERSION, 8);
+    writer.write(static_cast<std::uint32_t>(type), 8);
+    writer.write(tick, TICK_BITS);
+}
+
+//----------------------------------------------------------------------------------------
+bool readHeader(BitReader& reader, WireFormat::MessageType type) 
+{
+    std::uint32_t version = reader.read(8);
+    std::uint32_t messageType = reader.read(8);
+    reader.read(TICK_BITS);  // Sender's tick, see peekMessageHeader()
+    return reader.ok() && version == WireFormat::VERSION && static_cast<WireFormat::MessageType>(messageType) == type;
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t shipFieldMask(const ShipSnapshot* baseline, const ShipSnapshot& current) 
+{
+    if (!baseline) {
+        return FIELD_ALL;
+    }
+    std::uint32_t mask = 0;
+    if (current.x != baseline->x || current.y != baseline->y) {
+        mask |= FIELD_POSITION;
+    }
+    if (current.orientation != baseline->orientation) {
+        mask |= FIELD_ORIENTATION;
+    }
+    if (current.velocityX != baseline->velocityX || current.velocityY != baseline->velocityY) {
+        mask |= FIELD_VELOCITY;
+    }
+    if (current.flags != baseline->flags) {
+        mask |= FIELD_FLAGS;
+    }
+    return mask;
+}
+
+//----------------------------------------------------------------------------------------
+void encodeShipDelta(BitWriter& writer, std::uint32_t mask, const ShipSnapshot& ship) 
+{
+    using namespace Quantization;
+    writer.write(mask, FIELD_BITS);
+    if (mask & FIELD_POSITION) {
+        writer.write(encodePositionX(ship.x), POSITION_X_BITS);
+        writer.write(encodePositionY(ship.y), POSITION_Y_BITS);
+    }
+    if (mask & FIELD_ORIENTATION) {
+        writer.write(encodeOrientation(ship.orientation), ORIENTATION_BITS);
+    }
+    if (mask & FIELD_VELOCITY) {
+        writer.write(encodeVelocity(ship.velocityX, SPACECRAFT_VELOCITY_LIMIT), SPACECRAFT_VELOCITY_BITS);
+        writer.write(encodeVelocity(ship.velocityY, SPACECRAFT_VELOCITY_LIMIT), SPACECRAFT_VELOCITY_BITS);
+    }
+    if (mask & FIELD_FLAGS) {
+        writer.write(ship.flags, SHIP_FLAG_BITS);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void decodeShipDelta(BitReader& reader, ShipSnapshot& ship) 
+{
+    using namespace Quantization;
+    std::uint32_t mask = reader.read(FIELD_BITS);
+    if (mask & FIELD_POSITION) {
+        ship.x = decodePosition(reader.read(POSITION_X_BITS));
+        ship.y = decodePosition(reader.read(POSITION_Y_BITS));
+    }
+    if (mask & FIELD_ORIENTATION) {
+        ship.orientation = decodeOrientation(reader.read(ORIENTATION_BITS));
+    }
+    if (mask & FIELD_VELOCITY) {
+        ship.velocityX = decodeVelocity(reader.read(SPACECRAFT_VELOCITY_BITS), SPACECRAFT_VELOCITY_LIMIT);
+        ship.velocityY = decodeVelocity(reader.read(SPACECRAFT_VELOCITY_BITS), SPACECRAFT_VELOCITY_LIMIT);
+    }
+    if (mask & FIELD_FLAGS) {
+        ship.flags = static_cast<std::uint8_t>(reader.read(SHIP_FLAG_BITS));
+    }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+bool WireFormat::decodeGameState(const std::uint8_t* data, std::size_t size, GameState& gameState) 
+{
+    if (size == 0) {
+        return false;
+    }
+    
+    if (data[0] == UNPACKED_VERSION) {
+        return decodeBinary(data, size, gameState);
+    }
+    
+    if (data[0] == 'S') {
+        // Text format from an older build ("SC1:..."), parsed into a copy (this path allocates anyway)
+        GameState decoded = gameState;
+        decoded.getProjectiles().clear();
+        if (!decodeLegacyText(std::string(reinterpret_cast<const char*>(data), size), decoded)) {
+            return false;
+        }
+        gameState = decoded;
+        return true;
+    }
+    
+    std::cerr << "Unsupported game state message version " << static_cast<int>(data[0]) << std::endl;
+    return false;
+}
+
+//----------------------------------------------------------------------------------------
+bool WireFormat::peekMessageType(const std::uint8_t* data, std::size_t size, MessageType& type) 
+{
+    if (size < 2 || data[0] != VERSION) {
+        return false;
+    }
+    type = static_cast<MessageType>(data[1]);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool WireFormat::peekMessageHeader(const std::uint8_t* data, std::size_t size, MessageHeader& header) 
+{
+    BitReader reader(data, size);
+    std::uint32_t version = reader.read(8);
+    header.type = static_cast<MessageType>(reader.read(8));
+    header.tick = reader.read(TICK_BITS);
+    return reader.ok() && version == VERSION;
+}
+
+//----------------------------------------------------------------------------------------
+void WireFormat::encodeSnapshotDelta(const Snapshot* baseline, const Snapshot& current, std::uint32_t session,
+                                     std::uint32_t ack, std::uint32_t tick, std::vector<std::uint8_t>& buffer) 
+{
+    buffer.clear();
+    BitWriter writer(buffer);
+    writeHeader(writer, MessageType::SnapshotDelta, tick);
+    
+    writer.write(session, SESSION_BITS);
+    writer.write(current.sequence, SEQUENCE_BITS);
+    writer.write(ack, SEQUENCE_BITS);
+    // Baseline as a distance back from sequence (0 for a full snapshot)
+    writer.write(baseline ? current.sequence - baseline->sequence : 0, BASELINE_DISTANCE_BITS);
+    writer.write(current.timeMs, TIME_BITS);
+    
+    std::uint32_t shipMask1 = shipFieldMask(baseline ? &baseline->ships[0] : nullptr, current.ships[0]);
+    std::uint32_t shipMask2 = shipFieldMask(baseline ? &baseline->ships[1] : nullptr, current.ships[1]);
+    
+    std::uint32_t changes = 0;
+    if (shipMask1) {
+        changes |= CHANGED_SHIP1;
+    }
+    if (shipMask2) {
+        changes |= CHANGED_SHIP2;
+    }
+    if (!baseline || current.scores != baseline->scores || current.gameOver != baseline->gameOver) {
+        changes |= CHANGED_SCORE;
+    }
+    if (baseline ? current.inputAck != baseline->inputAck : current.inputAck != 0) {
+        changes |= CHANGED_INPUT_ACK;
+    }
+    writer.write(changes, CHANGED_BITS);
+    
+    if (changes & CHANGED_SHIP1) {
+        encodeShipDelta(writer, shipMask1, current.ships[0]);
+    }
+    if (changes & CHANGED_SHIP2) {
+        encodeShipDelta(writer, shipMask2, current.ships[1]);
+    }
+    if (changes & CHANGED_SCORE) {
+        writer.write(current.scores[0], SCORE_BITS);
+        writer.write(current.scores[1], SCORE_BITS);
+        writer.writeBool(current.gameOver);
+    }
+    if (changes & CHANGED_INPUT_ACK) {
+        writer.write(current.inputAck, SEQUENCE_BITS);
+    }
+    writer.flush();
+}
+
+//----------------------------------------------------------------------------------------
+std::uint32_t WireFormat::newSession() 
+{
+    std::random_device random;
+    std::uint32_t session;
+    do {
+        session = random();
+    } while (session == 0);
+    return session;
+}
+
+//----------------------------------------------------------------------------------------
+bool WireFormat::decodeSnapshotHeader(BitReader& reader, SnapshotHeader& header) 
+{
+    bool headerOk = readHeader(reader, MessageType::SnapshotDelta);
+    header.session = reader.read(SESSION_BITS);
+    header.sequence = reader.read(SEQUENCE_BITS);
+    header.ack = reader.read(SEQUENCE_BITS);
+    std::uint32_t baselineDistance = reader.read(BASELINE_DISTANCE_BITS);
+    if (baselineDistance >= header.sequence) {
+        return false;  // Points before the first snapshot
+    }
+    header.baseline = (baselineDistance != 0) ? header.sequence - baselineDistance : 0;
+    return reader.ok() && headerOk && header.session != 0 && header.sequence != 0;
+}
+
+//----------------------------------------------------------------------------------------
+bool WireFormat::decodeSnapshotDelta(BitReader& reader, const Snapshot* baseline, Snapshot& current) 
+{
+    // Start from the baseline
+    std::uint32_t timeMs = reader.read(TIME_BITS);
+    if (baseline) {
+        current.ships = baseline->ships;
+        current.scores = baseline->scores;
+        current.gameOver = baseline->gameOver;
+        current.inputAck = baseline->inputAck;
+    } else {
+        std::uint32_t sequence = current.sequence;
+        current.clear();
+        current.sequence = sequence;
+    }
+    current.timeMs = timeMs;
+    
+    std::uint32_t changes = reader.read(CHANGED_BITS);
+    if (changes & CHANGED_SHIP1) {
+        decodeShipDelta(reader, current.ships[0]);
+    }
+    if (changes & CHANGED_SHIP2) {
+        decodeShipDelta(reader, current.ships[1]);
+    }
+    if (changes & CHANGED_SCORE) {
+        current.scores[0] = static_cast<std::uint8_t>(reader.read(SCORE_BITS));
+        current.scores[1] = static_cast<std::uint8_t>(reader.read(SCORE_BITS));
+        current.gameOver = reader.readBool();
+    }
+    if (changes & CHANGED_INPUT_ACK) {
+        current.inputAck = reader.read(SEQUENCE_BITS);
+    }
+    return reader.ok();
+}
+
+//----------------------------------------------------------------------------------------
+void WireFormat::encodeGameEvent(const GameEvent& event, std::uint32_t tick, std::vector<std::uint8_t>& buffer) 
+{
+    using namespace Quantization;
+    buffer.clear();
+    BitWriter writer(buffer);
+    writeHeader(writer, MessageType::GameEvent, tick);
+    
+    // Only the fields the event type uses are written
+    writer.write(static_cast<std::uint32_t>(event.type), EVENT_TYPE_BITS);
+    writer.write(event.shooterId, OWNER_BITS);
+    switch (event.type) {
+        case GameEvent::Type::Hit:
+            writer.write(event.victimId, OWNER_BITS);
+            writer.write(event.score, SCORE_BITS);
+            writer.write(encodePositionX(event.position.x), POSITION_X_BITS);
+            writer.write(encodePositionY(event.position.y), POSITION_Y_BITS);
+            writer.write(event.projectileId, PROJECTILE_ID_BITS);
+            break;
+        case GameEvent::Type::GameOver:
+            writer.write(event.score, SCORE_BITS);
+            break;
+        case GameEvent::Type::ProjectileSpawn:
+            writer.write(event.projectileId, PROJECTILE_ID_BITS);
+            writer.write(event.timeMs, TIME_BITS);
+            writer.write(encodePositionX(event.position.x), POSITION_X_BITS);
+            writer.write(encodePositionY(event.position.y), POSITION_Y_BITS);
+            writer.write(encodeOrientation(event.orientation), ORIENTATION_BITS);
+            break;
+        case GameEvent::Type::ProjectileDespawn:
+            writer.write(event.projectileId, PROJECTILE_ID_BITS);
+            break;
+    }
+    writer.flush();
+}
+
+//----------------------------------------------------------------------------------------
+bool WireFormat::decodeGameEvent(const std::uint8_t* data, std::size_t size, GameEvent& event) 
+{
+    using namespace Quantization;
+    BitReader reader(data, size);
+    if (!readHeader(reader, MessageType::GameEvent)) {
+        return false;
+    }
+    
+    event = GameEvent();
+    event.type = static_cast<GameEvent::Type>(reader.read(EVENT_TYPE_BITS));
+    event.shooterId = static_cast<std::uint8_t>(reader.read(OWNER_BITS));
+    if (event.shooterId < 1 || event.shooterId > 2) {
+        return false;
+    }
+    
+    switch (event.type) {
+        case GameEvent::Type::Hit: {
+            event.victimId = static_cast<std::uint8_t>(reader.read(OWNER_BITS));
+            event.score = static_cast<std::uint8_t>(reader.read(SCORE_BITS));
+            float x = decodePosition(reader.read(POSITION_X_BITS));
+            float y = decodePosition(reader.read(POSITION_Y_BITS));
+            event.position = sf::Vector2f(x, y);
+            event.projectileId = reader.read(PROJECTILE_ID_BITS);
+            if (event.victimId < 1 || event.victimId > 2) {
+                return false;
+            }
+            break;
+        }
+        case GameEvent::Type::GameOver:
+            event.score = static_cast<std::uint8_t>(reader.read(SCORE_BITS));
+            break;
+        case GameEvent::Type::ProjectileSpawn: {
+            event.projectileId = reader.read(PROJECTILE_ID_BITS);
+            event.timeMs = reader.read(TIME_BITS);
+            float x = decodePosition(reader.read(POSITION_X_BITS));
+            float y = decodePosition(reader.read(POSITION_Y_BITS));
+            event.position = sf::Vector2f(x, y);
+            event.orientation = decodeOrientation(reader.read(ORIENTATION_BITS));
+            break;
+        }
+        case GameEvent::Type::ProjectileDespawn:
+            event.projectileId = reader.read(PROJECTILE_ID_BITS);
+            break;
+        default:
+            return false;  // Unknown event type
+    }
+    return reader.ok();
+}
+
+//----------------------------------------------------------------------------------------
+void WireFormat::encodeHeartbeat(const Heartbeat& heartbeat, std::uint32_t tick, std::vector<std::uint8_t>& buffer) 
+{
+    buffer.clear();
+    BitWriter writer(buffer);
+    writeHeader(writer, MessageType::Heartbeat, tick);
+    writer.write(heartbeat.pong ? 1 : 0, 8);
+    writer.write(heartbeat.sequence, SEQUENCE_BITS);
+    writer.write(heartbeat.timeUs, TIME_BITS);
+    writer.write(heartbeat.replyUs, TIME_BITS);
+    writer.flush();
+}
+
+//----------------------------------------------------------------------------------------
+bool WireFormat::decodeHeartbeat(const std::uint8_t* data, std::size_t size, Heartbeat& heartbeat) 
+{
+    BitReader reader(data, size);
+    if (!readHeader(reader, MessageType::Heartbeat)) {
+        return false;
+    }
+    
+    std::uint32_t pong = reader.read(8);
+    heartbeat.pong = (pong == 1);
+    heartbeat.sequence = reader.read(SEQUENCE_BITS);
+    heartbeat.timeUs = reader.read(TIME_BITS);
+    heartbeat.replyUs = reader.read(TIME_BITS);
+    return reader.ok() && pong <= 1;
+}
+
+//----------------------------------------------------------------------------------------
+void WireFormat::encodeInputFrames(const InputFrames& frames, std::uint32_t tick, std::vector<std::uint8_t>& buffer) 
+{
+    buffer.clear();
+    BitWriter writer(buffer);
+    writeHeader(writer, MessageType::Input, tick);
+    writer.write(frames.firstTick, SEQUENCE_BITS);
+    writer.write(frames.ack, SEQUENCE_BITS);
+    std::size_t count = std::min<std::size_t>(frames.count, InputFrames::MAX_FRAMES);
+    writer.write(static_cast<std::uint32_t>(count), INPUT_COUNT_BITS);
+    for (std::size_t i = 0; i < count; ++i) {
+        writer.write(frames.inputs[i], PlayerInput::BITS);
+    }
+    writer.flush();
+}
+
+//----------------------------------------------------------------------------------------
+bool WireFormat::decodeInputFrames(const std::uint8_t* data, std::size_t size, InputFrames& frames) 
+{
+    BitReader reader(data, size);
+    if (!readHeader(reader, MessageType::Input)) {
+        return false;
+    }
+    
+    frames.firstTick = reader.read(SEQUENCE_BITS);
+    frames.ack = reader.read(SEQUENCE_BITS);
+    std::uint32_t count = reader.read(INPUT_COUNT_BITS);
+    if (count > InputFrames::MAX_FRAMES || frames.firstTick == 0) {
+        return false;
+    }
+    frames.count = static_cast<std::uint8_t>(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        frames.inputs[i] = static_cast<std::uint8_t>(reader.read(PlayerInput::BITS));
+    }
+    return reader.ok();
+}
+
+//----------------------------------------------------------------------------------------
+void WireFormat::encodeJoin(const Join& join, std::uint32_t tick, std::vector<std::uint8_t>& buffer) 
+{
+    buffer.clear();
+    BitWriter writer(buffer);
+    writeHeader(writer, MessageType::Join, tick);
+    writer.write(join.playerId, 8);
+    writer.flush();
+}
+
+//----------------------------------------------------------------------------------------
+bool WireFormat::decodeJoin(const std::uint8_t* data, std::size_t size, Join& join) 
+{
+    BitReader reader(data, size);
+    if (!readHeader(reader, MessageType::Join)) {
+        return false;
+    }
+    join.playerId = static_cast<std::uint8_t>(reader.read(8));
+    return reader.ok() && (join.playerId == 1 || join.playerId == 2);
+}
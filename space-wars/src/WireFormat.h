@@ -0,0 +1,182 @@
+#ifndef WIREFORMAT_H
+#define WIREFORMAT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GameState;
+struct Snapshot;
+struct GameEvent;
+
+// Little-endian byte stream reader over a borrowed buffer (never allocates)
+// Used for the byte-aligned messages of older builds.
+// Reading past the end returns zeros and latches the reader into the failed state.
+class ByteReader {
+public:
+    ByteReader(const std::uint8_t* data, std::size_t size) : m_data(data), m_size(size), m_position(0), m_ok(true) {}
+    
+    std::uint8_t readU8();
+    std::uint16_t readU16();
+    std::uint32_t readU32();
+    float readF32();
+    
+    bool ok() const { return m_ok; }
+    std::size_t remaining() const { return m_size - m_position; }
+
+private:
+    bool require(std::size_t bytes);
+    
+    const std::uint8_t* m_data;
+    std::size_t m_size;
+    std::size_t m_position;
+    bool m_ok;
+};
+
+// Bit stream writer appending to a reusable buffer (LSB first, little-endian byte order)
+// Call flush() after the last field to write out a partial final byte.
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<std::uint8_t>& buffer) : m_buffer(buffer), m_scratch(0), m_scratchBits(0) {}
+    
+    void write(std::uint32_t value, int bits);  // bits is 1-32, value must fit
+    void writeBool(bool value) { write(value ? 1 : 0, 1); }
+    void flush();
+
+private:
+    std::vector<std::uint8_t>& m_buffer;
+    std::uint64_t m_scratch;
+    int m_scratchBits;
+};
+
+// Bit stream reader over a borrowed buffer (never allocates)
+// Reading past the end returns zeros and latches the reader into the failed state.
+class BitReader {
+public:
+    BitReader(const std::uint8_t* data, std::size_t size)
+        : m_data(data), m_size(size), m_position(0), m_scratch(0), m_scratchBits(0), m_ok(true) {}
+    
+    std::uint32_t read(int bits);  // bits is 1-32
+    bool readBool() { return read(1) != 0; }
+    
+    bool ok() const { return m_ok; }
+
+private:
+    const std::uint8_t* m_data;
+    std::size_t m_size;
+    std::size_t m_position;
+    std::uint64_t m_scratch;
+    int m_scratchBits;
+    bool m_ok;
+};
+
+// Network message encoding
+// Every binary message starts with a version byte, a message type byte and the sender's
+// tick (32 bits), followed by a bit-packed payload. The tick lets the receiver tell how old
+// a message is and place it on its own timeline (see ClockSync). Full-state messages from
+// older builds (byte-aligned version 2 binary, or text starting with "SC1:") are still decoded.
+namespace WireFormat {
+    constexpr std::uint8_t VERSION = 7;
+    constexpr std::uint8_t UNPACKED_VERSION = 2;  // Byte-aligned floats, decode only
+    
+    enum class MessageType : std::uint8_t {
+        GameState = 1,     // Full state, no sequencing (version 2 only)
+        SnapshotDelta = 2,  // Sequenced snapshot, delta against a snapshot the peer acknowledged
+        GameEvent = 3,      // One gameplay event (event channel), includes projectile spawns
+        Heartbeat = 4,      // Ping or pong (heartbeat channel)
+        Input = 5,          // Recent inputs of one player, rollback mode or to a server (state channel)
+        Join = 6            // Client asks a dedicated server for a player slot
+    };
+    
+    // Fields every current-version message starts with
+    struct MessageHeader {
+        MessageType type = MessageType::GameState;
+        std::uint32_t tick = 0;  // Sender's simulation tick when the message was sent
+    };
+    
+    // Sequencing fields at the start of a SnapshotDelta message
+    struct SnapshotHeader {
+        std::uint32_t session = 0;   // Sender's snapshot stream, new whenever it numbers from 1 again
+        std::uint32_t sequence = 0;  // Sender's snapshot number, starts at 1
+        std::uint32_t ack = 0;       // Newest of our snapshots the sender has received, 0 if none
+        std::uint32_t baseline = 0;  // Snapshot the delta is against, 0 for a full snapshot
+    };
+    
+    // Heartbeat ping, or the pong answering it
+    // A pong echoes the ping's sequence and timestamp unchanged, so the pinging side measures
+    // the round trip on its own clock, and adds the answering side's clock, which gives the
+    // pinging side the offset between the two (see ClockSync).
+    struct Heartbeat {
+        bool pong = false;
+        std::uint32_t sequence = 0;  // Ping number, starts at 1
+        std::uint32_t timeUs = 0;    // Pinging side's clock when the ping left (wraps)
+        std::uint32_t replyUs = 0;   // Pong only: answering side's clock when the pong left (wraps)
+    };
+    
+    // Consecutive inputs of one player, oldest first, as PlayerInput bitmasks
+    // Every message repeats all inputs the receiver has not acknowledged (up to MAX_FRAMES),
+    // so any single message may be lost or superseded.
+    struct InputFrames {
+        static constexpr std::size_t MAX_FRAMES = 32;
+        std::uint32_t firstTick = 0;  // Tick of inputs[0], ticks start at 1
+        std::uint32_t ack = 0;        // Newest tick up to which the sender has all of our inputs, 0 if none
+        std::uint8_t count = 0;       // Inputs in use, 0 to MAX_FRAMES
+        std::array<std::uint8_t, MAX_FRAMES> inputs{};
+    };
+    
+    // First message from a client to a dedicated server
+    struct Join {
+        std::uint8_t playerId = 0;  // Requested player, 1 or 2
+    };
+    
+    // Message type of a current-version message, false for older or empty messages
+    bool peekMessageType(const std::uint8_t* data, std::size_t size, MessageType& type);
+    
+    // Type and sender's tick of a current-version message, false for older or truncated messages
+    bool peekMessageHeader(const std::uint8_t* data, std::size_t size, MessageHeader& header);
+    
+    // Every encoder stamps the message with tick, the sender's current simulation tick
+    
+    // Encode current as a delta against baseline (nullptr sends every field)
+    // Only changed spacecraft fields and scores are written, packed on the Quantization grids
+    // (a full snapshot is under 48 bytes). Projectiles are not part of snapshots: they are
+    // replicated by spawn and despawn GameEvents. session names the sender's stream of
+    // sequence numbers (see newSession()).
+    void encodeSnapshotDelta(const Snapshot* baseline, const Snapshot& current, std::uint32_t session,
+                             std::uint32_t ack, std::uint32_t tick, std::vector<std::uint8_t>& buffer);
+    
+    // Random nonzero session for a sender that starts numbering its snapshots from 1, so the
+    // receiver can tell a restarted peer from stale messages of the old stream
+    std::uint32_t newSession();
+    
+    // Decode the header of a SnapshotDelta message (reader is left at the payload)
+    bool decodeSnapshotHeader(BitReader& reader, SnapshotHeader& header);
+    
+    // Decode the payload into current, starting from baseline (nullptr for a full snapshot)
+    // baseline and current must be different objects. Returns false if the payload is malformed.
+    bool decodeSnapshotDelta(BitReader& reader, const Snapshot* baseline, Snapshot& current);
+    
+    // Encode/decode a GameEvent message
+    void encodeGameEvent(const GameEvent& event, std::uint32_t tick, std::vector<std::uint8_t>& buffer);
+    bool decodeGameEvent(const std::uint8_t* data, std::size_t size, GameEvent& event);
+    
+    // Encode/decode a Heartbeat message (19 bytes)
+    void encodeHeartbeat(const Heartbeat& heartbeat, std::uint32_t tick, std::vector<std::uint8_t>& buffer);
+    bool decodeHeartbeat(const std::uint8_t* data, std::size_t size, Heartbeat& heartbeat);
+    
+    // Encode/decode an Input message (at most 31 bytes)
+    void encodeInputFrames(const InputFrames& frames, std::uint32_t tick, std::vector<std::uint8_t>& buffer);
+    bool decodeInputFrames(const std::uint8_t* data, std::size_t size, InputFrames& frames);
+    
+    // Encode/decode a Join message (7 bytes)
+    void encodeJoin(const Join& join, std::uint32_t tick, std::vector<std::uint8_t>& buffer);
+    bool decodeJoin(const std::uint8_t* data, std::size_t size, Join& join);
+    
+    // Decode an unsequenced full-state message from an older build (binary or text) into gameState
+    // Projectiles in gameState are replaced. Returns false, leaving gameState untouched, if the
+    // message is malformed.
+    bool decodeGameState(const std::uint8_t* data, std::size_t size, GameState& gameState);
+}
+
+#endif // WIREFORMAT_H
@@ -0,0 +1,207 @@
+#include "ZmqTransport.h"
+#include <iostream>
+
+//----------------------------------------------------------------------------------------
+ZmqTransport::ZmqTransport(bool latencyBounded)
+    : m_latencyBounded(latencyBounded)
+{
+    try {
+        m_context = std::make_unique<zmq::context_t>(1);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create ZeroMQ context: " << e.what() << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+ZmqTransport::~ZmqTransport() 
+{
+    // Close sockets before the context: ZeroMQ contexts should be destroyed after all
+    // sockets are closed
+    close();
+}
+
+//----------------------------------------------------------------------------------------
+std::string ZmqTransport::createAddress(const std::string& ip, int port) 
+{
+    return "tcp://" + ip + ":" + std::to_string(port);
+}
+
+//----------------------------------------------------------------------------------------
+std::string ZmqTransport::createLocalAddress(int port) 
+{
+    return "tcp://*:" + std::to_string(port);
+}
+
+//----------------------------------------------------------------------------------------
+bool ZmqTransport::open(const std::string& peerIp, int peerPort, int localPort) 
+{
+    if (!m_context) {
+        return false;
+    }
+    
+    try {
+        close();
+        
+        // Create PULL socket for receiving (bind locally)
+        m_receiveSocket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PULL);
+        
+        // Create PUSH socket for sending (connect to peer)
+        m_sendSocket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PUSH);
+        
+        if (m_latencyBounded) {
+            // Keep only the newest snapshot on both ends instead of a backlog: a queued snapshot
+            // is superseded by the next one anyway, and every message waiting ahead of it is
+            // latency. Must be set before bind/connect.
+            m_sendSocket->set(zmq::sockopt::conflate, 1);
+            m_receiveSocket->set(zmq::sockopt::conflate, 1);
+        } else {
+            // Set send high water mark to allow queuing messages when peer isn't ready
+            // This helps prevent message loss during initial connection
+            int sendHWM = 1000;  // Allow up to 1000 messages to queue
+            m_sendSocket->set(zmq::sockopt::sndhwm, sendHWM);
+            
+            // Set receive high water mark
+            int recvHWM = 1000;
+            m_receiveSocket->set(zmq::sockopt::rcvhwm, recvHWM);
+        }
+        
+        m_receiveSocket->bind(createLocalAddress(localPort));
+        m_sendSocket->connect(createAddress(peerIp, peerPort));
+        
+        // Set socket options for non-blocking receive
+        int timeout = 100;  // 100ms timeout
+        m_receiveSocket->set(zmq::sockopt::rcvtimeo, timeout);
+        
+        // Event channel: default high water marks, never conflated
+        m_eventReceiveSocket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PULL);
+        m_eventReceiveSocket->bind(createLocalAddress(localPort + EVENT_PORT_OFFSET));
+        m_eventSendSocket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PUSH);
+        m_eventSendSocket->connect(createAddress(peerIp, peerPort + EVENT_PORT_OFFSET));
+        
+        // Heartbeat channel: a short queue, so pings to a dead peer are refused (and counted
+        // as lost) instead of piling up and arriving as one stale burst
+        int heartbeatHWM = 8;
+        m_heartbeatReceiveSocket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PULL);
+        m_heartbeatReceiveSocket->set(zmq::sockopt::rcvhwm, heartbeatHWM);
+        m_heartbeatReceiveSocket->bind(createLocalAddress(localPort + HEARTBEAT_PORT_OFFSET));
+        m_heartbeatSendSocket = std::make_unique<zmq::socket_t>(*m_context, ZMQ_PUSH);
+        m_heartbeatSendSocket->set(zmq::sockopt::sndhwm, heartbeatHWM);
+        m_heartbeatSendSocket->connect(createAddress(peerIp, peerPort + HEARTBEAT_PORT_OFFSET));
+        
+        // Set linger to 0 so sockets close immediately (prevents hanging on shutdown)
+        int linger = 0;
+        m_receiveSocket->set(zmq::sockopt::linger, linger);
+        m_sendSocket->set(zmq::sockopt::linger, linger);
+        m_eventReceiveSocket->set(zmq::sockopt::linger, linger);
+        m_eventSendSocket->set(zmq::sockopt::linger, linger);
+        m_heartbeatReceiveSocket->set(zmq::sockopt::linger, linger);
+        m_heartbeatSendSocket->set(zmq::sockopt::linger, linger);
+        
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to connect: " << e.what() << std::endl;
+        close();
+        return false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+void ZmqTransport::close() 
+{
+    // Set linger to 0 on sockets before destroying them to prevent hanging on shutdown
+    // This ensures sockets close immediately rather than waiting for pending messages
+    try {
+        for (zmq::socket_t* socket : { m_receiveSocket.get(), m_sendSocket.get(),
+                                       m_eventReceiveSocket.get(), m_eventSendSocket.get(),
+                                       m_heartbeatReceiveSocket.get(), m_heartbeatSendSocket.get() }) {
+            if (socket) {
+                socket->set(zmq::sockopt::linger, 0);
+            }
+        }
+    } catch (const std::exception& e) {
+        // Ignore errors during cleanup - we're shutting down anyway
+        // Socket might already be closed or in an invalid state
+    }
+    
+    // Reset the unique pointers - sockets will be automatically closed/destroyed
+    // Setting linger=0 ensures they close immediately without blocking
+    m_sendSocket.reset();
+    m_receiveSocket.reset();
+    m_eventSendSocket.reset();
+    m_eventReceiveSocket.reset();
+    m_heartbeatSendSocket.reset();
+    m_heartbeatReceiveSocket.reset();
+}
+
+//----------------------------------------------------------------------------------------
+void ZmqTransport::wait(std::chrono::milliseconds timeout) 
+{
+    zmq::pollitem_t items[] = {
+        { m_receiveSocket->handle(), 0, ZMQ_POLLIN, 0 },
+        { m_eventReceiveSocket->handle(), 0, ZMQ_POLLIN, 0 },
+        { m_heartbeatReceiveSocket->handle(), 0, ZMQ_POLLIN, 0 }
+    };
+    zmq::poll(items, 3, timeout);
+}
+
+//----------------------------------------------------------------------------------------
+bool ZmqTransport::sendState(const std::uint8_t* data, std::size_t size) 
+{
+    // Use dontwait to avoid blocking
+    // Fails if the high water mark is reached (peer is slow) or the peer's PULL socket isn't
+    // bound yet - normal during initial connection, so it is not treated as connection loss
+    return m_sendSocket->send(zmq::buffer(data, size), zmq::send_flags::dontwait).has_value();
+}
+
+//----------------------------------------------------------------------------------------
+std::size_t ZmqTransport::receiveLatestState(const std::uint8_t*& data, std::size_t& size) 
+{
+    // Drain the queue without looking at anything: each state supersedes the previous one.
+    // The two messages are swapped rather than recreated so their storage is reused.
+    std::size_t received = 0;
+    while (m_receiveSocket->recv(m_incomingMessage, zmq::recv_flags::dontwait).has_value()) {
+        m_latestMessage.swap(m_incomingMessage);
+        received++;
+    }
+    
+    if (received > 0) {
+        data = static_cast<const std::uint8_t*>(m_latestMessage.data());
+        size = m_latestMessage.size();
+    }
+    return received;
+}
+
+//----------------------------------------------------------------------------------------
+bool ZmqTransport::sendReliable(const std::uint8_t* data, std::size_t size) 
+{
+    // TCP already delivers in order; a full queue (high water mark) is retried by the caller
+    return m_eventSendSocket->send(zmq::buffer(data, size), zmq::send_flags::dontwait).has_value();
+}
+
+//----------------------------------------------------------------------------------------
+bool ZmqTransport::receiveReliable(const std::uint8_t*& data, std::size_t& size) 
+{
+    if (!m_eventReceiveSocket->recv(m_eventMessage, zmq::recv_flags::dontwait).has_value()) {
+        return false;
+    }
+    data = static_cast<const std::uint8_t*>(m_eventMessage.data());
+    size = m_eventMessage.size();
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool ZmqTransport::sendHeartbeat(const std::uint8_t* data, std::size_t size) 
+{
+    return m_heartbeatSendSocket->send(zmq::buffer(data, size), zmq::send_flags::dontwait).has_value();
+}
+
+//----------------------------------------------------------------------------------------
+bool ZmqTransport::receiveHeartbeat(const std::uint8_t*& data, std::size_t& size) 
+{
+    if (!m_heartbeatReceiveSocket->recv(m_heartbeatMessage, zmq::recv_flags::dontwait).has_value()) {
+        return false;
+    }
+    data = static_cast<const std::uint8_t*>(m_heartbeatMessage.data());
+    size = m_heartbeatMessage.size();
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef ZMQTRANSPORT_H
+#define ZMQTRANSPORT_H
+
+#include "Transport.h"
+#include <memory>
+#include <zmq.hpp>
+
+// Transport over ZeroMQ PUSH/PULL sockets (TCP)
+// Each channel is a PUSH socket connected to the peer and a PULL socket bound locally. The
+// event and heartbeat channels use ports offset by EVENT_PORT_OFFSET and
+// HEARTBEAT_PORT_OFFSET. TCP delivers everything in order, so
+// one lost packet holds back every later state message until it is retransmitted.
+class ZmqTransport : public Transport {
+public:
+    // latencyBounded: conflate the state sockets so only the newest message is queued
+    explicit ZmqTransport(bool latencyBounded);
+    ~ZmqTransport() override;
+    
+    bool open(const std::string& peerIp, int peerPort, int localPort) override;
+    void close() override;
+    bool update() override { return true; }
+    void wait(std::chrono::milliseconds timeout) override;
+    
+    bool sendState(const std::uint8_t* data, std::size_t size) override;
+    std::size_t receiveLatestState(const std::uint8_t*& data, std::size_t& size) override;
+    bool sendReliable(const std::uint8_t* data, std::size_t size) override;
+    bool receiveReliable(const std::uint8_t*& data, std::size_t& size) override;
+    bool sendHeartbeat(const std::uint8_t* data, std::size_t size) override;
+    bool receiveHeartbeat(const std::uint8_t*& data, std::size_t& size) override;
+    
+    // Event and heartbeat channel ports relative to the state channel ports (clear of the
+    // usual adjacent port pairs such as 5555/5556)
+    static constexpr int EVENT_PORT_OFFSET = 100;
+    static constexpr int HEARTBEAT_PORT_OFFSET = 200;
+
+private:
+    std::string createAddress(const std::string& ip, int port);
+    std::string createLocalAddress(int port);
+    
+    bool m_latencyBounded;
+    
+    std::unique_ptr<zmq::context_t> m_context;
+    std::unique_ptr<zmq::socket_t> m_sendSocket;
+    std::unique_ptr<zmq::socket_t> m_receiveSocket;
+    std::unique_ptr<zmq::socket_t> m_eventSendSocket;
+    std::unique_ptr<zmq::socket_t> m_eventReceiveSocket;
+    std::unique_ptr<zmq::socket_t> m_heartbeatSendSocket;
+    std::unique_ptr<zmq::socket_t> m_heartbeatReceiveSocket;
+    
+    // Receive messages, swapped while draining so their storage is recycled
+    zmq::message_t m_incomingMessage;
+    zmq::message_t m_latestMessage;
+    zmq::message_t m_eventMessage;
+    zmq::message_t m_heartbeatMessage;
+};
+
+#endif // ZMQTRANSPORT_H
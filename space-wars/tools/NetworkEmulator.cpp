@@ -0,0 +1,531 @@
+// Network conditions emulator: a UDP proxy between two SpaceWars instances on this machine
+// Each player points client_port at one of the proxy's ports instead of at the other player,
+// and the proxy forwards every datagram to the other player after putting it through the
+// conditions of a profile: latency and jitter, random and bursty loss, reordering,
+// duplication and a bandwidth cap with a bounded queue. Both directions get the same
+// conditions but are emulated separately. Profiles are built in or read from a file, and may
+// run through several timed phases (a connection that is fine most of the time and then
+// bad for a while). Every packet's fate and timing can be logged as CSV. All traffic stays on
+// the loopback interface, and a fixed seed makes a run repeatable.
+//
+// Usage: SpaceWarsNetem <profile> <port_a> <player_a_port> <port_b> <player_b_port> [log_file] [seed]
+//   Player A: client_port=<port_a>, host_port=<player_a_port>
+//   Player B: client_port=<port_b>, host_port=<player_b_port>
+//   Both: client_ip=127.0.0.1, transport=udp
+// log_file "-" writes the packet log to standard output.
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t MAX_DATAGRAM = 65507;  // Largest UDP payload over IPv4, so nothing is ever cut short
+constexpr std::chrono::seconds REPORT_INTERVAL{5};
+
+volatile std::sig_atomic_t g_stop = 0;
+
+// Conditions during one phase of a profile, for each direction of the link
+// Rates are chances per packet (0-1); times are milliseconds.
+struct Conditions {
+    double duration = 0.0;        // Seconds until the next phase, 0 = for good
+    double latency = 0.0;         // One way
+    double jitter = 0.0;          // Standard deviation of the delay added to latency
+    double loss = 0.0;            // Random loss
+    double burstStart = 0.0;      // Chance that a loss burst starts
+    double burstEnd = 0.0;        // Chance that a loss burst ends
+    double burstLoss = 0.0;       // Loss during a burst (instead of loss)
+    double reorder = 0.0;         // Chance a packet is held back behind later ones
+    double reorderDelay = 0.0;    // How long it is held back
+    double duplicate = 0.0;       // Chance a packet is delivered twice
+    double bandwidth = 0.0;       // Kilobits per second, 0 = unlimited
+    double queueLimit = 200.0;    // Longest wait for the bandwidth cap before tail drops
+};
+
+// Named list of phases, run in order and repeated (unless the last one lasts for good)
+struct Profile {
+    std::string name;
+    std::vector<Conditions> phases;
+};
+
+// A datagram on its way through the emulated link
+struct Packet {
+    Clock::time_point deliverAt;
+    std::uint64_t order = 0;  // Keeps delivery stable for packets due at the same time
+    int direction = 0;        // 0: A to B, 1: B to A
+    Clock::time_point receivedAt;
+    bool duplicate = false;
+    bool reordered = false;
+    std::vector<std::uint8_t> data;
+    
+    bool operator>(const Packet& other) const
+    {
+        return deliverAt != other.deliverAt ? deliverAt > other.deliverAt : order > other.order;
+    }
+};
+
+// One direction of the link: its burst state, bandwidth queue and statistics
+struct Link {
+    bool inBurst = false;
+    Clock::time_point queueFreeAt;    // When the bandwidth cap has sent everything queued
+    Clock::time_point lastDeliverAt;  // Packets that are not reordered never overtake this
+    
+    std::uint64_t received = 0;
+    std::uint64_t delivered = 0;
+    std::uint64_t lost = 0;
+    std::uint64_t queueDrops = 0;
+    std::uint64_t duplicated = 0;
+    std::uint64_t reordered = 0;
+    double totalDelayMs = 0.0;
+    double maxDelayMs = 0.0;
+};
+
+//----------------------------------------------------------------------------------------
+bool builtinProfile(const std::string& name, Profile& profile) 
+{
+    profile.name = name;
+    profile.phases.clear();
+    Conditions conditions;
+    
+    if (name == "none") {
+        profile.phases.push_back(conditions);
+    } else if (name == "lan") {
+        conditions.latency = 1.0;
+        conditions.jitter = 0.3;
+        profile.phases.push_back(conditions);
+    } else if (name == "transatlantic") {
+        // About 80 ms round trip on a good long-haul path
+        conditions.latency = 40.0;
+        conditions.jitter = 4.0;
+        conditions.loss = 0.002;
+        profile.phases.push_back(conditions);
+    } else if (name == "3g") {
+        // Slow, jittery mobile link with a deep buffer
+        conditions.latency = 90.0;
+        conditions.jitter = 30.0;
+        conditions.loss = 0.015;
+        conditions.reorder = 0.005;
+        conditions.reorderDelay = 40.0;
+        conditions.duplicate = 0.001;
+        conditions.bandwidth = 384.0;
+        conditions.queueLimit = 400.0;
+        profile.phases.push_back(conditions);
+    } else if (name == "wifi") {
+        // Bursty Wi-Fi: mostly clean, with spells of interference every few seconds
+        conditions.duration = 6.0;
+        conditions.latency = 3.0;
+        conditions.jitter = 2.0;
+        conditions.loss = 0.002;
+        profile.phases.push_back(conditions);
+        conditions.duration = 1.5;
+        conditions.latency = 15.0;
+        conditions.jitter = 25.0;
+        conditions.loss = 0.02;
+        conditions.burstStart = 0.05;
+        conditions.burstEnd = 0.2;
+        conditions.burstLoss = 0.6;
+        conditions.reorder = 0.02;
+        conditions.reorderDelay = 30.0;
+        profile.phases.push_back(conditions);
+    } else if (name == "lossy") {
+        conditions.latency = 20.0;
+        conditions.jitter = 5.0;
+        conditions.loss = 0.1;
+        profile.phases.push_back(conditions);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool parseConditions(const std::string& line, Conditions& conditions) 
+{
+    // key=value pairs separated by spaces; rates are given in percent
+    std::istringstream tokens(line);
+    std::string token;
+    while (tokens >> token) {
+        std::size_t equals = token.find('=');
+        if (equals == std::string::npos) {
+            return false;
+        }
+        std::string key = token.substr(0, equals);
+        double value = 0.0;
+        try {
+            value = std::stod(token.substr(equals + 1));
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (value < 0.0) {
+            return false;
+        }
+        
+        double rate = std::min(value / 100.0, 1.0);
+        if (key == "duration") {
+            conditions.duration = value;
+        } else if (key == "latency") {
+            conditions.latency = value;
+        } else if (key == "jitter") {
+            conditions.jitter = value;
+        } else if (key == "loss") {
+            conditions.loss = rate;
+        } else if (key == "burst_start") {
+            conditions.burstStart = rate;
+        } else if (key == "burst_end") {
+            conditions.burstEnd = rate;
+        } else if (key == "burst_loss") {
+            conditions.burstLoss = rate;
+        } else if (key == "reorder") {
+            conditions.reorder = rate;
+        } else if (key == "reorder_delay") {
+            conditions.reorderDelay = value;
+        } else if (key == "duplicate") {
+            conditions.duplicate = rate;
+        } else if (key == "bandwidth") {
+            conditions.bandwidth = value;
+        } else if (key == "queue") {
+            conditions.queueLimit = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+bool readProfile(const std::string& filename, Profile& profile) 
+{
+    // One phase per line, e.g. "duration=5 latency=40 jitter=10 loss=1 bandwidth=500"
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    profile.name = filename;
+    profile.phases.clear();
+    
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        Conditions conditions;
+        if (!parseConditions(line, conditions)) {
+            std::cerr << filename << ":" << lineNumber << ": invalid phase" << std::endl;
+            return false;
+        }
+        profile.phases.push_back(conditions);
+    }
+    return !profile.phases.empty();
+}
+
+//----------------------------------------------------------------------------------------
+const Conditions& currentPhase(const Profile& profile, double elapsed, std::size_t& index) 
+{
+    // Phases repeat; a phase without a duration is the last one and lasts for good
+    double cycle = 0.0;
+    for (const Conditions& phase : profile.phases) {
+        if (phase.duration <= 0.0) {
+            break;
+        }
+        cycle += phase.duration;
+    }
+    bool repeats = std::all_of(profile.phases.begin(), profile.phases.end(),
+                               [](const Conditions& phase) { return phase.duration > 0.0; });
+    double time = (repeats && cycle > 0.0) ? std::fmod(elapsed, cycle) : elapsed;
+    
+    for (index = 0; index + 1 < profile.phases.size(); ++index) {
+        const Conditions& phase = profile.phases[index];
+        if (phase.duration <= 0.0 || time < phase.duration) {
+            break;
+        }
+        time -= phase.duration;
+    }
+    return profile.phases[index];
+}
+
+//----------------------------------------------------------------------------------------
+int openSocket(int port) 
+{
+    int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket < 0) {
+        std::cerr << "Failed to create UDP socket: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<std::uint16_t>(port));
+    if (::bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "Failed to bind UDP port " << port << ": " << std::strerror(errno) << std::endl;
+        ::close(socket);
+        return -1;
+    }
+    return socket;
+}
+
+//----------------------------------------------------------------------------------------
+bool parsePort(const char* text, int& port) 
+{
+    try {
+        std::size_t used = 0;
+        port = std::stoi(text, &used);
+        return used == std::string(text).size() && port >= 1 && port <= 65535;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+double millisecondsBetween(Clock::time_point from, Clock::time_point to) 
+{
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+//----------------------------------------------------------------------------------------
+void handleSignal(int) 
+{
+    g_stop = 1;
+}
+
+//----------------------------------------------------------------------------------------
+void printLink(std::ostream& out, const char* name, const Link& link) 
+{
+    double lossPercent = link.received > 0
+        ? 100.0 * static_cast<double>(link.lost + link.queueDrops) / static_cast<double>(link.received) : 0.0;
+    double averageDelay = link.delivered > 0 ? link.totalDelayMs / static_cast<double>(link.delivered) : 0.0;
+    out << name << ": " << link.received << " in, " << link.delivered << " delivered, " << link.lost << " lost, "
+        << link.queueDrops << " queue drops (" << lossPercent << "%), " << link.duplicated << " duplicated, "
+        << link.reordered << " reordered, delay avg " << averageDelay << " ms max " << link.maxDelayMs << " ms";
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------------------
+int main(int argc, char* argv[]) 
+{
+    std::array<int, 2> ports{};
+    std::array<int, 2> playerPorts{};
+    Profile profile;
+    if (argc < 6 || argc > 8 || !parsePort(argv[2], ports[0]) || !parsePort(argv[3], playerPorts[0])
+        || !parsePort(argv[4], ports[1]) || !parsePort(argv[5], playerPorts[1])) {
+        std::cerr << "Usage: " << argv[0] << " <profile> <port_a> <player_a_port> <port_b> <player_b_port>"
+                  << " [log_file] [seed]\n"
+                  << "  profile: none, lan, transatlantic, 3g, wifi, lossy, or a profile file\n"
+                  << "  Player A uses client_port=port_a and host_port=player_a_port, player B likewise"
+                  << std::endl;
+        return 1;
+    }
+    if (!builtinProfile(argv[1], profile) && !readProfile(argv[1], profile)) {
+        std::cerr << "Unknown profile or unreadable profile file: " << argv[1] << std::endl;
+        return 1;
+    }
+    
+    // Packet log: one CSV line per packet and outcome
+    std::ofstream logFile;
+    std::ostream* log = nullptr;
+    if (argc > 6) {
+        if (std::string(argv[6]) == "-") {
+            log = &std::cout;
+        } else {
+            logFile.open(argv[6]);
+            if (!logFile.is_open()) {
+                std::cerr << "Failed to open log file " << argv[6] << std::endl;
+                return 1;
+            }
+            log = &logFile;
+        }
+        *log << "time_ms,direction,bytes,outcome,delay_ms,phase\n";
+    }
+    std::mt19937 random(argc > 7 ? static_cast<std::uint32_t>(std::strtoul(argv[7], nullptr, 10)) : std::random_device()());
+    
+    // Socket i faces player i: what arrives there goes out through the other socket
+    std::array<int, 2> sockets{};
+    for (int i = 0; i < 2; ++i) {
+        sockets[i] = openSocket(ports[i]);
+        if (sockets[i] < 0) {
+            return 1;
+        }
+    }
+    std::array<sockaddr_in, 2> playerAddresses{};
+    for (int i = 0; i < 2; ++i) {
+        playerAddresses[i].sin_family = AF_INET;
+        playerAddresses[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        playerAddresses[i].sin_port = htons(static_cast<std::uint16_t>(playerPorts[i]));
+    }
+    
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+    std::cout << "Emulating profile " << profile.name << " (" << profile.phases.size() << " phase"
+              << (profile.phases.size() == 1 ? "" : "s") << "): A on port " << ports[0] << " -> "
+              << playerPorts[1] << ", B on port " << ports[1] << " -> " << playerPorts[0] << std::endl;
+    
+    const char* directionNames[2] = {"a>b", "b>a"};
+    std::array<Link, 2> links;
+    std::priority_queue<Packet, std::vector<Packet>, std::greater<Packet>> inFlight;
+    std::uint64_t order = 0;
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    std::vector<std::uint8_t> buffer(MAX_DATAGRAM);
+    Clock::time_point start = Clock::now();
+    Clock::time_point nextReport = start + REPORT_INTERVAL;
+    std::cout << std::fixed << std::setprecision(1);
+    if (log) {
+        *log << std::fixed << std::setprecision(3);
+    }
+    
+    auto logPacket = [&](Clock::time_point now, int direction, std::size_t bytes, const char* outcome,
+                         double delayMs, std::size_t phase) {
+        if (log) {
+            *log << millisecondsBetween(start, now) << ',' << directionNames[direction] << ',' << bytes << ','
+                 << outcome << ',' << delayMs << ',' << phase << '\n';
+        }
+    };
+    
+    while (!g_stop) {
+        // Sleep until a datagram arrives or the next packet is due
+        Clock::time_point now = Clock::now();
+        int timeoutMs = 100;
+        if (!inFlight.empty()) {
+            double untilDue = millisecondsBetween(now, inFlight.top().deliverAt);
+            timeoutMs = std::clamp(static_cast<int>(std::ceil(untilDue)), 0, timeoutMs);
+        }
+        pollfd descriptors[2] = {{sockets[0], POLLIN, 0}, {sockets[1], POLLIN, 0}};
+        ::poll(descriptors, 2, timeoutMs);
+        now = Clock::now();
+        
+        std::size_t phaseIndex = 0;
+        const Conditions& conditions = currentPhase(profile, millisecondsBetween(start, now) / 1000.0, phaseIndex);
+        
+        for (int direction = 0; direction < 2; ++direction) {
+            while (true) {
+                sockaddr_in from{};
+                socklen_t fromLength = sizeof(from);
+                ssize_t received = ::recvfrom(sockets[direction], buffer.data(), buffer.size(), MSG_DONTWAIT,
+                                              reinterpret_cast<sockaddr*>(&from), &fromLength);
+                if (received < 0) {
+                    break;  // Nothing more (or the player is not up yet)
+                }
+                Link& link = links[direction];
+                link.received++;
+                std::size_t bytes = static_cast<std::size_t>(received);
+                
+                // Loss, random or in bursts (two-state Gilbert-Elliott model)
+                if (link.inBurst ? chance(random) < conditions.burstEnd : chance(random) < conditions.burstStart) {
+                    link.inBurst = !link.inBurst;
+                }
+                if (chance(random) < (link.inBurst ? conditions.burstLoss : conditions.loss)) {
+                    link.lost++;
+                    logPacket(now, direction, bytes, "lost", 0.0, phaseIndex);
+                    continue;
+                }
+                
+                // Bandwidth cap: the packet waits for the ones ahead of it to be sent
+                Clock::time_point sentAt = now;
+                if (conditions.bandwidth > 0.0) {
+                    link.queueFreeAt = std::max(link.queueFreeAt, now);
+                    if (millisecondsBetween(now, link.queueFreeAt) > conditions.queueLimit) {
+                        link.queueDrops++;
+                        logPacket(now, direction, bytes, "queue_drop", 0.0, phaseIndex);
+                        continue;
+                    }
+                    double transmitSeconds = static_cast<double>(bytes * 8) / (conditions.bandwidth * 1000.0);
+                    link.queueFreeAt += std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(transmitSeconds));
+                    sentAt = link.queueFreeAt;
+                }
+                
+                // Latency and jitter; packets keep their order unless picked for reordering
+                std::normal_distribution<double> jitter(0.0, conditions.jitter);
+                double delayMs = std::max(0.0, conditions.latency + (conditions.jitter > 0.0 ? jitter(random) : 0.0));
+                Packet packet;
+                packet.direction = direction;
+                packet.receivedAt = now;
+                packet.deliverAt = sentAt + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double, std::milli>(delayMs));
+                packet.reordered = chance(random) < conditions.reorder;
+                if (packet.reordered) {
+                    packet.deliverAt += std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double, std::milli>(conditions.reorderDelay));
+                } else {
+                    packet.deliverAt = std::max(packet.deliverAt, link.lastDeliverAt);
+                    link.lastDeliverAt = packet.deliverAt;
+                }
+                packet.data.assign(buffer.begin(), buffer.begin() + received);
+                
+                if (chance(random) < conditions.duplicate) {
+                    Packet copy = packet;
+                    copy.duplicate = true;
+                    copy.order = order++;
+                    inFlight.push(std::move(copy));
+                }
+                packet.order = order++;
+                inFlight.push(std::move(packet));
+            }
+        }
+        
+        // Deliver everything that is due, through the socket facing the other player
+        while (!inFlight.empty() && inFlight.top().deliverAt <= now) {
+            const Packet& packet = inFlight.top();
+            int to = 1 - packet.direction;
+            ::sendto(sockets[to], packet.data.data(), packet.data.size(), 0,
+                     reinterpret_cast<const sockaddr*>(&playerAddresses[to]), sizeof(playerAddresses[to]));
+            
+            Link& link = links[packet.direction];
+            double delayMs = millisecondsBetween(packet.receivedAt, now);
+            link.delivered++;
+            link.totalDelayMs += delayMs;
+            link.maxDelayMs = std::max(link.maxDelayMs, delayMs);
+            const char* outcome = "delivered";
+            if (packet.duplicate) {
+                link.duplicated++;
+                outcome = "duplicate";
+            } else if (packet.reordered) {
+                link.reordered++;
+                outcome = "reordered";
+            }
+            logPacket(now, packet.direction, packet.data.size(), outcome, delayMs, phaseIndex);
+            inFlight.pop();
+        }
+        
+        if (now >= nextReport) {
+            nextReport += REPORT_INTERVAL;
+            std::cout << "[phase " << phaseIndex << "] ";
+            printLink(std::cout, directionNames[0], links[0]);
+            std::cout << " | ";
+            printLink(std::cout, directionNames[1], links[1]);
+            std::cout << std::endl;
+        }
+    }
+    
+    for (int socket : sockets) {
+        ::close(socket);
+    }
+    std::cout << "Stopped. ";
+    printLink(std::cout, directionNames[0], links[0]);
+    std::cout << " | ";
+    printLink(std::cout, directionNames[1], links[1]);
+    std::cout << std::endl;
+    return 0;
+}